@@ -42,6 +42,7 @@
 #include <QDebug>
 #include <KLocale>
 #include <cmath>
+#include <limits>
 
 /**
  * \class AbstractColumn
@@ -109,6 +110,61 @@ AbstractColumn::~AbstractColumn() {
  * the values in the column additional to the data type.
  */
 
+/**
+ * \brief Return whether the values of columns with the mode \c mode are accessible via valueAt()
+ *
+ * Besides Numeric (double) this is true for the compact modes Integer (32 bit integer),
+ * BigInt (64 bit integer) and Float (single precision), that store the values in their
+ * native width and widen them to double on access.
+ */
+bool AbstractColumn::isNumeric(AbstractColumn::ColumnMode mode) {
+	switch (mode) {
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float:
+			return true;
+		case AbstractColumn::Text:
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day:
+			break;
+	}
+
+	return false;
+}
+
+/**
+ * \brief Return the maximal number of rows a column with the mode \c mode can hold
+ *
+ * Row indices are 64 bit wide in the import filters, the values of a column are stored in
+ * Qt containers however which are indexed with int and whose allocation size is limited to 2GB.
+ * Filters use this function to limit the number of imported rows instead of letting the
+ * row count overflow and notify about the truncated import via AbstractFileFilter::truncated().
+ */
+qint64 AbstractColumn::maxRowCount(AbstractColumn::ColumnMode mode) {
+	qint64 elementSize = sizeof(double);
+	switch (mode) {
+		case AbstractColumn::Numeric:
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day:
+		case AbstractColumn::BigInt:
+			elementSize = sizeof(qint64);
+			break;
+		case AbstractColumn::Integer:
+		case AbstractColumn::Float:
+			elementSize = sizeof(qint32);
+			break;
+		case AbstractColumn::Text:
+			elementSize = sizeof(void*);
+			break;
+	}
+
+	//leave some space for the header of the container
+	return (std::numeric_limits<int>::max() - 64) / elementSize;
+}
+
 /**
  * \brief Set the column mode
  *
@@ -209,11 +265,18 @@ void AbstractColumn::clear() {}
 
 /**
  * \brief Convenience method for mode-independent testing of validity
+ *
+ * Integer and BigInt columns have no empty value, all their rows are valid. NaN values written
+ * to them are stored as 0, rows to be ignored in the plots and the analysis have to be masked.
  */
 bool AbstractColumn::isValid(int row) const {
 	switch (columnMode()) {
 		case AbstractColumn::Numeric:
+		case AbstractColumn::Float:
 			return !std::isnan(valueAt(row));
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+			return (row >= 0 && row < rowCount());
 		case AbstractColumn::Text:
 			return !textAt(row).isNull();
 		case AbstractColumn::DateTime:
@@ -245,12 +308,19 @@ bool AbstractColumn::isMasked(Interval<int> i) const {
 }
 
 /**
- * \brief Return all intervals of masked rows
+ * \brief Return all intervals of masked rows, sorted by their start
  */
 QList< Interval<int> > AbstractColumn::maskedIntervals() const {
 	return m_abstract_column_private->m_masking.intervals();
 }
 
+/**
+ * \brief Return the runs of masked rows within \c range, restricted to \c range
+ */
+QList< Interval<int> > AbstractColumn::maskedIntervals(Interval<int> range) const {
+	return m_abstract_column_private->m_masking.intervals(range);
+}
+
 /**
  * \brief Clear all masking information
  */
@@ -277,6 +347,47 @@ void AbstractColumn::setMasked(int row, bool mask) {
 	setMasked(Interval<int>(row,row), mask);
 }
 
+/**
+ * \brief Set several intervals masked at once
+ *
+ * All intervals are handled by one undo command and the column notifies about
+ * the change only once.
+ *
+ * \param intervals the intervals, preferably sorted by their start
+ * \param mask true: mask, false: unmask
+ */
+void AbstractColumn::setMasked(const QList< Interval<int> >& intervals, bool mask) {
+	if (intervals.isEmpty())
+		return;
+
+	exec(new AbstractColumnSetMaskedCmd(m_abstract_column_private, intervals, mask),
+			"maskingAboutToChange", "maskingChanged", Q_ARG(const AbstractColumn*,this));
+}
+
+/**
+ * \brief Set all rows masked for which the bit in \c rows is set
+ *
+ * The runs of set bits are masked as intervals via setMasked(const QList< Interval<int> >&, bool).
+ */
+void AbstractColumn::setMasked(const QBitArray& rows, bool mask) {
+	QList< Interval<int> > intervals;
+	const int size = rows.size();
+	int row = 0;
+	while (row < size) {
+		if (!rows.testBit(row)) {
+			++row;
+			continue;
+		}
+
+		const int start = row;
+		while (row < size && rows.testBit(row))
+			++row;
+		intervals << Interval<int>(start, row - 1);
+	}
+
+	setMasked(intervals, mask);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //@}
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -436,7 +547,7 @@ void AbstractColumn::replaceDateTimes(int first, const QList<QDateTime>& new_val
 /**
  * \brief Return the double value in row 'row'
  *
- * Use this only when columnMode() is Numeric
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
  */
 double AbstractColumn::valueAt(int row) const {
 	Q_UNUSED(row);
@@ -446,7 +557,7 @@ double AbstractColumn::valueAt(int row) const {
 /**
  * \brief Set the content of row 'row'
  *
- * Use this only when columnMode() is Numeric
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
  */
 void AbstractColumn::setValueAt(int row, double new_value) {
 	Q_UNUSED(row) Q_UNUSED(new_value)
@@ -455,17 +566,56 @@ void AbstractColumn::setValueAt(int row, double new_value) {
 /**
  * \brief Replace a range of values
  *
- * Use this only when columnMode() is Numeric
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
  */
 void AbstractColumn::replaceValues(int first, const QVector<double>& new_values) {
 	Q_UNUSED(first) Q_UNUSED(new_values)
 }
 
+/**
+ * \brief Return a read-only view of the numeric data of the column
+ *
+ * The view provides the values of all rows as one contiguous array (NaN for invalid values)
+ * and the masking of the rows as a bitmap, so that loops over the whole column don't need
+ * to call valueAt(), isValid() and isMasked() for every row.
+ * This default implementation materializes the values via valueAt(), columns storing
+ * their numeric data in memory provide the data without copying.
+ */
+AbstractColumn::NumericView AbstractColumn::numericView() const {
+	NumericView view;
+	const int rows = rowCount();
+	QVector<double> values(rows);
+	double* ptr = values.data();
+	for (int row = 0; row < rows; ++row)
+		ptr[row] = valueAt(row);
+
+	view.setValues(values);
+	fillMaskedRows(view);
+	return view;
+}
+
+/**
+ * \brief Set the masking bitmap of \c view from the masked intervals of the column
+ */
+void AbstractColumn::fillMaskedRows(NumericView& view) const {
+	const int rows = view.size();
+	if (rows == 0)
+		return;
+
+	foreach (const Interval<int>& interval, maskedIntervals(Interval<int>(0, rows - 1))) {
+		if (view.m_masked.isEmpty())
+			view.m_masked.resize(rows);
+		view.m_masked.fill(true, interval.start(), interval.end() + 1);
+	}
+}
+
 double AbstractColumn::minimum() const{
-	double val;
+	const NumericView view = numericView();
+	const double* values = view.data();
+	const int rows = view.size();
 	double min = INFINITY;
-	for (int row = 0; row < rowCount(); row++) {
-		val = valueAt(row);
+	for (int row = 0; row < rows; ++row) {
+		const double val = values[row];
 		if (std::isnan(val))
 			continue;
 
@@ -476,10 +626,12 @@ double AbstractColumn::minimum() const{
 }
 
 double AbstractColumn::maximum() const{
-	double val;
+	const NumericView view = numericView();
+	const double* values = view.data();
+	const int rows = view.size();
 	double max = -INFINITY;
-	for (int row = 0; row < rowCount(); row++) {
-		val = valueAt(row);
+	for (int row = 0; row < rows; ++row) {
+		const double val = values[row];
 		if (std::isnan(val))
 			continue;
 
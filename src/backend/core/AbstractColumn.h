@@ -31,6 +31,10 @@
 #define ABSTRACTCOLUMN_H
 
 #include "backend/core/AbstractAspect.h"
+#include <QBitArray>
+#include <QFile>
+#include <QSharedPointer>
+#include <QVector>
 #include <cmath>
 
 class AbstractColumnPrivate;
@@ -64,8 +68,47 @@ class AbstractColumn : public AbstractAspect
 			Text = 1,
 			Month = 4,
 			Day = 5,
-			DateTime = 6
+			DateTime = 6,
 			// 2 and 3 are skipped to avoid problems with old obsolete values
+			Integer = 7,
+			BigInt = 8,
+			Float = 9
+		};
+
+		//! read-only view of the numeric data of a column, see numericView()
+		class NumericView {
+			public:
+				NumericView() : m_data(0), m_size(0) {}
+				const double* data() const { return m_data; }
+				QVector<double> values() const {
+					if (m_data == m_values.constData())
+						return m_values;
+					QVector<double> values(m_size);
+					qCopy(m_data, m_data + m_size, values.begin());
+					return values;
+				}
+				int size() const { return m_size; }
+				double at(int row) const { return m_data[row]; }
+				bool isValid(int row) const { return !std::isnan(m_data[row]); }
+				bool hasMaskedRows() const { return !m_masked.isEmpty(); }
+				bool isMasked(int row) const { return !m_masked.isEmpty() && m_masked.testBit(row); }
+				const QBitArray& maskedRows() const { return m_masked; }
+
+			private:
+				void setValues(const QVector<double>& values) {
+					m_values = values;
+					m_data = m_values.constData();
+					m_size = m_values.size();
+				}
+
+				QVector<double> m_values;
+				const double* m_data; //points to m_values or to the memory mapped data of the column
+				int m_size;
+				QSharedPointer<QFile> m_mappedFile; //keeps the mapped data alive
+				QBitArray m_masked; //empty if no row is masked
+
+			friend class AbstractColumn;
+			friend class Column;
 		};
 
 		explicit AbstractColumn(const QString& name);
@@ -73,6 +116,8 @@ class AbstractColumn : public AbstractAspect
 
 		virtual bool isReadOnly() const { return true; };
 		virtual ColumnMode columnMode() const = 0;
+		static bool isNumeric(ColumnMode mode);
+		static qint64 maxRowCount(ColumnMode mode);
 		virtual void setColumnMode(AbstractColumn::ColumnMode);
 		virtual PlotDesignation plotDesignation() const = 0;
 		virtual void setPlotDesignation(AbstractColumn::PlotDesignation);
@@ -90,9 +135,12 @@ class AbstractColumn : public AbstractAspect
 		bool isMasked(int row) const;
 		bool isMasked(Interval<int> i) const;
 		QList< Interval<int> > maskedIntervals() const;
+		QList< Interval<int> > maskedIntervals(Interval<int> range) const;
 		void clearMasks();
 		void setMasked(Interval<int> i, bool mask = true);
 		void setMasked(int row, bool mask = true);
+		void setMasked(const QList< Interval<int> >& intervals, bool mask = true);
+		void setMasked(const QBitArray& rows, bool mask = true);
 
 		virtual QString formula(int row) const;
 		virtual QList< Interval<int> > formulaIntervals() const;
@@ -100,8 +148,9 @@ class AbstractColumn : public AbstractAspect
 		virtual void setFormula(int row, QString formula);
 		virtual void clearFormulas();
 
-		double minimum() const;
-		double maximum() const;
+		virtual NumericView numericView() const;
+		virtual double minimum() const;
+		virtual double maximum() const;
 
 		virtual QString textAt(int row) const;
 		virtual void setTextAt(int row, const QString& new_value);
@@ -135,6 +184,7 @@ class AbstractColumn : public AbstractAspect
 	protected:
 		bool XmlReadMask(XmlStreamReader *reader);
 		void XmlWriteMask(QXmlStreamWriter *writer) const;
+		void fillMaskedRows(NumericView& view) const;
 
 		virtual void handleRowInsertion(int before, int count);
 		virtual void handleRowRemoval(int first, int count);
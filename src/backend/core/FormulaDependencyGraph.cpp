@@ -0,0 +1,406 @@
+/***************************************************************************
+    File                 : FormulaDependencyGraph.cpp
+    Project              : LabPlot
+    Description          : Dependency graph of the column formulas
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "FormulaDependencyGraph.h"
+#include "backend/core/Project.h"
+#include "backend/core/column/Column.h"
+#include "backend/gsl/parser.h"
+#include "backend/lib/macros.h"
+
+#include <QtConcurrentRun>
+
+#include <cmath>
+#include <limits>
+
+#include <gsl/gsl_errno.h>
+
+namespace {
+const int lastRow = std::numeric_limits<int>::max();
+
+//! evaluate \c formula for the rows \c first to \c last, runs in a thread of the global thread pool
+/**
+ * Rows for which not all variables have a value are set to NaN.
+ * An empty vector is returned if the formula cannot be compiled.
+ */
+QVector<double> evaluateFormula(const QString& formula, const QStringList& variableNames,
+		const QVector<AbstractColumn::NumericView>& variableValues, int first, int last) {
+	QVector<double> result(last - first + 1, NAN);
+
+	int rows = last + 1;
+	for (int n = 0; n < variableValues.size(); ++n) {
+		if (variableValues.at(n).size() < rows)
+			rows = variableValues.at(n).size();
+	}
+
+	parser_context* context = parser_context_new();
+	QVector<symrec*> varSymbols;
+	QVector<const double*> values;
+	for (int n = 0; n < variableNames.size(); ++n) {
+		varSymbols << parser_context_assign_variable(context, variableNames.at(n).toLocal8Bit().data(), 0);
+		values << variableValues.at(n).data() + first;
+	}
+
+	parser_program* prog = parser_context_compile(context, formula.toLocal8Bit().data());
+	if (prog) {
+		double* y = result.data();
+		const int count = rows - first;
+		if (count > 0) {
+			program_eval_batch(prog, varSymbols.constData(), values.constData(), varSymbols.size(), count, y);
+			for (int i = 0; i < count; ++i) {
+				if (!std::isfinite(y[i]))
+					y[i] = NAN;
+			}
+		}
+		program_free(prog);
+	} else
+		result.clear();
+
+	parser_context_free(context);
+	return result;
+}
+}
+
+/**
+ * \class FormulaDependencyGraph
+ * \brief Dependency graph of the column formulas in a project.
+ * \ingroup core
+ *
+ * The values of a column can be generated from a formula of other columns (see FunctionValuesDialog and
+ * Column::setFormula()). FormulaDependencyGraph keeps track of the columns used in the formulas and updates
+ * the dependent columns automatically when the data of one of the source columns changes.
+ *
+ * The modified rows of the source column (see Column::changedRows()) are marked dirty in all directly and
+ * indirectly dependent columns. Only these rows are recomputed, e.g. only the new rows if data was appended
+ * to the sources. The columns are recomputed in topological order, a column is recomputed only after all
+ * its source columns are up to date. The formulas are evaluated in the global thread pool, the results are
+ * written to the columns in the GUI thread. The recomputed values are not added to the undo history,
+ * undoing the change of the source column recomputes the dependent columns again.
+ *
+ * As for virtual columns, the number of rows of a recomputed column is given by its largest source column,
+ * the rows at the end are removed together with the rows of the sources.
+ *
+ * Virtual columns (see Column::setVirtualFormula()) are not recomputed, only their cached values are dropped
+ * and the change is propagated to the columns, plots and curves using them.
+ *
+ * Columns with cyclic dependencies and formulas referring to columns that don't exist anymore are not updated.
+ */
+
+FormulaDependencyGraph::FormulaDependencyGraph(Project* project) : QObject(), m_project(project),
+	m_updatingColumn(0), m_rebuildPending(false) {
+
+	connect(m_project, SIGNAL(aspectAdded(const AbstractAspect*)), this, SLOT(handleAspectAdded(const AbstractAspect*)));
+	connect(m_project, SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)),
+			this, SLOT(handleAspectAboutToBeRemoved(const AbstractAspect*)));
+}
+
+FormulaDependencyGraph::~FormulaDependencyGraph() {
+	//the results of the running recomputations are not needed anymore
+	foreach (RecomputationWatcher* watcher, m_recomputations.keys()) {
+		watcher->disconnect(this);
+		watcher->waitForFinished();
+		delete watcher;
+	}
+}
+
+void FormulaDependencyGraph::handleAspectAdded(const AbstractAspect* aspect) {
+	Q_UNUSED(aspect);
+	scheduleRebuild();
+}
+
+void FormulaDependencyGraph::handleAspectAboutToBeRemoved(const AbstractAspect* aspect) {
+	//remove the columns from the graph immediately so that no dangling pointers are kept until the rebuild
+	QList<Column*> columns = aspect->children<Column>(AbstractAspect::Recursive);
+	const Column* removedColumn = qobject_cast<const Column*>(aspect);
+	if (removedColumn)
+		columns << const_cast<Column*>(removedColumn);
+
+	foreach (Column* column, columns) {
+		m_sources.remove(column);
+		m_dependents.remove(column);
+		m_order.removeAll(column);
+		m_dirtyRows.remove(column);
+	}
+	for (QHash<const Column*, QList<Column*> >::iterator it = m_dependents.begin(); it != m_dependents.end(); ++it) {
+		foreach (Column* column, columns)
+			it.value().removeAll(column);
+	}
+
+	scheduleRebuild();
+}
+
+//! rebuild the graph once the control returns to the event loop, e.g. after all aspects of a project were loaded
+void FormulaDependencyGraph::scheduleRebuild() {
+	if (m_rebuildPending)
+		return;
+
+	m_rebuildPending = true;
+	QMetaObject::invokeMethod(this, "rebuild", Qt::QueuedConnection);
+}
+
+/**
+ * Determines the source columns of all formula columns in the project and sorts the formula columns topologically.
+ */
+void FormulaDependencyGraph::rebuild() {
+	m_rebuildPending = false;
+	m_sources.clear();
+	m_dependents.clear();
+	m_order.clear();
+
+	const QList<Column*> columns = m_project->children<Column>(AbstractAspect::Recursive);
+	QHash<QString, Column*> columnsByPath;
+	foreach (Column* column, columns) {
+		columnsByPath[column->path()] = column;
+		connect(column, SIGNAL(formulaChanged(const Column*)), this, SLOT(scheduleRebuild()), Qt::UniqueConnection);
+	}
+
+	//the virtual columns look up their source columns again, they might have been added or removed.
+	//This is done here in the thread of the project, the values of virtual columns are also read in other threads
+	foreach (Column* column, columns) {
+		if (column->isVirtual())
+			column->invalidateVirtualData(0, std::numeric_limits<int>::max());
+	}
+
+	//resolve the column pathes of the formula variables
+	foreach (Column* column, columns) {
+		if (column->formula().isEmpty())
+			continue;
+
+		const QStringList& pathes = column->formulaVariableColumnPathes();
+		if (pathes.size() != column->formulaVariableNames().size())
+			continue;
+
+		QList<Column*> sources;
+		foreach (const QString& path, pathes) {
+			Column* source = columnsByPath.value(path);
+			if (!source)
+				break;
+			sources << source;
+		}
+
+		if (sources.size() == pathes.size())
+			m_sources[column] = sources;
+		else
+			WARNING("FormulaDependencyGraph: the formula of the column " << column->path().toStdString() << " refers to a column that doesn't exist");
+	}
+
+	//sort the formula columns topologically, a column comes after all the formula columns it depends on
+	QHash<Column*, int> pendingSources;
+	QList<Column*> ready;
+	for (QHash<Column*, QList<Column*> >::const_iterator it = m_sources.constBegin(); it != m_sources.constEnd(); ++it) {
+		int count = 0;
+		foreach (Column* source, it.value().toSet()) {
+			m_dependents[source] << it.key();
+			if (m_sources.contains(source))
+				++count;
+		}
+
+		pendingSources[it.key()] = count;
+		if (count == 0)
+			ready << it.key();
+	}
+
+	while (!ready.isEmpty()) {
+		Column* column = ready.takeFirst();
+		m_order << column;
+		foreach (Column* dependent, m_dependents.value(column)) {
+			if (--pendingSources[dependent] == 0)
+				ready << dependent;
+		}
+	}
+
+	//the remaining columns are part of a cycle or depend on a column in a cycle
+	if (m_order.size() != m_sources.size()) {
+		foreach (Column* column, m_sources.keys()) {
+			if (pendingSources.value(column) > 0) {
+				WARNING("FormulaDependencyGraph: cyclic formula dependency, the column " << column->path().toStdString() << " is not updated automatically");
+				m_sources.remove(column);
+			}
+		}
+
+		m_dependents.clear();
+		foreach (Column* column, m_order) {
+			foreach (Column* source, m_sources.value(column).toSet())
+				m_dependents[source] << column;
+		}
+	}
+
+	for (QHash<const Column*, QList<Column*> >::const_iterator it = m_dependents.constBegin(); it != m_dependents.constEnd(); ++it)
+		connect(it.key(), SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(sourceDataChanged(const AbstractColumn*)), Qt::UniqueConnection);
+
+	foreach (Column* column, m_dirtyRows.keys()) {
+		if (!m_sources.contains(column))
+			m_dirtyRows.remove(column);
+	}
+
+	startRecomputations();
+}
+
+void FormulaDependencyGraph::sourceDataChanged(const AbstractColumn* column) {
+	//the dependent columns of a recomputed column were already marked dirty together with it
+	if (column == m_updatingColumn)
+		return;
+
+	const Column* source = static_cast<const Column*>(column);
+	if (!m_dependents.contains(source))
+		return;
+
+	Interval<int> rows = source->changedRows();
+	if (!rows.isValid()) {
+		//only rows at the end were removed, update all rows
+		rows = Interval<int>(0, lastRow);
+	}
+
+	markDirty(source, rows);
+	startRecomputations();
+}
+
+//! mark the rows \c rows dirty in all columns depending directly or indirectly on \c source
+void FormulaDependencyGraph::markDirty(const Column* source, const Interval<int>& rows) {
+	foreach (Column* dependent, m_dependents.value(source)) {
+		QHash<Column*, Interval<int> >::iterator it = m_dirtyRows.find(dependent);
+		if (it == m_dirtyRows.end())
+			m_dirtyRows.insert(dependent, rows);
+		else if (it.value().contains(rows))
+			continue; //the dependent columns were marked already
+		else {
+			it.value().setStart(qMin(it.value().start(), rows.start()));
+			it.value().setEnd(qMax(it.value().end(), rows.end()));
+		}
+
+		markDirty(dependent, rows);
+	}
+}
+
+//! returns \c true if all source columns of \c column are up to date
+bool FormulaDependencyGraph::isReady(Column* column) const {
+	if (m_running.contains(column))
+		return false;
+
+	foreach (Column* source, m_sources.value(column)) {
+		if (m_dirtyRows.contains(source) || m_running.contains(source))
+			return false;
+	}
+
+	return true;
+}
+
+//! start the recomputation of all dirty columns whose sources are up to date
+void FormulaDependencyGraph::startRecomputations() {
+	if (m_dirtyRows.isEmpty())
+		return;
+
+	foreach (Column* column, m_order) {
+		if (m_dirtyRows.contains(column) && isReady(column))
+			recompute(column, m_dirtyRows.take(column));
+	}
+}
+
+//! recompute the rows \c rows of \c column in the global thread pool
+void FormulaDependencyGraph::recompute(Column* column, const Interval<int>& rows) {
+	//the values of a virtual column are computed on access, only the cached values are dropped
+	if (column->isVirtual()) {
+		m_updatingColumn = column;
+		column->invalidateVirtualData(rows.start(), rows.end());
+		m_updatingColumn = 0;
+		return;
+	}
+
+	if (!AbstractColumn::isNumeric(column->columnMode()))
+		return;
+
+	//the column has as many rows as the largest source column
+	const QList<Column*>& sources = m_sources.value(column);
+	if (sources.isEmpty())
+		return;
+
+	QVector<AbstractColumn::NumericView> values;
+	int rowCount = 0;
+	foreach (Column* source, sources) {
+		values << source->numericView();
+		if (source->rowCount() > rowCount)
+			rowCount = source->rowCount();
+	}
+
+	const int last = qMin(rows.end(), rowCount - 1);
+	if (last < rows.start()) {
+		//only rows at the end of the sources were removed
+		shrink(column, rowCount);
+		return;
+	}
+
+	gsl_set_error_handler_off();
+
+	Recomputation recomputation;
+	recomputation.column = column;
+	recomputation.guard = column;
+	recomputation.first = rows.start();
+	recomputation.rows = rowCount;
+
+	RecomputationWatcher* watcher = new RecomputationWatcher(this);
+	connect(watcher, SIGNAL(finished()), this, SLOT(recomputationFinished()));
+	m_recomputations[watcher] = recomputation;
+	m_running << column;
+	watcher->setFuture(QtConcurrent::run(evaluateFormula, column->formula(), column->formulaVariableNames(),
+										 values, rows.start(), last));
+}
+
+void FormulaDependencyGraph::recomputationFinished() {
+	RecomputationWatcher* watcher = static_cast<RecomputationWatcher*>(sender());
+	const Recomputation recomputation = m_recomputations.take(watcher);
+	const QVector<double> values = watcher->result();
+	watcher->deleteLater();
+	m_running.remove(recomputation.column);
+
+	//skip the result if the column was deleted or removed from the graph in the meantime
+	if (recomputation.guard && m_sources.contains(recomputation.column) && !values.isEmpty()) {
+		Column* column = recomputation.column;
+		m_updatingColumn = column;
+		column->setUndoAware(false);
+		column->replaceValues(recomputation.first, values);
+		column->setUndoAware(true);
+		m_updatingColumn = 0;
+		shrink(column, recomputation.rows);
+	}
+
+	startRecomputations();
+}
+
+//! remove the rows of \c column after the first \c rows rows, called when rows were removed from its source columns
+void FormulaDependencyGraph::shrink(Column* column, int rows) {
+	const int count = column->rowCount() - rows;
+	if (count <= 0)
+		return;
+
+	//the dependent columns were marked dirty together with the column and are shrunk when they are recomputed
+	m_updatingColumn = column;
+	column->setUndoAware(false);
+	column->removeRows(rows, count);
+	column->setUndoAware(true);
+	m_updatingColumn = 0;
+}
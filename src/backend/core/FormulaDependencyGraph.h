@@ -0,0 +1,88 @@
+/***************************************************************************
+    File                 : FormulaDependencyGraph.h
+    Project              : LabPlot
+    Description          : Dependency graph of the column formulas
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef FORMULADEPENDENCYGRAPH_H
+#define FORMULADEPENDENCYGRAPH_H
+
+#include "backend/lib/Interval.h"
+
+#include <QObject>
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+#include <QVector>
+#include <QFutureWatcher>
+
+class AbstractAspect;
+class AbstractColumn;
+class Column;
+class Project;
+
+class FormulaDependencyGraph : public QObject {
+	Q_OBJECT
+
+	public:
+		explicit FormulaDependencyGraph(Project*);
+		~FormulaDependencyGraph();
+
+	private:
+		typedef QFutureWatcher< QVector<double> > RecomputationWatcher;
+		struct Recomputation {
+			Column* column;
+			QPointer<Column> guard; //becomes 0 if the column is deleted during the recomputation
+			int first;
+			int rows; //number of rows of the source columns
+		};
+
+		void markDirty(const Column*, const Interval<int>& rows);
+		bool isReady(Column*) const;
+		void startRecomputations();
+		void recompute(Column*, const Interval<int>& rows);
+		void shrink(Column*, int rows);
+
+		Project* m_project;
+		QHash<Column*, QList<Column*> > m_sources;
+		QHash<const Column*, QList<Column*> > m_dependents;
+		QList<Column*> m_order;
+		QHash<Column*, Interval<int> > m_dirtyRows;
+		QSet<const Column*> m_running;
+		QHash<RecomputationWatcher*, Recomputation> m_recomputations;
+		const Column* m_updatingColumn;
+		bool m_rebuildPending;
+
+	private slots:
+		void handleAspectAdded(const AbstractAspect*);
+		void handleAspectAboutToBeRemoved(const AbstractAspect*);
+		void scheduleRebuild();
+		void rebuild();
+		void sourceDataChanged(const AbstractColumn*);
+		void recomputationFinished();
+};
+
+#endif
@@ -27,6 +27,7 @@
  *                                                                         *
  ***************************************************************************/
 #include "backend/core/Project.h"
+#include "backend/core/FormulaDependencyGraph.h"
 #include "backend/lib/XmlStreamReader.h"
 #include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/worksheet/Worksheet.h"
@@ -42,13 +43,13 @@
 #include "backend/worksheet/plots/cartesian/Axis.h"
 #include "backend/datapicker/DatapickerCurve.h"
 
-#include <QUndoStack>
 #include <QMenu>
 #include <QDateTime>
 #include <QThreadPool>
 
 #include <KConfig>
 #include <KConfigGroup>
+#include <KGlobal>
 #include <KLocale>
 
 /**
@@ -85,10 +86,11 @@ class Project::Private {
 			author(QString(qgetenv("USER"))),
 			modificationTime(QDateTime::currentDateTime()),
 			changed(false),
-			loading(false)
+			loading(false),
+			formulaDependencyGraph(0)
 			{}
 
-		QUndoStack undo_stack;
+		UndoStack undo_stack;
 		MdiWindowVisibility mdiWindowVisibility;
 		AbstractScriptingEngine* scriptingEngine;
 		QString fileName;
@@ -97,6 +99,7 @@ class Project::Private {
 		QDateTime modificationTime;
 		bool changed;
 		bool loading;
+		FormulaDependencyGraph* formulaDependencyGraph;
 };
 
 Project::Project() : Folder(i18n("Project")), d(new Private()) {
@@ -106,6 +109,10 @@ Project::Project() : Folder(i18n("Project")), d(new Private()) {
 
 	d->author = group.readEntry("Author", QString());
 
+	//memory budget of the undo history in MB, 0 means no limit
+	const KConfigGroup generalGroup = KGlobal::config()->group(QLatin1String("Settings_General"));
+	d->undo_stack.setMemoryBudget(generalGroup.readEntry("UndoMemoryBudget", 1024)*Q_INT64_C(1024*1024));
+
 	//we don't have direct access to the members name and comment
 	//->temporaly disable the undo stack and call the setters
 	setUndoAware(false);
@@ -122,6 +129,9 @@ Project::Project() : Folder(i18n("Project")), d(new Private()) {
 // 	d->scriptingEngine = ScriptingEngineManager::instance()->engine(engine_name);
 
 	connect(this, SIGNAL(aspectDescriptionChanged(const AbstractAspect*)),this, SLOT(descriptionChanged(const AbstractAspect*)));
+
+	//recompute the formula columns automatically when their source columns are changed
+	d->formulaDependencyGraph = new FormulaDependencyGraph(this);
 }
 
 Project::~Project() {
@@ -131,11 +141,12 @@ Project::~Project() {
 	foreach(Worksheet* w, children<Worksheet>())
 		w->setIsClosing();
 
+	delete d->formulaDependencyGraph;
 	d->undo_stack.clear();
 	delete d;
 }
 
-QUndoStack* Project::undoStack() const {
+UndoStack* Project::undoStack() const {
 	return &d->undo_stack;
 }
 
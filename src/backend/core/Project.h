@@ -31,6 +31,7 @@
 #define PROJECT_H
 
 #include "backend/core/Folder.h"
+#include "backend/core/UndoStack.h"
 #include "backend/lib/macros.h"
 
 class QString;
@@ -53,7 +54,7 @@ class Project : public Folder {
 
 		virtual const Project* project() const { return this; }
 		virtual Project* project() { return this; }
-		virtual QUndoStack* undoStack() const;
+		virtual UndoStack* undoStack() const;
 		virtual QString path() const { return name(); }
 		virtual QMenu* createContextMenu();
 		virtual QMenu* createFolderContextMenu(const Folder*);
@@ -0,0 +1,165 @@
+/***************************************************************************
+    File                 : UndoStack.cpp
+    Project              : LabPlot
+    Description          : Undo stack with a memory budget
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "UndoStack.h"
+#include "backend/lib/SpillableUndoCommand.h"
+#include "backend/lib/SpillFile.h"
+#include "backend/lib/macros.h"
+
+namespace {
+//! append \c command and all its child commands implementing SpillableUndoCommand to \c list
+void collectSpillableCommands(const QUndoCommand* command, QList<SpillableUndoCommand*>& list) {
+	SpillableUndoCommand* spillable = dynamic_cast<SpillableUndoCommand*>(const_cast<QUndoCommand*>(command));
+	if (spillable)
+		list << spillable;
+
+	for (int i = 0; i < command->childCount(); ++i)
+		collectSpillableCommands(command->child(i), list);
+}
+}
+
+/**
+ * \class UndoStack
+ * \brief Undo stack with a memory budget.
+ * \ingroup core
+ *
+ * The undo commands of column and matrix operations keep copies of the modified data which can add up
+ * to large amounts of memory after a long session with big data sets. UndoStack keeps track of the memory
+ * used by the commands implementing SpillableUndoCommand. If the memory budget is exceeded, the data of the
+ * commands that are farthest away from the current state are written to a temporary file.
+ * The data is read back transparently when the commands are undone or redone, the space in the file is reused then (see SpillFile).
+ *
+ * The temporary file is removed when the stack is cleared.
+ */
+
+UndoStack::UndoStack(QObject* parent) : QUndoStack(parent), m_memoryBudget(0) {
+	connect(this, SIGNAL(indexChanged(int)), this, SLOT(checkMemoryBudget()));
+}
+
+/**
+ * Sets the number of bytes the data of the undo commands may use in memory, 0 disables the budget.
+ */
+void UndoStack::setMemoryBudget(qint64 bytes) {
+	m_memoryBudget = bytes;
+	checkMemoryBudget();
+}
+
+qint64 UndoStack::memoryBudget() const {
+	return m_memoryBudget;
+}
+
+/**
+ * Returns the number of bytes currently used by the data of the undo commands in memory.
+ */
+qint64 UndoStack::memorySize() const {
+	qint64 size = 0;
+	foreach (const SpillableUndoCommand* command, spillableCommands())
+		size += command->memorySize();
+	return size;
+}
+
+/**
+ * Returns the number of bytes of the data of the undo commands that were moved to the disk.
+ */
+qint64 UndoStack::spilledSize() const {
+	qint64 size = 0;
+	foreach (const SpillableUndoCommand* command, spillableCommands())
+		size += command->spilledSize();
+	return size;
+}
+
+/**
+ * Moves the data of the commands to the disk until the memory budget is met.
+ */
+void UndoStack::checkMemoryBudget() {
+	if (count() == 0) {
+		//all commands were deleted, the spill file is not needed anymore
+		m_spillFile.clear();
+		return;
+	}
+
+	if (m_memoryBudget <= 0)
+		return;
+
+	//the sizes are cached by the commands, the data itself is not accessed here
+	const QList<SpillableUndoCommand*> commands = spillableCommands();
+	qint64 size = 0;
+	foreach (const SpillableUndoCommand* command, commands)
+		size += command->memorySize();
+	if (size <= m_memoryBudget)
+		return;
+
+	if (m_spillFile.isNull()) {
+		SpillFile* file = new SpillFile();
+		if (!file->open()) {
+			WARNING("UndoStack: couldn't create the temporary file for the undo history: " << file->errorString().toStdString());
+			delete file;
+			return;
+		}
+		m_spillFile = QSharedPointer<SpillFile>(file);
+	}
+
+	foreach (SpillableUndoCommand* command, commands) {
+		if (size <= m_memoryBudget)
+			break;
+		if (command->isSpilled())
+			continue;
+
+		const qint64 payload = command->memorySize();
+		if (payload == 0)
+			continue;
+
+		if (!command->spill(m_spillFile)) {
+			WARNING("UndoStack: couldn't write the undo history to the disk: " << m_spillFile->errorString().toStdString());
+			break;
+		}
+		size -= payload;
+	}
+}
+
+/**
+ * Returns the commands implementing SpillableUndoCommand, including the child commands of macros.
+ * The commands farthest away from the current index, i.e. the ones needed last for undo and redo, come first.
+ */
+QList<SpillableUndoCommand*> UndoStack::spillableCommands() const {
+	QList<SpillableUndoCommand*> commands;
+	const int current = index();
+	int first = 0;
+	int last = count() - 1;
+	while (first <= last) {
+		//the commands before the current index are undone in reverse order, the commands after it are redone in order
+		const int firstDistance = (first < current) ? current - 1 - first : first - current;
+		const int lastDistance = (last < current) ? current - 1 - last : last - current;
+		if (firstDistance >= lastDistance)
+			collectSpillableCommands(command(first++), commands);
+		else
+			collectSpillableCommands(command(last--), commands);
+	}
+
+	return commands;
+}
@@ -0,0 +1,59 @@
+/***************************************************************************
+    File                 : UndoStack.h
+    Project              : LabPlot
+    Description          : Undo stack with a memory budget
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef UNDOSTACK_H
+#define UNDOSTACK_H
+
+#include <QUndoStack>
+#include <QSharedPointer>
+
+class SpillableUndoCommand;
+class SpillFile;
+
+class UndoStack : public QUndoStack {
+	Q_OBJECT
+
+	public:
+		explicit UndoStack(QObject* parent = 0);
+
+		void setMemoryBudget(qint64 bytes);
+		qint64 memoryBudget() const;
+		qint64 memorySize() const;
+		qint64 spilledSize() const;
+
+	private slots:
+		void checkMemoryBudget();
+
+	private:
+		QList<SpillableUndoCommand*> spillableCommands() const;
+
+		QSharedPointer<SpillFile> m_spillFile;
+		qint64 m_memoryBudget;
+};
+
+#endif
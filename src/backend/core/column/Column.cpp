@@ -33,7 +33,10 @@
 #include "backend/lib/XmlStreamReader.h"
 #include "backend/core/datatypes/String2DateTimeFilter.h"
 #include "backend/core/datatypes/DateTime2StringFilter.h"
+#include "backend/lib/macros.h"
 
+#include <QHash>
+#include <QSemaphore>
 #include <QThreadPool>
 #ifndef NDEBUG
 #include <QDebug>
@@ -42,9 +45,8 @@
 #include <KIcon>
 #include <KLocale>
 
-extern "C" {
-#include <gsl/gsl_sort.h>
-}
+#include <algorithm>
+#include <cmath>
 
 /**
  * \class Column
@@ -55,7 +57,8 @@ extern "C" {
  * interface as defined in AbstractColumn. A column
  * can have one of currently three data types: double, QString, or
  * QDateTime. The string representation of the values can differ depending
- * on the mode of the column.
+ * on the mode of the column. Numeric values can also be stored in their
+ * native width (modes Integer, BigInt and Float), they are widened to double on access.
  *
  * Column inherits from AbstractAspect and is intended to be a child
  * of the corresponding Spreadsheet in the aspect hierarchy. Columns don't
@@ -91,7 +94,7 @@ Column::Column(const QString& name, QVector<double> data)
  * \param data initial data vector
  */
 Column::Column(const QString& name, QStringList data)
-	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::Text, new QStringList(data))) {
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::Text, new ColumnTextData(data))) {
 	init();
 }
 
@@ -102,7 +105,11 @@ Column::Column(const QString& name, QStringList data)
  * \param data initial data vector
  */
 Column::Column(const QString& name, QList<QDateTime> data)
-	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::DateTime, new QList<QDateTime>(data)) ) {
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::DateTime, new QVector<qint64>()) ) {
+	QVector<qint64>* values = static_cast< QVector<qint64>* >(m_column_private->dataPointer());
+	values->reserve(data.size());
+	foreach(const QDateTime& dateTime, data)
+		values->append(ColumnPrivate::dateTimeToMSecs(dateTime));
 	init();
 }
 
@@ -118,6 +125,7 @@ void Column::init() {
 	addChild(m_column_private->inputFilter());
 	addChild(m_column_private->outputFilter());
 	m_suppressDataChangedSignal = false;
+	m_updateLevel = 0;
 }
 
 /**
@@ -135,6 +143,87 @@ void Column::setSuppressDataChangedSignal(bool b) {
 	m_suppressDataChangedSignal = b;
 }
 
+/**
+ * \brief Start an update transaction
+ *
+ * All changes of the data until the matching endUpdate() are collected and
+ * dataAboutToChange() and dataChanged() are emitted only once instead of once per
+ * modified cell. This should be used when many cells are modified one by one,
+ * e.g. when pasting or filling values, so that the views, plots and curves depending
+ * on this column are updated only once. Calls can be nested, the notifications are sent
+ * at the end of the outermost transaction.
+ */
+void Column::beginUpdate() {
+	if (m_updateLevel++ == 0)
+		m_changedRows = Interval<int>();
+}
+
+/**
+ * \brief Finish the update transaction started with beginUpdate()
+ *
+ * Emits rowsChanged() with the range of the modified rows followed by dataChanged()
+ * if the data was modified during the transaction.
+ */
+void Column::endUpdate() {
+	if (m_updateLevel == 0 || --m_updateLevel > 0)
+		return;
+
+	if (!m_changedRows.isValid())
+		return;
+
+	setStatisticsAvailable(false);
+	emitDataChanged();
+}
+
+/**
+ * \brief Return the rows modified by the last change of the data or in the current or the last update transaction
+ *
+ * An invalid interval is returned if no data was modified. When called in a slot connected to
+ * dataChanged(), the rows modified by the change being notified are returned.
+ */
+Interval<int> Column::changedRows() const {
+	return m_changedRows;
+}
+
+//! record the modified rows \c first to \c last during an update transaction
+void Column::addChangedRows(int first, int last) {
+	if (last < first)
+		return;
+
+	if (!m_changedRows.isValid()) {
+		//first modification in this transaction
+		emit dataAboutToChange(this);
+		m_changedRows = Interval<int>(first, last);
+	} else {
+		m_changedRows.setStart(qMin(m_changedRows.start(), first));
+		m_changedRows.setEnd(qMax(m_changedRows.end(), last));
+	}
+}
+
+//! emit dataChanged() or defer it until the end of the running update transaction
+void Column::notifyDataChanged(int first, int last) {
+	if (m_updateLevel > 0)
+		addChangedRows(first, last);
+	else {
+		m_changedRows = Interval<int>(first, last);
+		emitDataChanged();
+	}
+}
+
+//! emit rowsChanged() for the rows in m_changedRows followed by dataChanged()
+void Column::emitDataChanged() {
+	//rows beyond the end of the column were removed, no need to report them
+	if (m_changedRows.end() >= rowCount())
+		m_changedRows.setEnd(rowCount() - 1);
+
+	if (m_suppressDataChangedSignal)
+		return;
+
+	if (m_changedRows.isValid())
+		emit rowsChanged(this, m_changedRows.start(), m_changedRows.end());
+	emit dataChanged(this);
+}
+
 /**
  * \brief Set the column mode
  *
@@ -146,7 +235,7 @@ void Column::setColumnMode(AbstractColumn::ColumnMode mode) {
 	beginMacro(i18n("%1: change column type", name()));
 	AbstractSimpleFilter * old_input_filter = m_column_private->inputFilter();
 	AbstractSimpleFilter * old_output_filter = m_column_private->outputFilter();
-	exec(new ColumnSetModeCmd(m_column_private, mode));
+	execModification(new ColumnSetModeCmd(m_column_private, mode));
 	if (m_column_private->inputFilter() != old_input_filter) {
 		removeChild(old_input_filter);
 		addChild(m_column_private->inputFilter());
@@ -165,12 +254,15 @@ void Column::setColumnMode(AbstractColumn::ColumnMode mode) {
  *
  * This function will return false if the data type
  * of 'other' is not the same as the type of 'this'.
+ * Values of the numeric modes (Numeric, Integer, BigInt and Float)
+ * are converted to the mode of 'this'.
  * Use a filter to convert a column to another type.
  */
 bool Column::copy(const AbstractColumn * other) {
 	Q_CHECK_PTR(other);
-	if(other->columnMode() != columnMode()) return false;
-	exec(new ColumnFullCopyCmd(m_column_private, other));
+	if(other->columnMode() != columnMode() && !(isNumeric(other->columnMode()) && isNumeric(columnMode())))
+		return false;
+	execModification(new ColumnFullCopyCmd(m_column_private, other));
 	return true;
 }
 
@@ -186,8 +278,9 @@ bool Column::copy(const AbstractColumn * other) {
  */
 bool Column::copy(const AbstractColumn * source, int source_start, int dest_start, int num_rows) {
 	Q_CHECK_PTR(source);
-	if(source->columnMode() != columnMode()) return false;
-	exec(new ColumnPartialCopyCmd(m_column_private, source, source_start, dest_start, num_rows));
+	if(source->columnMode() != columnMode() && !(isNumeric(source->columnMode()) && isNumeric(columnMode())))
+		return false;
+	execModification(new ColumnPartialCopyCmd(m_column_private, source, source_start, dest_start, num_rows));
 	return true;
 }
 
@@ -196,9 +289,8 @@ bool Column::copy(const AbstractColumn * source, int source_start, int dest_star
  */
 void Column::handleRowInsertion(int before, int count) {
 	AbstractColumn::handleRowInsertion(before, count);
-	exec(new ColumnInsertRowsCmd(m_column_private, before, count));
-	if (!m_suppressDataChangedSignal)
-		emit dataChanged(this);
+	execModification(new ColumnInsertRowsCmd(m_column_private, before, count));
+	notifyDataChanged(before, rowCount() - 1);
 
 	setStatisticsAvailable(false);
 }
@@ -208,13 +300,46 @@ void Column::handleRowInsertion(int before, int count) {
  */
 void Column::handleRowRemoval(int first, int count) {
 	AbstractColumn::handleRowRemoval(first, count);
-	exec(new ColumnRemoveRowsCmd(m_column_private, first, count));
-	if (!m_suppressDataChangedSignal)
-		emit dataChanged(this);
+	execModification(new ColumnRemoveRowsCmd(m_column_private, first, count));
+	notifyDataChanged(first, rowCount() - 1);
 
 	setStatisticsAvailable(false);
 }
 
+/**
+ * \brief Execute the command \c cmd modifying the values of the column
+ *
+ * The values of mapped and virtual columns are copied into memory first within the same undo step.
+ */
+void Column::execModification(QUndoCommand* cmd) {
+	if (!isMapped() && !isVirtual()) {
+		exec(cmd);
+		return;
+	}
+
+	if (!canMaterialize()) {
+		delete cmd;
+		return;
+	}
+
+	beginMacro(cmd->text());
+	exec(new ColumnMaterializeCmd(m_column_private));
+	exec(cmd);
+	endMacro();
+}
+
+/**
+ * \brief Return whether the values of a mapped column fit into the memory to be modified
+ */
+bool Column::canMaterialize() const {
+	const ColumnMappedData* mapped = m_column_private->mappedData();
+	if (mapped && mapped->size() > AbstractColumn::maxRowCount(AbstractColumn::Numeric)) {
+		WARNING("Column: the values of the mapped column " << path().toStdString() << " don't fit into the memory and can't be modified");
+		return false;
+	}
+	return true;
+}
+
 /**
  * \brief Set the column plot designation
  */
@@ -241,7 +366,7 @@ void Column::setWidth(int value) {
  * \brief Clear the whole column
  */
 void Column::clear() {
-	exec(new ColumnClearCmd(m_column_private));
+	execModification(new ColumnClearCmd(m_column_private));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -311,7 +436,7 @@ void Column::clearFormulas() {
  */
 void Column::setTextAt(int row, const QString& new_value) {
 	setStatisticsAvailable(false);
-	exec(new ColumnSetTextCmd(m_column_private, row, new_value));
+	execModification(new ColumnSetTextCmd(m_column_private, row, new_value));
 }
 
 /**
@@ -322,10 +447,90 @@ void Column::setTextAt(int row, const QString& new_value) {
 void Column::replaceTexts(int first, const QStringList& new_values) {
 	if (!new_values.isEmpty()) { //TODO: do we really need this check?
 		setStatisticsAvailable(false);
-		exec(new ColumnReplaceTextsCmd(m_column_private, first, new_values));
+		execModification(new ColumnReplaceTextsCmd(m_column_private, first, new_values));
 	}
 }
 
+/**
+ * \brief Return the storage of the strings, 0 if columnMode() is not Text
+ *
+ * If the strings are dictionary encoded (see ColumnTextData::isEncoded()),
+ * equal strings have equal codes and comparisons can be done on the codes directly.
+ */
+const ColumnTextData* Column::textData() const {
+	return m_column_private->textData();
+}
+
+/**
+ * \brief Use the dictionary encoding for the strings if the column contains only few distinct values
+ *
+ * This changes only the representation in memory and is not undoable.
+ * Called after importing or loading text data.
+ */
+bool Column::encodeText() {
+	return m_column_private->encodeText();
+}
+
+/**
+ * \brief Use \c rows double values of the file \c fileName as the content of the Numeric column
+ *
+ * The file is mapped into memory instead of being read, see ColumnPrivate::mapData().
+ * This is not undoable.
+ */
+bool Column::mapData(const QString& fileName, qint64 offset, qint64 rows) {
+	setStatisticsAvailable(false);
+	return m_column_private->mapData(fileName, offset, rows);
+}
+
+/**
+ * \brief Return whether the values are read from a mapped file instead of being kept in memory
+ */
+bool Column::isMapped() const {
+	return (m_column_private->mappedData() != 0);
+}
+
+/**
+ * \brief Compute the values of the Numeric column from the formula when they are accessed instead of keeping them in memory
+ *
+ * The formula is set as for setFormula(), the values are computed block-wise on access, see ColumnVirtualData.
+ * The values are computed and kept in memory as soon as the column is modified.
+ * Returns false if the formula refers to the column itself, directly or via other virtual columns.
+ */
+bool Column::setVirtualFormula(const QString& formula, const QStringList& variableNames, const QStringList& variableColumnPathes) {
+	if (columnMode() != AbstractColumn::Numeric || formula.isEmpty())
+		return false;
+
+	//the values kept in memory before are restored on undo
+	if (!canMaterialize())
+		return false;
+
+	if (ColumnVirtualData::isCyclic(this, variableColumnPathes)) {
+		WARNING("Column: the formula of the virtual column " << path().toStdString() << " refers to the column itself");
+		return false;
+	}
+
+	setStatisticsAvailable(false);
+	exec(new ColumnSetVirtualFormulaCmd(m_column_private, formula, variableNames, variableColumnPathes));
+	return true;
+}
+
+/**
+ * \brief Return whether the values are computed from the formula on access instead of being kept in memory
+ */
+bool Column::isVirtual() const {
+	return (m_column_private->virtualData() != 0);
+}
+
+/**
+ * \brief Notify about the changed values of the rows \c first to \c last of a virtual column
+ *
+ * Called by FormulaDependencyGraph when the source columns of the formula were modified.
+ */
+void Column::invalidateVirtualData(int first, int last) {
+	setStatisticsAvailable(false);
+	m_column_private->invalidateVirtualData(first, last);
+}
+
 /**
  * \brief Set the content of row 'row'
  *
@@ -353,7 +558,7 @@ void Column::setTimeAt(int row,const QTime& new_value) {
  */
 void Column::setDateTimeAt(int row, const QDateTime& new_value) {
 	setStatisticsAvailable(false);
-	exec(new ColumnSetDateTimeCmd(m_column_private, row, new_value));
+	execModification(new ColumnSetDateTimeCmd(m_column_private, row, new_value));
 }
 
 /**
@@ -364,29 +569,29 @@ void Column::setDateTimeAt(int row, const QDateTime& new_value) {
 void Column::replaceDateTimes(int first, const QList<QDateTime>& new_values) {
 	if (!new_values.isEmpty()) {
 		setStatisticsAvailable(false);
-		exec(new ColumnReplaceDateTimesCmd(m_column_private, first, new_values));
+		execModification(new ColumnReplaceDateTimesCmd(m_column_private, first, new_values));
 	}
 }
 
 /**
  * \brief Set the content of row 'row'
  *
- * Use this only when columnMode() is Numeric
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
  */
 void Column::setValueAt(int row, double new_value) {
 	setStatisticsAvailable(false);
-	exec(new ColumnSetValueCmd(m_column_private, row, new_value));
+	execModification(new ColumnSetValueCmd(m_column_private, row, new_value));
 }
 
 /**
  * \brief Replace a range of values
  *
- * Use this only when columnMode() is Numeric
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
  */
 void Column::replaceValues(int first, const QVector<double>& new_values) {
 	if (!new_values.isEmpty()) {
 		setStatisticsAvailable(false);
-		exec(new ColumnReplaceValuesCmd(m_column_private, first, new_values));
+		execModification(new ColumnReplaceValuesCmd(m_column_private, first, new_values));
 	}
 }
 
@@ -406,113 +611,514 @@ const Column::ColumnStatistics& Column::statistics() {
 	return m_column_private->statistics;
 }
 
-void Column::calculateStatistics() {
-	m_column_private->statistics = ColumnStatistics();
-	ColumnStatistics& statistics = m_column_private->statistics;
+/*
+ * Helpers for Column::calculateStatistics(). The data is processed in chunks in the global thread pool,
+ * the partial results of the chunks are merged afterwards.
+ */
+namespace {
+
+//! compensated (Kahan) summation
+struct KahanSum {
+	KahanSum() : sum(0.0), c(0.0) {}
+	void add(double value) {
+		const double y = value - c;
+		const double t = sum + y;
+		c = (t - sum) - y;
+		sum = t;
+	}
+	void add(const KahanSum& other) {
+		add(other.sum);
+		add(-other.c);
+	}
+	double sum;
+	double c;
+};
 
-	QVector<double>* rowValues = reinterpret_cast<QVector<double>*>(data());
-
-	int notNanCount = 0;
-	double val;
-	double columnSum = 0.0;
-	double columnProduct = 1.0;
-	double columnSumNeg = 0.0;
-	double columnSumSquare = 0.0;
-	statistics.minimum = INFINITY;
-	statistics.maximum = -INFINITY;
-	QMap<double, int> frequencyOfValues;
-	QVector<double> rowData;
-	rowData.reserve(rowValues->size());
-	for (int row = 0; row < rowValues->size(); ++row) {
-		val = rowValues->value(row);
-		if (std::isnan(val) || isMasked(row))
-			continue;
-
-		if (val < statistics.minimum)
-			statistics.minimum = val;
-		if (val > statistics.maximum)
-			statistics.maximum = val;
-		columnSum+= val;
-		columnSumNeg += (1.0 / val);
-		columnSumSquare += pow(val, 2.0);
-		columnProduct *= val;
-		if (frequencyOfValues.contains(val))
-			frequencyOfValues.operator [](val)++;
-		else
-			frequencyOfValues.insert(val, 1);
-		++notNanCount;
-		rowData.push_back(val);
+//! partial statistics of a chunk of values, the central moments are updated as in Welford's algorithm
+struct StatisticsChunk {
+	StatisticsChunk() : count(0), zeroCount(0), negativeCount(0), minimum(INFINITY), maximum(-INFINITY),
+		mean(0.0), M2(0.0), M3(0.0), M4(0.0) {}
+
+	void add(double value) {
+		const double n1 = count;
+		++count;
+		const double n = count;
+		const double delta = value - mean;
+		const double delta_n = delta / n;
+		const double delta_n2 = delta_n * delta_n;
+		const double term1 = delta * delta_n * n1;
+		mean += delta_n;
+		M4 += term1 * delta_n2 * (n*n - 3*n + 3) + 6 * delta_n2 * M2 - 4 * delta_n * M3;
+		M3 += term1 * delta_n * (n - 2) - 3 * delta_n * M2;
+		M2 += term1;
+
+		if (value < minimum)
+			minimum = value;
+		if (value > maximum)
+			maximum = value;
+		sum.add(value);
+		sumInverse.add(1.0/value);
+		sumSquare.add(value*value);
+		if (value == 0)
+			++zeroCount;
+		else {
+			if (value < 0)
+				++negativeCount;
+			sumLog.add(log(fabs(value)));
+		}
 	}
 
-	if (notNanCount == 0) {
-		setStatisticsAvailable(true);
-		return;
+	void merge(const StatisticsChunk& other) {
+		if (other.count == 0)
+			return;
+		if (count == 0) {
+			*this = other;
+			return;
+		}
+
+		const double na = count;
+		const double nb = other.count;
+		const double n = na + nb;
+		const double delta = other.mean - mean;
+		const double delta2 = delta * delta;
+		const double delta3 = delta2 * delta;
+		const double delta4 = delta2 * delta2;
+
+		M4 += other.M4 + delta4 * na * nb * (na*na - na*nb + nb*nb) / (n*n*n)
+			+ 6 * delta2 * (na*na * other.M2 + nb*nb * M2) / (n*n)
+			+ 4 * delta * (na * other.M3 - nb * M3) / n;
+		M3 += other.M3 + delta3 * na * nb * (na - nb) / (n*n) + 3 * delta * (na * other.M2 - nb * M2) / n;
+		M2 += other.M2 + delta2 * na * nb / n;
+		mean += delta * nb / n;
+
+		count += other.count;
+		zeroCount += other.zeroCount;
+		negativeCount += other.negativeCount;
+		if (other.minimum < minimum)
+			minimum = other.minimum;
+		if (other.maximum > maximum)
+			maximum = other.maximum;
+		sum.add(other.sum);
+		sumInverse.add(other.sumInverse);
+		sumSquare.add(other.sumSquare);
+		sumLog.add(other.sumLog);
+	}
+
+	int count;
+	int zeroCount;
+	int negativeCount;
+	double minimum;
+	double maximum;
+	double mean;
+	double M2;
+	double M3;
+	double M4;
+	KahanSum sum;
+	KahanSum sumInverse;
+	KahanSum sumSquare;
+	KahanSum sumLog;	// sum of log(|x|) for the non-zero values, used for the geometric mean
+};
+
+class StatisticsTask : public QRunnable {
+public:
+	StatisticsTask() : m_done(0) {
+		setAutoDelete(false);
+	}
+	void setSemaphore(QSemaphore* done) {
+		m_done = done;
+	}
+	void run() {
+		calculate();
+		if (m_done)
+			m_done->release();
+	}
+
+protected:
+	virtual void calculate() = 0;
+
+private:
+	QSemaphore* m_done;
+};
+
+//! whether \c row lies in one of the sorted intervals \c masked, \c interval is advanced over the intervals before \c row
+inline bool isMaskedRow(const QList< Interval<int> >& masked, int& interval, int row) {
+	while (interval < masked.size() && masked.at(interval).end() < row)
+		++interval;
+	return (interval < masked.size() && masked.at(interval).start() <= row);
+}
+
+//! first pass: moments of the valid (not NaN and not masked) values, the values are copied to \c values+start if \c values is not 0
+class StatisticsMomentsTask : public StatisticsTask {
+public:
+	StatisticsMomentsTask(const double* data, int start, int end, const QList< Interval<int> >& masked, double* values, StatisticsChunk* result)
+		: m_data(data), m_start(start), m_end(end), m_masked(masked), m_values(values), m_result(result) {}
+
+protected:
+	void calculate() {
+		StatisticsChunk chunk;
+		double* values = m_values ? m_values + m_start : 0;
+		int interval = 0;
+		for (int row = m_start; row < m_end; ++row) {
+			const double val = m_data[row];
+			if (std::isnan(val) || isMaskedRow(m_masked, interval, row))
+				continue;
+
+			chunk.add(val);
+			if (values)
+				values[chunk.count - 1] = val;
+		}
+		*m_result = chunk;
 	}
 
-	if (rowData.size() < rowValues->size())
-		rowData.squeeze();
+private:
+	const double* m_data;
+	const int m_start;
+	const int m_end;
+	const QList< Interval<int> >& m_masked;
+	double* m_values;
+	StatisticsChunk* m_result;
+};
+
+//! frequencies of the \c count valid values falling into the hash partition \c partition, returns the partial sum of p*log2(p)
+class StatisticsEntropyTask : public StatisticsTask {
+public:
+	StatisticsEntropyTask(const double* data, int size, const QList< Interval<int> >& masked, int count, int partition, int partitions, double* result)
+		: m_data(data), m_size(size), m_masked(masked), m_count(count), m_partition(partition), m_partitions(partitions), m_result(result) {}
+
+protected:
+	void calculate() {
+		QHash<quint64, int> frequencies;
+		int interval = 0;
+		for (int row = 0; row < m_size; ++row) {
+			if (std::isnan(m_data[row]) || isMaskedRow(m_masked, interval, row))
+				continue;
+
+			//use the bit pattern as key, -0.0 and 0.0 are counted as the same value
+			const double val = (m_data[row] == 0) ? 0.0 : m_data[row];
+			quint64 key;
+			memcpy(&key, &val, sizeof(key));
+			if (m_partitions > 1 && qHash(key) % m_partitions != (uint)m_partition)
+				continue;
+			++frequencies[key];
+		}
+
+		double entropy = 0.0;
+		QHash<quint64, int>::const_iterator it = frequencies.constBegin();
+		for (; it != frequencies.constEnd(); ++it) {
+			const double frequencyNorm = static_cast<double>(it.value()) / m_count;
+			entropy += frequencyNorm * log2(frequencyNorm);
+		}
+		*m_result = entropy;
+	}
 
-	statistics.arithmeticMean = columnSum / notNanCount;
-	statistics.geometricMean = pow(columnProduct, 1.0 / notNanCount);
-	statistics.harmonicMean = notNanCount / columnSumNeg;
-	statistics.contraharmonicMean = columnSumSquare / columnSum;
+private:
+	const double* m_data;
+	const int m_size;
+	const QList< Interval<int> >& m_masked;
+	const int m_count;
+	const int m_partition;
+	const int m_partitions;
+	double* m_result;
+};
+
+//! second pass: absolute deviations around mean and median of the valid values, |x - median| is written to \c deviations if it is not 0
+class StatisticsDeviationTask : public StatisticsTask {
+public:
+	StatisticsDeviationTask(const double* data, int start, int end, const QList< Interval<int> >& masked, double mean, double median,
+				double* deviations, KahanSum* meanDeviation, KahanSum* medianDeviation)
+		: m_data(data), m_start(start), m_end(end), m_masked(masked), m_mean(mean), m_median(median),
+		m_deviations(deviations), m_meanDeviation(meanDeviation), m_medianDeviation(medianDeviation) {}
+
+protected:
+	void calculate() {
+		KahanSum meanDeviation, medianDeviation;
+		int interval = 0;
+		for (int row = m_start; row < m_end; ++row) {
+			const double val = m_data[row];
+			if (std::isnan(val) || isMaskedRow(m_masked, interval, row))
+				continue;
+
+			meanDeviation.add(fabs(val - m_mean));
+			const double deviation = fabs(val - m_median);
+			medianDeviation.add(deviation);
+			if (m_deviations)
+				m_deviations[row] = deviation;
+		}
+		*m_meanDeviation = meanDeviation;
+		*m_medianDeviation = medianDeviation;
+	}
+
+private:
+	const double* m_data;
+	const int m_start;
+	const int m_end;
+	const QList< Interval<int> >& m_masked;
+	const double m_mean;
+	const double m_median;
+	double* m_deviations;
+	KahanSum* m_meanDeviation;
+	KahanSum* m_medianDeviation;
+};
 
-	double columnSumVariance = 0;
-	double columnSumMeanDeviation = 0.0;
-	double columnSumMedianDeviation = 0.0;
-	double sumForCentralMoment_r3 = 0.0;
-	double sumForCentralMoment_r4 = 0.0;
+//! unsigned integer with the same order as \c value, used for the radix selection in selectMappedValue()
+inline quint64 orderedKey(double value) {
+	const quint64 signBit = Q_UINT64_C(0x8000000000000000);
+	if (value == 0)
+		value = 0.0;
+	quint64 key;
+	memcpy(&key, &value, sizeof(key));
+	return (key & signBit) ? ~key : (key | signBit);
+}
 
-	gsl_sort(rowData.data(), 1, notNanCount);
-	statistics.median = (notNanCount%2) ? rowData.at((notNanCount-1)/2) :
-	                    (rowData.at((notNanCount-1)/2) + rowData.at(notNanCount/2))/2.0;
-	QVector<double> absoluteMedianList;
-	absoluteMedianList.reserve(notNanCount);
-	absoluteMedianList.resize(notNanCount);
+//! inverse of orderedKey()
+inline double orderedValue(quint64 key) {
+	const quint64 signBit = Q_UINT64_C(0x8000000000000000);
+	key = (key & signBit) ? (key & ~signBit) : ~key;
+	double value;
+	memcpy(&value, &key, sizeof(value));
+	return value;
+}
 
-	int idx = 0;
-	for(int row = 0; row < rowValues->size(); ++row) {
-		val = rowValues->value(row);
-		if ( std::isnan(val) || isMasked(row) )
-			continue;
-		columnSumVariance+= pow(val - statistics.arithmeticMean, 2.0);
+//! histogram of the byte \c shift/8 of the keys of the valid values (or of |x - center|) whose higher bytes are equal to \c prefix
+class StatisticsHistogramTask : public StatisticsTask {
+public:
+	StatisticsHistogramTask(const double* data, int start, int end, const QList< Interval<int> >& masked, double center, bool deviation,
+				quint64 prefix, int shift, QVector<qint64>* histogram)
+		: m_data(data), m_start(start), m_end(end), m_masked(masked), m_center(center), m_deviation(deviation),
+		m_prefix(prefix), m_shift(shift), m_histogram(histogram) {}
+
+protected:
+	void calculate() {
+		QVector<qint64> histogram(256, 0);
+		const quint64 mask = (m_shift == 56) ? 0 : (~Q_UINT64_C(0) << (m_shift + 8));
+		int interval = 0;
+		for (int row = m_start; row < m_end; ++row) {
+			const double val = m_data[row];
+			if (std::isnan(val) || isMaskedRow(m_masked, interval, row))
+				continue;
+
+			const quint64 key = orderedKey(m_deviation ? fabs(val - m_center) : val);
+			if ((key & mask) == m_prefix)
+				++histogram[(key >> m_shift) & 0xff];
+		}
+		*m_histogram = histogram;
+	}
 
-		sumForCentralMoment_r3 += pow(val - statistics.arithmeticMean, 3.0);
-		sumForCentralMoment_r4 += pow(val - statistics.arithmeticMean, 4.0);
-		columnSumMeanDeviation += fabs( val - statistics.arithmeticMean );
+private:
+	const double* m_data;
+	const int m_start;
+	const int m_end;
+	const QList< Interval<int> >& m_masked;
+	const double m_center;
+	const bool m_deviation;
+	const quint64 m_prefix;
+	const int m_shift;
+	QVector<qint64>* m_histogram;
+};
 
-		absoluteMedianList[idx] = fabs(val - statistics.median);
-		columnSumMedianDeviation += absoluteMedianList[idx];
-		idx++;
+//! runs the tasks in the global thread pool (the first one in the calling thread), waits for and deletes all of them
+void runStatisticsTasks(QVector<StatisticsTask*>& tasks) {
+	QSemaphore done;
+	for (int i = 1; i < tasks.size(); ++i) {
+		tasks[i]->setSemaphore(&done);
+		QThreadPool::globalInstance()->start(tasks[i]);
 	}
+	if (!tasks.isEmpty())
+		tasks[0]->run();
+	if (tasks.size() > 1)
+		done.acquire(tasks.size() - 1);
+	qDeleteAll(tasks);
+	tasks.clear();
+}
 
-	statistics.meanDeviationAroundMedian = columnSumMedianDeviation / notNanCount;
-	statistics.medianDeviation = (notNanCount%2) ? absoluteMedianList.at((notNanCount-1)/2) :
-	                             (absoluteMedianList.at((notNanCount-1)/2) + absoluteMedianList.at(notNanCount/2))/2.0;
+//! median of the first \c n values using quickselect, the values are reordered
+double selectMedian(double* values, int n) {
+	double* middle = values + n/2;
+	std::nth_element(values, middle, values + n);
+	if (n%2)
+		return *middle;
 
-	const double centralMoment_r3 = sumForCentralMoment_r3 / notNanCount;
-	const double centralMoment_r4 = sumForCentralMoment_r4 / notNanCount;
+	//for an even number of values the lower middle is the largest value of the lower half
+	return (*std::max_element(values, middle) + *middle)/2.0;
+}
+
+//! minimal number of values processed by one statistics task
+const int statisticsChunkSize = 100000;
 
-	statistics.variance = columnSumVariance / notNanCount;
+/**
+ * value with the rank \c rank among the valid values (or among |x - center| if \c deviation is true)
+ * of the \c size values \c data of a mapped column. The values are not copied, the key of the value
+ * is determined byte-wise in eight passes over the data.
+ */
+double selectMappedValue(const double* data, int size, const QList< Interval<int> >& masked, qint64 rank, double center, bool deviation) {
+	const int chunks = qBound(1, size/statisticsChunkSize, qMax(1, QThreadPool::globalInstance()->maxThreadCount()));
+	quint64 prefix = 0;
+	for (int shift = 56; shift >= 0; shift -= 8) {
+		QVector< QVector<qint64> > histograms(chunks);
+		QVector<StatisticsTask*> tasks;
+		for (int i = 0; i < chunks; ++i) {
+			const int start = (qint64)size*i/chunks;
+			const int end = (qint64)size*(i+1)/chunks;
+			tasks << new StatisticsHistogramTask(data, start, end, masked, center, deviation, prefix, shift, &histograms[i]);
+		}
+		runStatisticsTasks(tasks);
+
+		for (int byte = 0; byte < 256; ++byte) {
+			qint64 count = 0;
+			for (int i = 0; i < chunks; ++i)
+				count += histograms.at(i).at(byte);
+			if (rank < count) {
+				prefix |= (quint64)byte << shift;
+				break;
+			}
+			rank -= count;
+		}
+	}
+
+	return orderedValue(prefix);
+}
+
+//! median of the \c count valid values of a mapped column, see selectMappedValue()
+double selectMappedMedian(const double* data, int size, const QList< Interval<int> >& masked, int count, double center, bool deviation) {
+	const double middle = selectMappedValue(data, size, masked, count/2, center, deviation);
+	if (count%2)
+		return middle;
+
+	return (selectMappedValue(data, size, masked, count/2 - 1, center, deviation) + middle)/2.0;
+}
+
+}
+
+void Column::calculateStatistics() {
+	m_column_private->statistics = ColumnStatistics();
+	ColumnStatistics& statistics = m_column_private->statistics;
+
+	if (!isNumeric(columnMode())) {
+		setStatisticsAvailable(true);
+		return;
+	}
+
+	//shared with the column for Numeric, widened to double for the compact numeric modes
+	const NumericView view = numericView();
+	const double* rowValues = view.data();
+	const int size = view.size();
+	const int chunks = qBound(1, size/statisticsChunkSize, qMax(1, QThreadPool::globalInstance()->maxThreadCount()));
+
+	//sorted list of the masked intervals, the tasks skip the masked rows while iterating over them
+	const QList< Interval<int> > masked = maskedIntervals();
+
+	//the valid values are copied for the selection of the median, the values of mapped columns
+	//that might not fit into the memory are read again in each pass instead
+	const bool copyValues = !isMapped();
+
+	//first pass: moments and the copy of the valid values
+	QVector<double> values(copyValues ? size : 0);
+	QVector<StatisticsChunk> chunkResults(chunks);
+	QVector<StatisticsTask*> tasks;
+	for (int i = 0; i < chunks; ++i) {
+		const int start = (qint64)size*i/chunks;
+		const int end = (qint64)size*(i+1)/chunks;
+		tasks << new StatisticsMomentsTask(rowValues, start, end, masked, copyValues ? values.data() : 0, &chunkResults[i]);
+	}
+	runStatisticsTasks(tasks);
+
+	//merge the partial results and make the copied values contiguous
+	StatisticsChunk total;
+	for (int i = 0; i < chunks; ++i) {
+		const int start = (qint64)size*i/chunks;
+		if (copyValues)
+			memmove(values.data() + total.count, values.constData() + start, chunkResults.at(i).count*sizeof(double));
+		total.merge(chunkResults.at(i));
+	}
+
+	const int notNanCount = total.count;
+	if (notNanCount == 0) {
+		setStatisticsAvailable(true);
+		return;
+	}
+
+	statistics.minimum = total.minimum;
+	statistics.maximum = total.maximum;
+	statistics.arithmeticMean = total.mean;
+	if (total.zeroCount > 0)
+		statistics.geometricMean = 0.0;
+	else if (total.negativeCount%2)
+		statistics.geometricMean = NAN;
+	else
+		statistics.geometricMean = exp(total.sumLog.sum/notNanCount);
+	statistics.harmonicMean = notNanCount / total.sumInverse.sum;
+	statistics.contraharmonicMean = total.sumSquare.sum / total.sum.sum;
+
+	statistics.variance = total.M2 / notNanCount;
 	statistics.standardDeviation = sqrt(statistics.variance);
-	statistics.skewness = centralMoment_r3 / pow(statistics.standardDeviation, 3.0);
-	statistics.kurtosis = (centralMoment_r4 / pow(statistics.standardDeviation, 4.0)) - 3.0;
-	statistics.meanDeviation = columnSumMeanDeviation / notNanCount;
+	const double centralMoment_r3 = total.M3 / notNanCount;
+	const double centralMoment_r4 = total.M4 / notNanCount;
+	statistics.skewness = centralMoment_r3 / (statistics.variance * statistics.standardDeviation);
+	statistics.kurtosis = centralMoment_r4 / (statistics.variance * statistics.variance) - 3.0;
+
+	//the copied values are all valid, otherwise the tasks skip the invalid rows of the column
+	const double* validValues = copyValues ? values.constData() : rowValues;
+	const int validSize = copyValues ? notNanCount : size;
+	const QList< Interval<int> > validMasked = copyValues ? QList< Interval<int> >() : masked;
+
+	//entropy: the values are counted in hash partitions, each task counts the values of its partition
+	const int partitions = qBound(1, notNanCount/statisticsChunkSize, qMax(1, QThreadPool::globalInstance()->maxThreadCount()));
+	QVector<double> entropies(partitions);
+	for (int i = 0; i < partitions; ++i)
+		tasks << new StatisticsEntropyTask(validValues, validSize, validMasked, notNanCount, i, partitions, &entropies[i]);
+	runStatisticsTasks(tasks);
 
 	double entropy = 0.0;
-	QList<int> frequencyOfValuesValues = frequencyOfValues.values();
-	for (int i = 0; i < frequencyOfValuesValues.size(); ++i) {
-		double frequencyNorm = static_cast<double>(frequencyOfValuesValues.at(i)) / notNanCount;
-		entropy += (frequencyNorm * log2(frequencyNorm));
+	for (int i = 0; i < partitions; ++i)
+		entropy += entropies.at(i);
+	statistics.entropy = -entropy;
+
+	if (copyValues)
+		statistics.median = selectMedian(values.data(), notNanCount);
+	else
+		statistics.median = selectMappedMedian(rowValues, size, masked, notNanCount, 0.0, false);
+
+	//second pass: deviations around mean and median
+	const int deviationChunks = qBound(1, validSize/statisticsChunkSize, qMax(1, QThreadPool::globalInstance()->maxThreadCount()));
+	QVector<KahanSum> meanDeviations(deviationChunks);
+	QVector<KahanSum> medianDeviations(deviationChunks);
+	for (int i = 0; i < deviationChunks; ++i) {
+		const int start = (qint64)validSize*i/deviationChunks;
+		const int end = (qint64)validSize*(i+1)/deviationChunks;
+		tasks << new StatisticsDeviationTask(validValues, start, end, validMasked, statistics.arithmeticMean, statistics.median,
+							copyValues ? values.data() : 0, &meanDeviations[i], &medianDeviations[i]);
 	}
+	runStatisticsTasks(tasks);
+
+	KahanSum columnSumMeanDeviation;
+	KahanSum columnSumMedianDeviation;
+	for (int i = 0; i < deviationChunks; ++i) {
+		columnSumMeanDeviation.add(meanDeviations.at(i));
+		columnSumMedianDeviation.add(medianDeviations.at(i));
+	}
+	statistics.meanDeviation = columnSumMeanDeviation.sum / notNanCount;
+	statistics.meanDeviationAroundMedian = columnSumMedianDeviation.sum / notNanCount;
+
+	//the copied values were replaced by the absolute deviations around the median
+	if (copyValues)
+		statistics.medianDeviation = selectMedian(values.data(), notNanCount);
+	else
+		statistics.medianDeviation = selectMappedMedian(rowValues, size, masked, notNanCount, statistics.median, true);
 
-	statistics.entropy = -entropy;
 	setStatisticsAvailable(true);
 }
 
+/**
+ * \brief Return the data pointer to modify the values directly
+ *
+ * The values of mapped and virtual columns are copied into memory first, see ColumnMaterializeCmd.
+ */
 void* Column::data() const {
+	if ((isMapped() || isVirtual()) && canMaterialize())
+		const_cast<Column*>(this)->exec(new ColumnMaterializeCmd(m_column_private));
 	return m_column_private->dataPointer();
 }
+
 /**
  * \brief Return the content of row 'row'.
  *
@@ -562,10 +1168,63 @@ double Column::valueAt(int row) const {
  * This is used e.g. in \c XYFitCurvePrivate::recalculate()
  */
 void Column::setChanged() {
-	if (!m_suppressDataChangedSignal)
-		emit dataChanged(this);
+	//the receivers of dataChanged() (e.g. the autoscaling of the plots) read the extrema directly
+	invalidateProperties();
+
+	notifyDataChanged(0, rowCount() - 1);
+}
 
+/*
+ * call this function if the data of the column was changed directly via the data()-pointer
+ * and the owner of the column notifies about the change itself (like the analysis curves do
+ * for their internal result columns). Invalidates the statistics and the cached extrema.
+ */
+void Column::invalidateProperties() {
 	setStatisticsAvailable(false);
+	m_column_private->invalidateExtrema();
+}
+
+/**
+ * \brief Return a read-only view of the numeric data
+ *
+ * For Numeric columns the view shares the data vector or the mapped file of the column (no values are copied),
+ * the values of Integer, BigInt and Float columns are widened to double on the fly.
+ * For the other modes the values are materialized as in AbstractColumn::numericView().
+ */
+AbstractColumn::NumericView Column::numericView() const {
+	if (!isNumeric(columnMode()))
+		return AbstractColumn::numericView();
+
+	NumericView view;
+	const ColumnMappedData* mapped = m_column_private->mappedData();
+	if (mapped && mapped->constData()) {
+		//the view points into the mapped file, the pages are read on demand
+		view.m_data = mapped->constData();
+		view.m_size = static_cast<int>(mapped->size());
+		view.m_mappedFile = mapped->file();
+	} else {
+		view.setValues(m_column_private->numericValues());
+	}
+	fillMaskedRows(view);
+	return view;
+}
+
+/**
+ * \brief Return the smallest value of the column
+ *
+ * In contrast to AbstractColumn::minimum() the value is cached and kept up to date
+ * when the data is modified, so that e.g. the autoscaling of plots doesn't need to
+ * scan the whole column every time.
+ */
+double Column::minimum() const {
+	return m_column_private->minimum();
+}
+
+/**
+ * \brief Return the largest value of the column
+ */
+double Column::maximum() const {
+	return m_column_private->maximum();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -578,6 +1237,9 @@ void Column::setChanged() {
 QIcon Column::icon() const {
 	switch(columnMode()) {
 	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float:
 		return KIcon("x-shape-text");
 	case AbstractColumn::Text:
 		return KIcon("draw-text");
@@ -646,12 +1308,51 @@ void Column::save(QXmlStreamWriter* writer) const {
 	int i;
 	switch(columnMode()) {
 	case AbstractColumn::Numeric: {
+			const ColumnMappedData* mapped = m_column_private->mappedData();
+			if (mapped) {
+				//the values stay in the mapped file, only the reference to it is saved
+				writer->writeStartElement("mapped_data");
+				writer->writeAttribute("file", mapped->fileName());
+				writer->writeAttribute("offset", QString::number(mapped->offset()));
+				writer->writeAttribute("rows", QString::number(mapped->size()));
+				writer->writeEndElement();
+				break;
+			}
+
+			if (m_column_private->virtualData()) {
+				//the values are computed from the formula saved above
+				writer->writeStartElement("virtual_data");
+				writer->writeEndElement();
+				break;
+			}
+
 			const char* data = reinterpret_cast<const char*>(
 			                       static_cast< QVector<double>* >(m_column_private->dataPointer())->constData());
 			int size = m_column_private->rowCount()*sizeof(double);
 			writer->writeCharacters(QByteArray::fromRawData(data,size).toBase64());
 			break;
 		}
+	case AbstractColumn::Integer: {
+			const char* data = reinterpret_cast<const char*>(
+			                       static_cast< QVector<int>* >(m_column_private->dataPointer())->constData());
+			int size = m_column_private->rowCount()*sizeof(int);
+			writer->writeCharacters(QByteArray::fromRawData(data,size).toBase64());
+			break;
+		}
+	case AbstractColumn::BigInt: {
+			const char* data = reinterpret_cast<const char*>(
+			                       static_cast< QVector<qint64>* >(m_column_private->dataPointer())->constData());
+			int size = m_column_private->rowCount()*sizeof(qint64);
+			writer->writeCharacters(QByteArray::fromRawData(data,size).toBase64());
+			break;
+		}
+	case AbstractColumn::Float: {
+			const char* data = reinterpret_cast<const char*>(
+			                       static_cast< QVector<float>* >(m_column_private->dataPointer())->constData());
+			int size = m_column_private->rowCount()*sizeof(float);
+			writer->writeCharacters(QByteArray::fromRawData(data,size).toBase64());
+			break;
+		}
 	case AbstractColumn::Text:
 		for(i=0; i<rowCount(); ++i) {
 			writer->writeStartElement("row");
@@ -684,12 +1385,33 @@ public:
 	};
 	void run() {
 		QByteArray bytes = QByteArray::fromBase64(m_content.toAscii());
-		QVector<double> * data = new QVector<double>(bytes.size()/sizeof(double));
-		memcpy(data->data(), bytes.data(), bytes.size());
-		m_private->replaceData(data);
+		switch (m_private->columnMode()) {
+		case AbstractColumn::Integer:
+			m_private->replaceData(decode<int>(bytes));
+			break;
+		case AbstractColumn::BigInt:
+			m_private->replaceData(decode<qint64>(bytes));
+			break;
+		case AbstractColumn::Float:
+			m_private->replaceData(decode<float>(bytes));
+			break;
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Text:
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day:
+			m_private->replaceData(decode<double>(bytes));
+			break;
+		}
 	}
 
 private:
+	template <typename T> static QVector<T>* decode(const QByteArray& bytes) {
+		QVector<T> * data = new QVector<T>(bytes.size()/sizeof(T));
+		memcpy(data->data(), bytes.data(), data->size()*sizeof(T));
+		return data;
+	}
+
 	ColumnPrivate* m_private;
 	QString m_content;
 };
@@ -737,6 +1459,10 @@ bool Column::load(XmlStreamReader* reader) {
 					ret_val = XmlReadFormula(reader);
 				else if(reader->name() == "row")
 					ret_val = XmlReadRow(reader);
+				else if(reader->name() == "mapped_data")
+					ret_val = XmlReadMappedData(reader);
+				else if(reader->name() == "virtual_data")
+					ret_val = XmlReadVirtualData(reader);
 				else { // unknown element
 					reader->raiseWarning(i18n("unknown element '%1'", reader->name().toString()));
 					if (!reader->skipToEndElement()) return false;
@@ -745,11 +1471,14 @@ bool Column::load(XmlStreamReader* reader) {
 					return false;
 			}
 			QString content = reader->text().toString().trimmed();
-			if (!content.isEmpty() && columnMode() == AbstractColumn::Numeric) {
+			if (!content.isEmpty() && isNumeric(columnMode())) {
 				DecodeColumnTask* task = new DecodeColumnTask(m_column_private, content);
 				QThreadPool::globalInstance()->start(task);
 			}
 		}
+
+		if (columnMode() == AbstractColumn::Text)
+			encodeText();
 	} else // no column element
 		reader->raiseError(i18n("no column element found"));
 
@@ -852,7 +1581,10 @@ bool Column::XmlReadRow(XmlStreamReader * reader) {
 
 	str = reader->readElementText();
 	switch(columnMode()) {
-	case AbstractColumn::Numeric: {
+	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float: {
 			double value = str.toDouble(&ok);
 			if(!ok) {
 				reader->raiseError(i18n("invalid row value"));
@@ -876,6 +1608,35 @@ bool Column::XmlReadRow(XmlStreamReader * reader) {
 	return true;
 }
 
+/**
+ * \brief Read XML mapped_data element
+ */
+bool Column::XmlReadMappedData(XmlStreamReader * reader) {
+	Q_ASSERT(reader->isStartElement() && reader->name() == "mapped_data");
+
+	QXmlStreamAttributes attribs = reader->attributes();
+	const QString fileName = attribs.value("file").toString();
+	const qint64 offset = attribs.value("offset").toString().toLongLong();
+	const qint64 rows = attribs.value("rows").toString().toLongLong();
+
+	if (!mapData(fileName, offset, rows))
+		reader->raiseWarning(i18n("the data file '%1' could not be mapped, the column is empty", fileName));
+
+	return reader->skipToEndElement();
+}
+
+/**
+ * \brief Read XML virtual_data element
+ */
+bool Column::XmlReadVirtualData(XmlStreamReader * reader) {
+	Q_ASSERT(reader->isStartElement() && reader->name() == "virtual_data");
+
+	if (!m_column_private->makeVirtual())
+		reader->raiseWarning(i18n("the values of the column '%1' could not be computed, the column is empty", name()));
+
+	return reader->skipToEndElement();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //@}
 ////////////////////////////////////////////////////////////////////////////////
@@ -35,6 +35,7 @@
 
 class ColumnStringIO;
 class ColumnPrivate;
+class ColumnTextData;
 
 class Column : public AbstractColumn {
 	Q_OBJECT
@@ -116,6 +117,13 @@ class Column : public AbstractColumn {
 		QString textAt(int row) const;
 		void setTextAt(int row, const QString& new_value);
 		void replaceTexts(int first, const QStringList& new_values);
+		const ColumnTextData* textData() const;
+		bool encodeText();
+		bool mapData(const QString& fileName, qint64 offset, qint64 rows);
+		bool isMapped() const;
+		bool setVirtualFormula(const QString& formula, const QStringList& variableNames, const QStringList& variableColumnPathes);
+		bool isVirtual() const;
+		void invalidateVirtualData(int first, int last);
 		QDate dateAt(int row) const;
 		void setDateAt(int row, const QDate& new_value);
 		QTime timeAt(int row) const;
@@ -126,8 +134,15 @@ class Column : public AbstractColumn {
 		double valueAt(int row) const;
 		void setValueAt(int row, double new_value);
 		virtual void replaceValues(int first, const QVector<double>& new_values);
+		NumericView numericView() const;
+		double minimum() const;
+		double maximum() const;
 		void setChanged();
+		void invalidateProperties();
 		void setSuppressDataChangedSignal(bool);
+		void beginUpdate();
+		void endUpdate();
+		Interval<int> changedRows() const;
 
 		void save(QXmlStreamWriter*) const;
 		bool load(XmlStreamReader*);
@@ -137,9 +152,17 @@ class Column : public AbstractColumn {
 		bool XmlReadOutputFilter(XmlStreamReader * reader);
 		bool XmlReadFormula(XmlStreamReader * reader);
 		bool XmlReadRow(XmlStreamReader * reader);
+		bool XmlReadMappedData(XmlStreamReader * reader);
+		bool XmlReadVirtualData(XmlStreamReader * reader);
 
 		void handleRowInsertion(int before, int count);
 		void handleRowRemoval(int first, int count);
+		void execModification(QUndoCommand*);
+		bool canMaterialize() const;
+
+		void addChangedRows(int first, int last);
+		void notifyDataChanged(int first, int last);
+		void emitDataChanged();
 
 		void calculateStatistics();
 		void setStatisticsAvailable(bool available);
@@ -148,12 +171,16 @@ class Column : public AbstractColumn {
 		ColumnPrivate* m_column_private;
 		ColumnStringIO* m_string_io;
 		bool m_suppressDataChangedSignal;
+		int m_updateLevel;
+		Interval<int> m_changedRows;
 
 		friend class ColumnStringIO;
 
 	signals:
 		void widthAboutToChange(const Column*);
 		void widthChanged(const Column*);
+		void rowsChanged(const Column*, int first, int last);
+		void formulaChanged(const Column*);
 
 	private slots:
 		void handleFormatChange();
@@ -0,0 +1,133 @@
+/***************************************************************************
+    File                 : ColumnMappedData.cpp
+    Project              : LabPlot
+    Description          : File backed storage of the values of Numeric columns
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "backend/core/column/ColumnMappedData.h"
+#include "backend/core/AbstractColumn.h"
+
+#include <limits>
+#include <cstring>
+
+/**
+ * \class ColumnMappedData
+ * \brief File backed storage of the values of Numeric columns
+ *
+ * The values are not copied into memory but read directly from a file containing
+ * double precision values in the native byte order, e.g. a raw binary recording.
+ * The file is mapped into the address space of the process and the operating system
+ * pages the data in on demand, so that columns larger than the available memory can be plotted and analyzed.
+ *
+ * The values of one column start at offset() and are stored contiguously. Interleaved channels
+ * and values that are not aligned in the file are not mapped, the views of the mapped values point
+ * directly into the mapped file, see Column::numericView().
+ * The mapped data is read-only, the values are copied into memory before they are modified, see ColumnMaterializeCmd.
+ */
+
+ColumnMappedData::ColumnMappedData() : m_data(0), m_offset(0), m_size(0) {
+}
+
+/**
+ * Maps \c rows values of the file \c fileName starting at the byte \c offset, at most maxSize() values.
+ * Returns \c false if the file couldn't be opened or mapped or if the mapped values are not aligned.
+ */
+bool ColumnMappedData::map(const QString& fileName, qint64 offset, qint64 rows) {
+	if (rows < 0 || rows > maxSize() || offset < 0)
+		return false;
+
+	QSharedPointer<QFile> file(new QFile(fileName));
+	if (!file->open(QIODevice::ReadOnly))
+		return false;
+
+	const qint64 bytes = rows*(qint64)sizeof(double);
+	if (offset + bytes > file->size())
+		return false;
+
+	uchar* data = 0;
+	if (bytes > 0) {
+		data = file->map(offset, bytes);
+		if (!data)
+			return false;
+
+		//the mapping starts at a page boundary, the values are aligned if the offset is a multiple of the value size
+		if (reinterpret_cast<quintptr>(data) % sizeof(double) != 0) {
+			file->unmap(data);
+			return false;
+		}
+	}
+
+	//the mapping stays valid as long as the file is open, views of the data share the file
+	m_file = file;
+	m_data = reinterpret_cast<const double*>(data);
+	m_offset = offset;
+	m_size = rows;
+	return true;
+}
+
+QString ColumnMappedData::fileName() const {
+	return m_file ? m_file->fileName() : QString();
+}
+
+qint64 ColumnMappedData::offset() const {
+	return m_offset;
+}
+
+qint64 ColumnMappedData::size() const {
+	return m_size;
+}
+
+/**
+ * Returns the maximal number of mapped values. The mapped values don't need to fit into the memory
+ * like the values of the other columns, but the rows of a column are indexed with \c int.
+ */
+qint64 ColumnMappedData::maxSize() {
+	return std::numeric_limits<int>::max();
+}
+
+double ColumnMappedData::value(qint64 row) const {
+	return m_data[row];
+}
+
+//! returns the contiguous mapped values
+const double* ColumnMappedData::constData() const {
+	return m_data;
+}
+
+//! copy the mapped values into memory, at most AbstractColumn::maxRowCount() values fit into the vector
+QVector<double> ColumnMappedData::toVector() const {
+	Q_ASSERT(m_size <= AbstractColumn::maxRowCount(AbstractColumn::Numeric));
+	QVector<double> values(m_size);
+	if (m_size > 0)
+		memcpy(values.data(), m_data, m_size*sizeof(double));
+	return values;
+}
+
+/**
+ * Returns the mapped file. The mapped memory stays valid as long as a reference to the file is held.
+ */
+QSharedPointer<QFile> ColumnMappedData::file() const {
+	return m_file;
+}
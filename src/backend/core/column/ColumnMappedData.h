@@ -0,0 +1,59 @@
+/***************************************************************************
+    File                 : ColumnMappedData.h
+    Project              : LabPlot
+    Description          : File backed storage of the values of Numeric columns
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef COLUMNMAPPEDDATA_H
+#define COLUMNMAPPEDDATA_H
+
+#include <QFile>
+#include <QSharedPointer>
+#include <QVector>
+
+class ColumnMappedData {
+	public:
+		ColumnMappedData();
+
+		bool map(const QString& fileName, qint64 offset, qint64 rows);
+
+		QString fileName() const;
+		qint64 offset() const;
+		qint64 size() const;
+		static qint64 maxSize();
+
+		double value(qint64 row) const;
+		const double* constData() const;
+		QVector<double> toVector() const;
+		QSharedPointer<QFile> file() const;
+
+	private:
+		QSharedPointer<QFile> m_file;
+		const double* m_data;
+		qint64 m_offset;
+		qint64 m_size;
+};
+
+#endif
@@ -42,6 +42,125 @@
 #include "backend/core/datatypes/DayOfWeek2DoubleFilter.h"
 #include "backend/core/datatypes/Month2DoubleFilter.h"
 
+#include <QDataStream>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+//! end of the changed rows if all rows starting at a given row might have changed
+const int lastRow = std::numeric_limits<int>::max();
+
+//! convert a double to the storage type of the compact numeric modes Integer, BigInt and Float
+/**
+ * Values are rounded to the nearest integer and clamped to the range of the integer type, NaN is stored as 0
+ * since the integer types have no empty value (see AbstractColumn::isValid()).
+ */
+template <typename T> T narrowValue(double value) {
+	if (std::isnan(value))
+		return 0;
+	if (value <= static_cast<double>(std::numeric_limits<T>::min()))
+		return std::numeric_limits<T>::min();
+	if (value >= static_cast<double>(std::numeric_limits<T>::max()))
+		return std::numeric_limits<T>::max();
+	return static_cast<T>(value < 0 ? std::ceil(value - 0.5) : std::floor(value + 0.5));
+}
+
+template <> float narrowValue<float>(double value) {
+	return static_cast<float>(value);
+}
+
+//! allocate an empty data vector for the numeric mode \c mode
+void* newNumericData(AbstractColumn::ColumnMode mode) {
+	switch (mode) {
+	case AbstractColumn::Integer:
+		return new QVector<int>();
+	case AbstractColumn::BigInt:
+		return new QVector<qint64>();
+	case AbstractColumn::Float:
+		return new QVector<float>();
+	case AbstractColumn::Numeric:
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	return new QVector<double>();
+}
+
+//! resize the vector \c data to \c new_size elements, appended elements are set to \c empty
+template <typename T> void resizeVector(void* data, int new_size, T empty) {
+	QVector<T>* vector = static_cast< QVector<T>* >(data);
+	const int old_size = vector->size();
+	vector->resize(new_size);
+	if (new_size > old_size)
+		std::fill(vector->begin() + old_size, vector->end(), empty);
+}
+
+template <typename T> double widenedValueAt(const void* data, int row) {
+	const QVector<T>* vector = static_cast< const QVector<T>* >(data);
+	if (row < 0 || row >= vector->size())
+		return NAN;
+	return vector->at(row);
+}
+
+//! copy the values of \c source into the vector \c data, converting them to the storage type T
+template <typename T, typename Source>
+void copyValues(void* data, const Source* source, int source_start, int dest_start, int num_rows) {
+	T* ptr = static_cast< QVector<T>* >(data)->data();
+	for (int i=0; i<num_rows; ++i)
+		ptr[dest_start+i] = narrowValue<T>(source->valueAt(source_start + i));
+}
+
+//! write the values \c values to the vector \c data starting at row \c first, converting them to the storage type T
+template <typename T> void replaceVectorValues(void* data, int first, const QVector<double>& values) {
+	T* ptr = static_cast< QVector<T>* >(data)->data() + first;
+	const double* src = values.constData();
+	const int size = values.size();
+	for (int i=0; i<size; ++i)
+		ptr[i] = narrowValue<T>(src[i]);
+}
+
+//! copy values between two vectors of the same type without any conversion
+template <typename T>
+void copyRawValues(void* data, const void* source, int source_start, int dest_start, int num_rows) {
+	const T* src = static_cast< const QVector<T>* >(source)->constData() + source_start;
+	std::copy(src, src + num_rows, static_cast< QVector<T>* >(data)->data() + dest_start);
+}
+
+template <typename T> QVector<double> widenedValues(const void* data) {
+	const QVector<T>* vector = static_cast< const QVector<T>* >(data);
+	const int size = vector->size();
+	const T* src = vector->constData();
+	QVector<double> values(size);
+	double* dest = values.data();
+	for (int i=0; i<size; ++i)
+		dest[i] = src[i];
+	return values;
+}
+
+template <typename T> void scanExtrema(const void* data, double& min, double& max) {
+	const QVector<T>* vector = static_cast< const QVector<T>* >(data);
+	const T* ptr = vector->constData();
+	const int size = vector->size();
+	for (int row = 0; row < size; ++row) {
+		const double val = ptr[row];
+		if (std::isnan(val))
+			continue;
+
+		if (val < min)
+			min = val;
+		if (val > max)
+			max = val;
+	}
+}
+
+}
+
 
 /**
  * \class ColumnPrivate
@@ -62,8 +181,11 @@
  * \var ColumnPrivate::m_data
  * \brief Pointer to the data vector
  *
- * This will point to a QVector<double>, QStringList or
- * QList<QDateTime> depending on the stored data type.
+ * This will point to a QVector<double>, ColumnTextData or
+ * QVector<qint64> depending on the stored data type.
+ * Integer, BigInt and Float columns use QVector<int>, QVector<qint64> and QVector<float>.
+ * DateTime, Month and Day values are stored as milliseconds since
+ * 1970-01-01 00:00 (wall clock time, no time zone conversion), see dateTimeToMSecs().
  */
 
 /**
@@ -95,7 +217,8 @@
  * \brief Ctor
  */
 ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode)
-	: statisticsAvailable(false), m_column_mode(mode), m_plot_designation(AbstractColumn::noDesignation), m_width(0), m_owner(owner) {
+	: statisticsAvailable(false), m_column_mode(mode), m_mapped(0), m_virtual(0), m_plot_designation(AbstractColumn::noDesignation), m_width(0), m_owner(owner),
+	m_extremaAvailable(false), m_minimum(INFINITY), m_maximum(-INFINITY) {
 	Q_ASSERT(owner != 0); // a ColumnPrivate without owner is not allowed
 	// because the owner must become the parent aspect of the input and output filters
 	switch(mode) {
@@ -107,24 +230,39 @@ ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode)
 	case AbstractColumn::Text:
 		m_input_filter = new SimpleCopyThroughFilter();
 		m_output_filter = new SimpleCopyThroughFilter();
-		m_data = new QStringList();
+		m_data = new ColumnTextData();
 		break;
 	case AbstractColumn::DateTime:
 		m_input_filter = new String2DateTimeFilter();
 		m_output_filter = new DateTime2StringFilter();
-		m_data = new QList<QDateTime>();
+		m_data = new QVector<qint64>();
 		break;
 	case AbstractColumn::Month:
 		m_input_filter = new String2MonthFilter();
 		m_output_filter = new DateTime2StringFilter();
 		static_cast<DateTime2StringFilter *>(m_output_filter)->setFormat("MMMM");
-		m_data = new QList<QDateTime>();
+		m_data = new QVector<qint64>();
 		break;
 	case AbstractColumn::Day:
 		m_input_filter = new String2DayOfWeekFilter();
 		m_output_filter = new DateTime2StringFilter();
 		static_cast<DateTime2StringFilter *>(m_output_filter)->setFormat("dddd");
-		m_data = new QList<QDateTime>();
+		m_data = new QVector<qint64>();
+		break;
+	case AbstractColumn::Integer:
+		m_input_filter = new String2DoubleFilter();
+		m_output_filter = new Double2StringFilter('f', 0);
+		m_data = new QVector<int>();
+		break;
+	case AbstractColumn::BigInt:
+		m_input_filter = new String2DoubleFilter();
+		m_output_filter = new Double2StringFilter('f', 0);
+		m_data = new QVector<qint64>();
+		break;
+	case AbstractColumn::Float:
+		m_input_filter = new String2DoubleFilter();
+		m_output_filter = new Double2StringFilter();
+		m_data = new QVector<float>();
 		break;
 	}
 
@@ -138,7 +276,8 @@ ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode)
  * \brief Special ctor (to be called from Column only!)
  */
 ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode, void* data)
-	: statisticsAvailable(false), m_column_mode(mode), m_data(data), m_plot_designation(AbstractColumn::noDesignation), m_width(0), m_owner(owner) {
+	: statisticsAvailable(false), m_column_mode(mode), m_data(data), m_mapped(0), m_virtual(0), m_plot_designation(AbstractColumn::noDesignation), m_width(0), m_owner(owner),
+	m_extremaAvailable(false), m_minimum(INFINITY), m_maximum(-INFINITY) {
 
 	switch(mode) {
 	case AbstractColumn::Numeric:
@@ -171,6 +310,19 @@ ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode, voi
 		connect(static_cast<DateTime2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
 		break;
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+		m_input_filter = new String2DoubleFilter();
+		m_output_filter = new Double2StringFilter('f', 0);
+		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
+		        m_owner, SLOT(handleFormatChange()));
+		break;
+	case AbstractColumn::Float:
+		m_input_filter = new String2DoubleFilter();
+		m_output_filter = new Double2StringFilter();
+		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
+		        m_owner, SLOT(handleFormatChange()));
+		break;
 	}
 
 	m_input_filter->setName("InputFilter");
@@ -181,6 +333,8 @@ ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode, voi
  * \brief Dtor
  */
 ColumnPrivate::~ColumnPrivate() {
+	delete m_mapped;
+	delete m_virtual;
 	if (!m_data) return;
 
 	switch(m_column_mode) {
@@ -189,13 +343,22 @@ ColumnPrivate::~ColumnPrivate() {
 		break;
 
 	case AbstractColumn::Text:
-		delete static_cast< QStringList* >(m_data);
+		delete static_cast< ColumnTextData* >(m_data);
 		break;
 
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
-		delete static_cast< QList<QDateTime>* >(m_data);
+	case AbstractColumn::BigInt:
+		delete static_cast< QVector<qint64>* >(m_data);
+		break;
+
+	case AbstractColumn::Integer:
+		delete static_cast< QVector<int>* >(m_data);
+		break;
+
+	case AbstractColumn::Float:
+		delete static_cast< QVector<float>* >(m_data);
 		break;
 	} // switch(m_column_mode)
 }
@@ -221,7 +384,9 @@ AbstractColumn::ColumnMode ColumnPrivate::columnMode() const {
  */
 void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 	if (mode == m_column_mode) return;
+	unmapData();
 
+	invalidateExtrema();
 	void * old_data = m_data;
 	// remark: the deletion of the old data will be done in the dtor of a command
 
@@ -245,25 +410,33 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 			filter = outputFilter();
 			filter_is_temporary = false;
 			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QStringList();
+			m_data = new ColumnTextData();
 			break;
 		case AbstractColumn::DateTime:
 			filter = new Double2DateTimeFilter();
 			filter_is_temporary = true;
 			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QList<QDateTime>();
+			m_data = new QVector<qint64>();
 			break;
 		case AbstractColumn::Month:
 			filter = new Double2MonthFilter();
 			filter_is_temporary = true;
 			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QList<QDateTime>();
+			m_data = new QVector<qint64>();
 			break;
 		case AbstractColumn::Day:
 			filter = new Double2DayOfWeekFilter();
 			filter_is_temporary = true;
 			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QList<QDateTime>();
+			m_data = new QVector<qint64>();
+			break;
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float:
+			filter = new SimpleCopyThroughFilter();
+			filter_is_temporary = true;
+			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
+			m_data = newNumericData(mode);
 			break;
 		} // switch(mode)
 		break;
@@ -275,26 +448,34 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 		case AbstractColumn::Numeric:
 			filter = new String2DoubleFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
+			temp_col = new Column("temp_col", static_cast< ColumnTextData* >(old_data)->toStringList());
 			m_data = new QVector<double>();
 			break;
 		case AbstractColumn::DateTime:
 			filter = new String2DateTimeFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
-			m_data = new QList<QDateTime>();
+			temp_col = new Column("temp_col", static_cast< ColumnTextData* >(old_data)->toStringList());
+			m_data = new QVector<qint64>();
 			break;
 		case AbstractColumn::Month:
 			filter = new String2MonthFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
-			m_data = new QList<QDateTime>();
+			temp_col = new Column("temp_col", static_cast< ColumnTextData* >(old_data)->toStringList());
+			m_data = new QVector<qint64>();
 			break;
 		case AbstractColumn::Day:
 			filter = new String2DayOfWeekFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
-			m_data = new QList<QDateTime>();
+			temp_col = new Column("temp_col", static_cast< ColumnTextData* >(old_data)->toStringList());
+			m_data = new QVector<qint64>();
+			break;
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float:
+			filter = new String2DoubleFilter();
+			filter_is_temporary = true;
+			temp_col = new Column("temp_col", static_cast< ColumnTextData* >(old_data)->toStringList());
+			m_data = newNumericData(mode);
 			break;
 		} // switch(mode)
 		break;
@@ -310,10 +491,13 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 		case AbstractColumn::Text:
 			filter = outputFilter();
 			filter_is_temporary = false;
-			temp_col = new Column("temp_col", *(static_cast< QList<QDateTime>* >(old_data)));
-			m_data = new QStringList();
+			temp_col = new Column("temp_col", dateTimeList(*static_cast< QVector<qint64>* >(old_data)));
+			m_data = new ColumnTextData();
 			break;
 		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float:
 			if (m_column_mode == AbstractColumn::Month)
 				filter = new Month2DoubleFilter();
 			else if (m_column_mode == AbstractColumn::Day)
@@ -321,8 +505,8 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 			else
 				filter = new DateTime2DoubleFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QList<QDateTime>* >(old_data)));
-			m_data = new QVector<double>();
+			temp_col = new Column("temp_col", dateTimeList(*static_cast< QVector<qint64>* >(old_data)));
+			m_data = newNumericData(mode);
 			break;
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
@@ -330,6 +514,44 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 		} // switch(mode)
 		break;
 
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float:
+		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
+		           m_owner, SLOT(handleFormatChange()));
+		// the conversion is done on the widened values
+		temp_col = new Column("temp_col", numericValues());
+		switch(mode) {
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float:
+			filter = new SimpleCopyThroughFilter();
+			filter_is_temporary = true;
+			m_data = newNumericData(mode);
+			break;
+		case AbstractColumn::Text:
+			filter = outputFilter();
+			filter_is_temporary = false;
+			m_data = new ColumnTextData();
+			break;
+		case AbstractColumn::DateTime:
+			filter = new Double2DateTimeFilter();
+			filter_is_temporary = true;
+			m_data = new QVector<qint64>();
+			break;
+		case AbstractColumn::Month:
+			filter = new Double2MonthFilter();
+			filter_is_temporary = true;
+			m_data = new QVector<qint64>();
+			break;
+		case AbstractColumn::Day:
+			filter = new Double2DayOfWeekFilter();
+			filter_is_temporary = true;
+			m_data = new QVector<qint64>();
+			break;
+		} // switch(mode)
+		break;
 	}
 
 	// determine the new input and output filters
@@ -364,6 +586,19 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 		connect(static_cast<DateTime2StringFilter *>(new_out_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
 		break;
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+		new_in_filter = new String2DoubleFilter();
+		new_out_filter = new Double2StringFilter('f', 0);
+		connect(static_cast<Double2StringFilter *>(new_out_filter), SIGNAL(formatChanged()),
+		        m_owner, SLOT(handleFormatChange()));
+		break;
+	case AbstractColumn::Float:
+		new_in_filter = new String2DoubleFilter();
+		new_out_filter = new Double2StringFilter();
+		connect(static_cast<Double2StringFilter *>(new_out_filter), SIGNAL(formatChanged()),
+		        m_owner, SLOT(handleFormatChange()));
+		break;
 	} // switch(mode)
 
 	m_column_mode = mode;
@@ -382,6 +617,10 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 		filter->input(0, temp_col);
 		copy(filter->output(0));
 		delete temp_col;
+
+		//use the dictionary encoding for the converted strings if there are only few distinct values
+		if (m_column_mode == AbstractColumn::Text)
+			encodeText();
 	}
 
 	if (filter_is_temporary) delete filter;
@@ -396,10 +635,16 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
  */
 void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void * data,
                                     AbstractSimpleFilter * in_filter, AbstractSimpleFilter * out_filter) {
+	dropMappedData();
+	dropVirtualData();
 	emit m_owner->modeAboutToChange(m_owner);
+	invalidateExtrema();
 	// disconnect formatChanged()
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float:
 		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		           m_owner, SLOT(handleFormatChange()));
 		break;
@@ -426,6 +671,9 @@ void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void * data
 	// connect formatChanged()
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float:
 		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
 		break;
@@ -446,10 +694,13 @@ void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void * data
  * \brief Replace data pointer
  */
 void ColumnPrivate::replaceData(void * data) {
-	emit m_owner->dataAboutToChange(m_owner);
+	//the mapped or computed data is replaced completely, no need to copy it into memory
+	dropMappedData();
+	dropVirtualData();
+	beginDataChange(0, lastRow);
 	m_data = data;
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	invalidateExtrema();
+	endDataChange();
 }
 
 /**
@@ -460,10 +711,13 @@ void ColumnPrivate::replaceData(void * data) {
  * Use a filter to convert a column to another type.
  */
 bool ColumnPrivate::copy(const AbstractColumn * other) {
-	if (other->columnMode() != columnMode()) return false;
+	unmapData();
+	if (other->columnMode() != columnMode() && !(AbstractColumn::isNumeric(other->columnMode()) && AbstractColumn::isNumeric(m_column_mode)))
+		return false;
 	int num_rows = other->rowCount();
 
-	emit m_owner->dataAboutToChange(m_owner);
+	beginDataChange(0, lastRow);
+	invalidateExtrema();
 	resizeTo(num_rows);
 
 	// copy the data
@@ -476,20 +730,29 @@ bool ColumnPrivate::copy(const AbstractColumn * other) {
 		}
 	case AbstractColumn::Text: {
 			for(int i=0; i<num_rows; i++)
-				static_cast< QStringList* >(m_data)->replace(i, other->textAt(i));
+				static_cast< ColumnTextData* >(m_data)->replace(i, other->textAt(i));
 			break;
 		}
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day: {
+			qint64* ptr = static_cast< QVector<qint64>* >(m_data)->data();
 			for(int i=0; i<num_rows; i++)
-				static_cast< QList<QDateTime>* >(m_data)->replace(i, other->dateTimeAt(i));
+				ptr[i] = dateTimeToMSecs(other->dateTimeAt(i));
 			break;
 		}
+	case AbstractColumn::Integer:
+		copyValues<int>(m_data, other, 0, 0, num_rows);
+		break;
+	case AbstractColumn::BigInt:
+		copyValues<qint64>(m_data, other, 0, 0, num_rows);
+		break;
+	case AbstractColumn::Float:
+		copyValues<float>(m_data, other, 0, 0, num_rows);
+		break;
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	endDataChange();
 
 	return true;
 }
@@ -505,10 +768,13 @@ bool ColumnPrivate::copy(const AbstractColumn * other) {
  * \param num_rows the number of rows to copy
  */
 bool ColumnPrivate::copy(const AbstractColumn * source, int source_start, int dest_start, int num_rows) {
-	if (source->columnMode() != m_column_mode) return false;
+	unmapData();
+	if (source->columnMode() != columnMode() && !(AbstractColumn::isNumeric(source->columnMode()) && AbstractColumn::isNumeric(m_column_mode)))
+		return false;
 	if (num_rows == 0) return true;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	beginDataChange(dest_start, dest_start + num_rows - 1);
+	invalidateExtrema();
 	if (dest_start + num_rows > rowCount())
 		resizeTo(dest_start + num_rows);
 
@@ -522,18 +788,28 @@ bool ColumnPrivate::copy(const AbstractColumn * source, int source_start, int de
 		}
 	case AbstractColumn::Text:
 		for(int i=0; i<num_rows; i++)
-			static_cast< QStringList* >(m_data)->replace(dest_start+i, source->textAt(source_start + i));
+			static_cast< ColumnTextData* >(m_data)->replace(dest_start+i, source->textAt(source_start + i));
 		break;
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
-	case AbstractColumn::Day:
-		for(int i=0; i<num_rows; i++)
-			static_cast< QList<QDateTime>* >(m_data)->replace(dest_start+i, source->dateTimeAt(source_start + i));
+	case AbstractColumn::Day: {
+			qint64* ptr = static_cast< QVector<qint64>* >(m_data)->data();
+			for(int i=0; i<num_rows; i++)
+				ptr[dest_start+i] = dateTimeToMSecs(source->dateTimeAt(source_start + i));
+			break;
+		}
+	case AbstractColumn::Integer:
+		copyValues<int>(m_data, source, source_start, dest_start, num_rows);
+		break;
+	case AbstractColumn::BigInt:
+		copyValues<qint64>(m_data, source, source_start, dest_start, num_rows);
+		break;
+	case AbstractColumn::Float:
+		copyValues<float>(m_data, source, source_start, dest_start, num_rows);
 		break;
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	endDataChange();
 
 	return true;
 }
@@ -546,10 +822,12 @@ bool ColumnPrivate::copy(const AbstractColumn * source, int source_start, int de
  * Use a filter to convert a column to another type.
  */
 bool ColumnPrivate::copy(const ColumnPrivate * other) {
+	unmapData();
 	if (other->columnMode() != m_column_mode) return false;
 	int num_rows = other->rowCount();
 
-	emit m_owner->dataAboutToChange(m_owner);
+	beginDataChange(0, lastRow);
+	invalidateExtrema();
 	resizeTo(num_rows);
 
 	// copy the data
@@ -560,22 +838,26 @@ bool ColumnPrivate::copy(const ColumnPrivate * other) {
 				ptr[i] = other->valueAt(i);
 			break;
 		}
-	case AbstractColumn::Text: {
-			for(int i=0; i<num_rows; i++)
-				static_cast< QStringList* >(m_data)->replace(i, other->textAt(i));
-			break;
-		}
+	case AbstractColumn::Text:
+		//same storage on both sides, the dictionary encoding is taken over
+		*static_cast< ColumnTextData* >(m_data) = *static_cast< ColumnTextData* >(other->m_data);
+		break;
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
-	case AbstractColumn::Day: {
-			for(int i=0; i<num_rows; i++)
-				static_cast< QList<QDateTime>* >(m_data)->replace(i, other->dateTimeAt(i));
-			break;
-		}
+	case AbstractColumn::Day:
+	case AbstractColumn::BigInt:
+		//same storage on both sides, no conversion required
+		copyRawValues<qint64>(m_data, other->m_data, 0, 0, num_rows);
+		break;
+	case AbstractColumn::Integer:
+		copyRawValues<int>(m_data, other->m_data, 0, 0, num_rows);
+		break;
+	case AbstractColumn::Float:
+		copyRawValues<float>(m_data, other->m_data, 0, 0, num_rows);
+		break;
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	endDataChange();
 
 	return true;
 }
@@ -591,10 +873,12 @@ bool ColumnPrivate::copy(const ColumnPrivate * other) {
  * \param num_rows the number of rows to copy
  */
 bool ColumnPrivate::copy(const ColumnPrivate * source, int source_start, int dest_start, int num_rows) {
+	unmapData();
 	if (source->columnMode() != m_column_mode) return false;
 	if (num_rows == 0) return true;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	beginDataChange(dest_start, dest_start + num_rows - 1);
+	invalidateExtrema();
 	if (dest_start + num_rows > rowCount())
 		resizeTo(dest_start + num_rows);
 
@@ -608,18 +892,23 @@ bool ColumnPrivate::copy(const ColumnPrivate * source, int source_start, int des
 		}
 	case AbstractColumn::Text:
 		for(int i=0; i<num_rows; i++)
-			static_cast< QStringList* >(m_data)->replace(dest_start+i, source->textAt(source_start + i));
+			static_cast< ColumnTextData* >(m_data)->replace(dest_start+i, source->textAt(source_start + i));
 		break;
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
-		for(int i=0; i<num_rows; i++)
-			static_cast< QList<QDateTime>* >(m_data)->replace(dest_start+i, source->dateTimeAt(source_start + i));
+	case AbstractColumn::BigInt:
+		copyRawValues<qint64>(m_data, source->m_data, source_start, dest_start, num_rows);
+		break;
+	case AbstractColumn::Integer:
+		copyRawValues<int>(m_data, source->m_data, source_start, dest_start, num_rows);
+		break;
+	case AbstractColumn::Float:
+		copyRawValues<float>(m_data, source->m_data, source_start, dest_start, num_rows);
 		break;
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	endDataChange();
 
 	return true;
 }
@@ -634,13 +923,23 @@ bool ColumnPrivate::copy(const ColumnPrivate * source, int source_start, int des
 int ColumnPrivate::rowCount() const {
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric:
+		//at most ColumnMappedData::maxSize() values are mapped
+		if (m_mapped)
+			return static_cast<int>(m_mapped->size());
+		if (m_virtual)
+			return m_virtual->size();
 		return static_cast< QVector<double>* >(m_data)->size();
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
-		return static_cast< QList<QDateTime>* >(m_data)->size();
+	case AbstractColumn::BigInt:
+		return static_cast< QVector<qint64>* >(m_data)->size();
+	case AbstractColumn::Integer:
+		return static_cast< QVector<int>* >(m_data)->size();
+	case AbstractColumn::Float:
+		return static_cast< QVector<float>* >(m_data)->size();
 	case AbstractColumn::Text:
-		return static_cast< QStringList* >(m_data)->size();
+		return static_cast< ColumnTextData* >(m_data)->size();
 	}
 
 	return 0;
@@ -659,49 +958,100 @@ int ColumnPrivate::rowCount() const {
 void ColumnPrivate::resizeTo(int new_size) {
 	int old_size = rowCount();
 	if (new_size == old_size) return;
+	unmapData();
+
+	//appended rows are empty and don't change the extrema, removed rows might.
+	//Integer and BigInt have no empty value, the appended rows are 0
+	if (new_size < old_size)
+		invalidateExtrema();
+	else if (m_extremaAvailable && (m_column_mode == AbstractColumn::Integer || m_column_mode == AbstractColumn::BigInt))
+		extendExtrema(0);
 
 	switch(m_column_mode) {
-	case AbstractColumn::Numeric: {
-			QVector<double> *numeric_data = static_cast< QVector<double>* >(m_data);
-			numeric_data->insert(numeric_data->end(), new_size-old_size, NAN);
-			break;
-		}
+	case AbstractColumn::Numeric:
+		resizeVector<double>(m_data, new_size, NAN);
+		break;
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
-	case AbstractColumn::Day: {
-			int new_rows = new_size - old_size;
-			if (new_rows > 0) {
-				for(int i=0; i<new_rows; i++)
-					static_cast< QList<QDateTime>* >(m_data)->append(QDateTime());
-			} else {
-				for(int i=0; i<-new_rows; i++)
-					static_cast< QList<QDateTime>* >(m_data)->removeLast();
-			}
-			break;
-		}
-	case AbstractColumn::Text: {
-			int new_rows = new_size - old_size;
-			if (new_rows > 0) {
-				for(int i=0; i<new_rows; i++)
-					static_cast< QStringList* >(m_data)->append(QString());
-			} else {
-				for(int i=0; i<-new_rows; i++)
-					static_cast< QStringList* >(m_data)->removeLast();
-			}
-			break;
-		}
+	case AbstractColumn::Day:
+		resizeVector<qint64>(m_data, new_size, invalidDateTime);
+		break;
+	case AbstractColumn::Integer:
+		resizeVector<int>(m_data, new_size, 0);
+		break;
+	case AbstractColumn::BigInt:
+		resizeVector<qint64>(m_data, new_size, 0);
+		break;
+	case AbstractColumn::Float:
+		resizeVector<float>(m_data, new_size, NAN);
+		break;
+	case AbstractColumn::Text:
+		static_cast< ColumnTextData* >(m_data)->resize(new_size);
+		break;
 	}
 }
 
+/**
+ * \brief Resize the column to \c row_count rows and copy the rows of \c backup into the intervals \c rows
+ *
+ * The rows of \c backup are stored without gaps, i.e. the first interval
+ * is filled with the first rows of \c backup, the next interval with the following rows and so on.
+ * This is used by the undo commands that only keep the changed parts of a column.
+ * AbstractColumn::dataChanged() is emitted only once for all intervals, see Column::beginUpdate().
+ */
+void ColumnPrivate::restoreRows(int row_count, const ColumnPrivate* backup, const QList< Interval<int> >& rows) {
+	m_owner->beginUpdate();
+	if (row_count != rowCount()) {
+		beginDataChange(qMin(row_count, rowCount()), lastRow);
+		resizeTo(row_count);
+		endDataChange();
+	}
+
+	int backup_row = 0;
+	foreach (const Interval<int>& interval, rows) {
+		copy(backup, backup_row, interval.start(), interval.size());
+		backup_row += interval.size();
+	}
+	m_owner->endUpdate();
+}
+
+/**
+ * \brief Notify about the upcoming change of the rows \c first to \c last
+ *
+ * If the owner is in an update transaction (see Column::beginUpdate()) the rows are
+ * only recorded and the notifications are sent once at the end of the transaction.
+ */
+void ColumnPrivate::beginDataChange(int first, int last) {
+	if (m_owner->m_updateLevel > 0)
+		m_owner->addChangedRows(first, last);
+	else {
+		m_owner->m_changedRows = Interval<int>(first, last);
+		emit m_owner->dataAboutToChange(m_owner);
+	}
+}
+
+/**
+ * \brief Notify about the finished change started with beginDataChange()
+ */
+void ColumnPrivate::endDataChange() {
+	if (m_owner->m_updateLevel == 0)
+		m_owner->emitDataChanged();
+}
+
 /**
  * \brief Insert some empty (or initialized with zero) rows
  */
 void ColumnPrivate::insertRows(int before, int count) {
 	if (count == 0) return;
+	unmapData();
 
 	m_formulas.insertRows(before, count);
 
 	if (before <= rowCount()) {
+		//Integer and BigInt have no empty value, the inserted rows are 0
+		if (m_extremaAvailable && (m_column_mode == AbstractColumn::Integer || m_column_mode == AbstractColumn::BigInt))
+			extendExtrema(0);
+
 		switch(m_column_mode) {
 		case AbstractColumn::Numeric:
 			static_cast< QVector<double>* >(m_data)->insert(before, count, NAN);
@@ -709,12 +1059,19 @@ void ColumnPrivate::insertRows(int before, int count) {
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
-			for(int i=0; i<count; i++)
-				static_cast< QList<QDateTime>* >(m_data)->insert(before, QDateTime());
+			static_cast< QVector<qint64>* >(m_data)->insert(before, count, invalidDateTime);
+			break;
+		case AbstractColumn::Integer:
+			static_cast< QVector<int>* >(m_data)->insert(before, count, 0);
+			break;
+		case AbstractColumn::BigInt:
+			static_cast< QVector<qint64>* >(m_data)->insert(before, count, 0);
+			break;
+		case AbstractColumn::Float:
+			static_cast< QVector<float>* >(m_data)->insert(before, count, NAN);
 			break;
 		case AbstractColumn::Text:
-			for(int i=0; i<count; i++)
-				static_cast< QStringList* >(m_data)->insert(before, QString());
+			static_cast< ColumnTextData* >(m_data)->insert(before, count);
 			break;
 		}
 	}
@@ -725,10 +1082,13 @@ void ColumnPrivate::insertRows(int before, int count) {
  */
 void ColumnPrivate::removeRows(int first, int count) {
 	if (count == 0) return;
+	unmapData();
 
 	m_formulas.removeRows(first, count);
 
 	if (first < rowCount()) {
+		invalidateExtrema();
+
 		int corrected_count = count;
 		if (first + count > rowCount())
 			corrected_count = rowCount() - first;
@@ -740,12 +1100,17 @@ void ColumnPrivate::removeRows(int first, int count) {
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
-			for(int i=0; i<corrected_count; i++)
-				static_cast< QList<QDateTime>* >(m_data)->removeAt(first);
+		case AbstractColumn::BigInt:
+			static_cast< QVector<qint64>* >(m_data)->remove(first, corrected_count);
+			break;
+		case AbstractColumn::Integer:
+			static_cast< QVector<int>* >(m_data)->remove(first, corrected_count);
+			break;
+		case AbstractColumn::Float:
+			static_cast< QVector<float>* >(m_data)->remove(first, corrected_count);
 			break;
 		case AbstractColumn::Text:
-			for(int i=0; i<corrected_count; i++)
-				static_cast< QStringList* >(m_data)->removeAt(first);
+			static_cast< ColumnTextData* >(m_data)->remove(first, corrected_count);
 			break;
 		}
 	}
@@ -790,11 +1155,171 @@ void ColumnPrivate::setWidth(int value) {
 
 /**
  * \brief Return the data pointer
+ *
+ * The values of mapped and virtual columns are not kept in memory, the data is empty for them,
+ * use materialize() via ColumnMaterializeCmd before modifying it.
  */
 void *ColumnPrivate::dataPointer() const {
 	return m_data;
 }
 
+/**
+ * \brief Read the values of the Numeric column from the file \c fileName instead of keeping them in memory
+ *
+ * The file is mapped into memory, see ColumnMappedData. \c rows contiguous double values starting at
+ * byte \c offset are used as the content of the column, at most ColumnMappedData::maxSize() values.
+ * The values don't need to fit into the memory, they can't be modified then.
+ * The mapping is read-only, the values are copied into memory as soon as the column is modified,
+ * see ColumnMaterializeCmd. This is not undoable and intended to be used by the import
+ * filters for data that doesn't fit into the memory.
+ */
+bool ColumnPrivate::mapData(const QString& fileName, qint64 offset, qint64 rows) {
+	if (m_column_mode != AbstractColumn::Numeric) return false;
+
+	ColumnMappedData* mapped = new ColumnMappedData();
+	if (!mapped->map(fileName, offset, rows)) {
+		delete mapped;
+		return false;
+	}
+
+	beginDataChange(0, lastRow);
+	invalidateExtrema();
+	delete m_mapped;
+	m_mapped = mapped;
+	dropVirtualData();
+	QVector<double>* vector = static_cast< QVector<double>* >(m_data);
+	vector->clear();
+	vector->squeeze();
+	endDataChange();
+
+	return true;
+}
+
+/**
+ * \brief Return the file backed storage of the values, 0 if the values are kept in memory
+ */
+const ColumnMappedData* ColumnPrivate::mappedData() const {
+	return m_mapped;
+}
+
+/**
+ * \brief Copy the mapped or computed values into memory and close the mapped file
+ *
+ * The formula of a virtual column is kept, the values are not updated automatically anymore.
+ */
+void ColumnPrivate::unmapData() {
+	if (m_mapped) {
+		*static_cast< QVector<double>* >(m_data) = m_mapped->toVector();
+		dropMappedData();
+	} else if (m_virtual) {
+		*static_cast< QVector<double>* >(m_data) = m_virtual->toVector();
+		dropVirtualData();
+	}
+}
+
+/**
+ * \brief Copy the mapped or computed values into memory, the mapped file and the formula program are kept
+ *
+ * The ownership of the storage is passed to the caller via \c mapped and \c data (0 if not used),
+ * restoreData() reverts this. Used by ColumnMaterializeCmd.
+ */
+void ColumnPrivate::materialize(ColumnMappedData*& mapped, ColumnVirtualData*& data) {
+	mapped = m_mapped;
+	data = m_virtual;
+	if (m_mapped)
+		*static_cast< QVector<double>* >(m_data) = m_mapped->toVector();
+	else if (m_virtual)
+		*static_cast< QVector<double>* >(m_data) = m_virtual->toVector();
+	m_mapped = 0;
+	m_virtual = 0;
+}
+
+/**
+ * \brief Read the values from \c mapped or compute them from \c data again, used to undo materialize()
+ *
+ * The ownership of the storage is taken over. The source columns of a virtual column
+ * might have been modified in the meantime, its values are recomputed.
+ */
+void ColumnPrivate::restoreData(ColumnMappedData* mapped, ColumnVirtualData* data) {
+	beginDataChange(0, lastRow);
+	invalidateExtrema();
+	dropMappedData();
+	dropVirtualData();
+	m_mapped = mapped;
+	m_virtual = data;
+	if (m_virtual)
+		m_virtual->invalidate(0, lastRow);
+	QVector<double>* vector = static_cast< QVector<double>* >(m_data);
+	vector->clear();
+	vector->squeeze();
+	endDataChange();
+}
+
+void ColumnPrivate::dropMappedData() {
+	delete m_mapped;
+	m_mapped = 0;
+}
+
+/**
+ * \brief Compute the values of the Numeric column from its formula when they are accessed instead of keeping them in memory
+ *
+ * See ColumnVirtualData. The values are computed and kept in memory as soon as the column is modified,
+ * see ColumnMaterializeCmd. Use ColumnSetVirtualFormulaCmd to make this undoable.
+ */
+bool ColumnPrivate::makeVirtual() {
+	if (m_column_mode != AbstractColumn::Numeric || m_formula.isEmpty()) return false;
+
+	ColumnVirtualData* data = new ColumnVirtualData(m_owner);
+	data->setFormula(m_formula, m_formulaVariableNames, m_formulaVariableColumnPathes);
+
+	beginDataChange(0, lastRow);
+	invalidateExtrema();
+	dropMappedData();
+	delete m_virtual;
+	m_virtual = data;
+	QVector<double>* vector = static_cast< QVector<double>* >(m_data);
+	vector->clear();
+	vector->squeeze();
+	endDataChange();
+
+	return true;
+}
+
+/**
+ * \brief Keep the values \c values in memory instead of computing them, used to undo makeVirtual()
+ */
+void ColumnPrivate::replaceVirtualData(const QVector<double>& values) {
+	beginDataChange(0, lastRow);
+	invalidateExtrema();
+	dropVirtualData();
+	*static_cast< QVector<double>* >(m_data) = values;
+	endDataChange();
+}
+
+/**
+ * \brief Return the computed storage of the values, 0 if the values are kept in memory
+ */
+const ColumnVirtualData* ColumnPrivate::virtualData() const {
+	return m_virtual;
+}
+
+/**
+ * \brief Notify about the changed values of the rows \c first to \c last of a virtual column after its source columns were modified
+ */
+void ColumnPrivate::invalidateVirtualData(int first, int last) {
+	if (!m_virtual) return;
+
+	beginDataChange(first, last);
+	m_virtual->invalidate(first, last);
+	invalidateExtrema();
+	endDataChange();
+}
+
+void ColumnPrivate::dropVirtualData() {
+	delete m_virtual;
+	m_virtual = 0;
+}
+
 /**
  * \brief Return the input filter (for string -> data type conversion)
  */
@@ -827,6 +1352,16 @@ void ColumnPrivate::setFormula(const QString& formula, const QStringList& variab
 	m_formula = formula;
 	m_formulaVariableNames = variableNames;
 	m_formulaVariableColumnPathes = variableColumnPathes;
+
+	//the values of a virtual column depend on the formula
+	if (m_virtual) {
+		beginDataChange(0, lastRow);
+		m_virtual->setFormula(formula, variableNames, variableColumnPathes);
+		invalidateExtrema();
+		endDataChange();
+	}
+
+	emit m_owner->formulaChanged(m_owner);
 }
 
 /**
@@ -898,7 +1433,28 @@ void ColumnPrivate::clearFormulas() {
  */
 QString ColumnPrivate::textAt(int row) const {
 	if (m_column_mode != AbstractColumn::Text) return QString();
-	return static_cast< QStringList* >(m_data)->value(row);
+	return static_cast< ColumnTextData* >(m_data)->value(row);
+}
+
+/**
+ * \brief Return the storage of the strings
+ *
+ * Use this only when columnMode() is Text
+ */
+const ColumnTextData* ColumnPrivate::textData() const {
+	if (m_column_mode != AbstractColumn::Text) return 0;
+	return static_cast< ColumnTextData* >(m_data);
+}
+
+/**
+ * \brief Use the dictionary encoding for the strings if the column contains only few distinct values
+ *
+ * The content of the column is not changed, only the representation in memory.
+ * Returns \c true if the strings are dictionary encoded after the call.
+ */
+bool ColumnPrivate::encodeText() {
+	if (m_column_mode != AbstractColumn::Text) return false;
+	return static_cast< ColumnTextData* >(m_data)->encode();
 }
 
 /**
@@ -929,15 +1485,64 @@ QDateTime ColumnPrivate::dateTimeAt(int row) const {
 	        m_column_mode != AbstractColumn::Month &&
 	        m_column_mode != AbstractColumn::Day)
 		return QDateTime();
-	return static_cast< QList<QDateTime>* >(m_data)->value(row);
+	return msecsToDateTime(static_cast< QVector<qint64>* >(m_data)->value(row, invalidDateTime));
 }
 
 /**
  * \brief Return the double value in row 'row'
  */
 double ColumnPrivate::valueAt(int row) const {
-	if (m_column_mode != AbstractColumn::Numeric) return NAN;
-	return static_cast< QVector<double>* >(m_data)->value(row, NAN);
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		if (m_mapped)
+			return (row >= 0 && row < m_mapped->size()) ? m_mapped->value(row) : NAN;
+		if (m_virtual)
+			return m_virtual->value(row);
+		return static_cast< QVector<double>* >(m_data)->value(row, NAN);
+	case AbstractColumn::Integer:
+		return widenedValueAt<int>(m_data, row);
+	case AbstractColumn::BigInt:
+		return widenedValueAt<qint64>(m_data, row);
+	case AbstractColumn::Float:
+		return widenedValueAt<float>(m_data, row);
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	return NAN;
+}
+
+/**
+ * \brief Return the values of a numeric column as a vector of doubles
+ *
+ * For Numeric columns the data vector is shared, the values of Integer, BigInt and Float columns
+ * are widened to double. An empty vector is returned for the other modes.
+ */
+QVector<double> ColumnPrivate::numericValues() const {
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		if (m_mapped)
+			return m_mapped->toVector();
+		if (m_virtual)
+			return m_virtual->toVector();
+		return *static_cast< QVector<double>* >(m_data);
+	case AbstractColumn::Integer:
+		return widenedValues<int>(m_data);
+	case AbstractColumn::BigInt:
+		return widenedValues<qint64>(m_data);
+	case AbstractColumn::Float:
+		return widenedValues<float>(m_data);
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	return QVector<double>();
 }
 
 /**
@@ -948,13 +1553,12 @@ double ColumnPrivate::valueAt(int row) const {
 void ColumnPrivate::setTextAt(int row, const QString& new_value) {
 	if (m_column_mode != AbstractColumn::Text) return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	beginDataChange(row, row);
 	if (row >= rowCount())
 		resizeTo(row+1);
 
-	static_cast< QStringList* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	static_cast< ColumnTextData* >(m_data)->replace(row, new_value);
+	endDataChange();
 }
 
 /**
@@ -965,16 +1569,15 @@ void ColumnPrivate::setTextAt(int row, const QString& new_value) {
 void ColumnPrivate::replaceTexts(int first, const QStringList& new_values) {
 	if (m_column_mode != AbstractColumn::Text) return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	beginDataChange(first, first + new_values.size() - 1);
 	int num_rows = new_values.size();
 	if (first + num_rows > rowCount())
 		resizeTo(first + num_rows);
 
 	for(int i=0; i<num_rows; i++)
-		static_cast< QStringList* >(m_data)->replace(first+i, new_values.at(i));
+		static_cast< ColumnTextData* >(m_data)->replace(first+i, new_values.at(i));
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	endDataChange();
 }
 
 /**
@@ -1016,13 +1619,12 @@ void ColumnPrivate::setDateTimeAt(int row, const QDateTime& new_value) {
 	        m_column_mode != AbstractColumn::Day)
 		return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	beginDataChange(row, row);
 	if (row >= rowCount())
 		resizeTo(row+1);
 
-	static_cast< QList<QDateTime>* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	static_cast< QVector<qint64>* >(m_data)->replace(row, dateTimeToMSecs(new_value));
+	endDataChange();
 }
 
 /**
@@ -1036,54 +1638,375 @@ void ColumnPrivate::replaceDateTimes(int first, const QList<QDateTime>& new_valu
 	        m_column_mode != AbstractColumn::Day)
 		return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	beginDataChange(first, first + new_values.size() - 1);
 	int num_rows = new_values.size();
 	if (first + num_rows > rowCount())
 		resizeTo(first + num_rows);
 
+	qint64* ptr = static_cast< QVector<qint64>* >(m_data)->data();
 	for(int i=0; i<num_rows; i++)
-		static_cast< QList<QDateTime>* >(m_data)->replace(first+i, new_values.at(i));
+		ptr[first+i] = dateTimeToMSecs(new_values.at(i));
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	endDataChange();
 }
 
 /**
  * \brief Set the content of row 'row'
  *
- * Use this only when columnMode() is Numeric
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
  */
 void ColumnPrivate::setValueAt(int row, double new_value) {
-	if (m_column_mode != AbstractColumn::Numeric) return;
+	unmapData();
+	if (!AbstractColumn::isNumeric(m_column_mode)) return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	beginDataChange(row, row);
 	if (row >= rowCount())
 		resizeTo(row+1);
 
-	static_cast< QVector<double>* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	const double old_value = valueAt(row);
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		static_cast< QVector<double>* >(m_data)->replace(row, new_value);
+		break;
+	case AbstractColumn::Integer:
+		static_cast< QVector<int>* >(m_data)->replace(row, narrowValue<int>(new_value));
+		break;
+	case AbstractColumn::BigInt:
+		static_cast< QVector<qint64>* >(m_data)->replace(row, narrowValue<qint64>(new_value));
+		break;
+	case AbstractColumn::Float:
+		static_cast< QVector<float>* >(m_data)->replace(row, narrowValue<float>(new_value));
+		break;
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	//the cached extrema can only be kept if the overwritten value was not one of them
+	if (m_extremaAvailable) {
+		const double stored_value = valueAt(row);
+		if ( (old_value == m_minimum && !(stored_value <= m_minimum))
+			|| (old_value == m_maximum && !(stored_value >= m_maximum)) )
+			invalidateExtrema();
+		else
+			extendExtrema(stored_value);
+	}
+
+	endDataChange();
 }
 
 /**
  * \brief Replace a range of values
  *
- * Use this only when columnMode() is Numeric
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
  */
 void ColumnPrivate::replaceValues(int first, const QVector<double>& new_values) {
-	if (m_column_mode != AbstractColumn::Numeric) return;
+	unmapData();
+	if (!AbstractColumn::isNumeric(m_column_mode)) return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	beginDataChange(first, first + new_values.size() - 1);
 	int num_rows = new_values.size();
+	//appending values only extends the cached extrema, overwriting requires a new scan
+	const bool append = (first >= rowCount());
 	if (first + num_rows > rowCount())
 		resizeTo(first + num_rows);
 
-	double * ptr = static_cast< QVector<double>* >(m_data)->data();
-	for(int i=0; i<num_rows; i++)
-		ptr[first+i] = new_values.at(i);
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric: {
+			double * ptr = static_cast< QVector<double>* >(m_data)->data();
+			for(int i=0; i<num_rows; i++)
+				ptr[first+i] = new_values.at(i);
+			break;
+		}
+	case AbstractColumn::Integer:
+		replaceVectorValues<int>(m_data, first, new_values);
+		break;
+	case AbstractColumn::BigInt:
+		replaceVectorValues<qint64>(m_data, first, new_values);
+		break;
+	case AbstractColumn::Float:
+		replaceVectorValues<float>(m_data, first, new_values);
+		break;
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	if (append) {
+		if (m_extremaAvailable) {
+			for (int i=0; i<num_rows; ++i)
+				extendExtrema(valueAt(first+i));
+		}
+	} else
+		invalidateExtrema();
+
+	endDataChange();
+}
+
+/**
+ * \brief Return the smallest value of the column, NaNs are ignored
+ *
+ * The value is cached and only recalculated after the data was modified in a way
+ * that doesn't allow to update it incrementally.
+ */
+double ColumnPrivate::minimum() const {
+	if (!m_extremaAvailable)
+		updateExtrema();
+	return m_minimum;
+}
+
+/**
+ * \brief Return the largest value of the column, NaNs are ignored
+ */
+double ColumnPrivate::maximum() const {
+	if (!m_extremaAvailable)
+		updateExtrema();
+	return m_maximum;
+}
+
+/**
+ * \brief Mark the cached extrema as outdated, they will be recalculated on the next request
+ */
+void ColumnPrivate::invalidateExtrema() {
+	m_extremaAvailable = false;
+}
+
+void ColumnPrivate::updateExtrema() const {
+	double min = INFINITY;
+	double max = -INFINITY;
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		if (m_mapped) {
+			for (qint64 row = 0; row < m_mapped->size(); ++row) {
+				const double val = m_mapped->value(row);
+				if (std::isnan(val))
+					continue;
+
+				if (val < min)
+					min = val;
+				if (val > max)
+					max = val;
+			}
+		} else if (m_virtual) {
+			const QVector<double> values = m_virtual->toVector();
+			scanExtrema<double>(&values, min, max);
+		} else {
+			scanExtrema<double>(m_data, min, max);
+		}
+		break;
+	case AbstractColumn::Integer:
+		scanExtrema<int>(m_data, min, max);
+		break;
+	case AbstractColumn::BigInt:
+		scanExtrema<qint64>(m_data, min, max);
+		break;
+	case AbstractColumn::Float:
+		scanExtrema<float>(m_data, min, max);
+		break;
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	m_minimum = min;
+	m_maximum = max;
+	m_extremaAvailable = true;
+}
+
+void ColumnPrivate::extendExtrema(double value) {
+	if (std::isnan(value))
+		return;
+
+	if (value < m_minimum)
+		m_minimum = value;
+	if (value > m_maximum)
+		m_maximum = value;
+}
+
+/**
+ * \brief Value stored for invalid (empty) DateTime, Month and Day entries
+ */
+const qint64 ColumnPrivate::invalidDateTime = std::numeric_limits<qint64>::min();
+
+/**
+ * \brief Convert a QDateTime to the internal representation of DateTime, Month and Day columns
+ *
+ * The date and the time are stored as milliseconds since 1970-01-01 00:00 without any time zone
+ * or daylight saving conversion, so that the values read back are identical to the ones stored.
+ */
+qint64 ColumnPrivate::dateTimeToMSecs(const QDateTime& dateTime) {
+	if (!dateTime.isValid())
+		return invalidDateTime;
+
+	static const QDate epoch(1970, 1, 1);
+	return qint64(epoch.daysTo(dateTime.date()))*msecsPerDay + QTime(0, 0).msecsTo(dateTime.time());
+}
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+/**
+ * \brief Convert the internal representation of DateTime, Month and Day columns back to QDateTime
+ */
+QDateTime ColumnPrivate::msecsToDateTime(qint64 msecs) {
+	if (msecs == invalidDateTime)
+		return QDateTime();
+
+	qint64 days = msecs/msecsPerDay;
+	qint64 time = msecs%msecsPerDay;
+	if (time < 0) {
+		//dates before the epoch, round the day towards minus infinity
+		--days;
+		time += msecsPerDay;
+	}
+
+	static const QDate epoch(1970, 1, 1);
+	return QDateTime(epoch.addDays(days), QTime(0, 0).addMSecs(int(time)));
+}
+
+/**
+ * \brief Convert a vector in the internal DateTime representation to a list of QDateTime
+ */
+QList<QDateTime> ColumnPrivate::dateTimeList(const QVector<qint64>& values) {
+	QList<QDateTime> list;
+	list.reserve(values.size());
+	for (int i=0; i<values.size(); ++i)
+		list << msecsToDateTime(values.at(i));
+	return list;
+}
+
+/**
+ * \brief Returns the approximate number of bytes used by the values \c data of a column with the mode \c mode
+ */
+qint64 ColumnPrivate::dataSize(AbstractColumn::ColumnMode mode, const void* data) {
+	if (!data) return 0;
+
+	switch(mode) {
+	case AbstractColumn::Numeric:
+		return static_cast< const QVector<double>* >(data)->size()*(qint64)sizeof(double);
+	case AbstractColumn::Text: {
+			const ColumnTextData* text = static_cast< const ColumnTextData* >(data);
+			const QStringList strings = text->isEncoded() ? text->dictionary() : text->toStringList();
+			qint64 size = text->isEncoded() ? text->codes().size()*(qint64)sizeof(int) : 0;
+			foreach (const QString& str, strings)
+				size += sizeof(QString) + str.size()*sizeof(QChar);
+			return size;
+		}
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+	case AbstractColumn::BigInt:
+		return static_cast< const QVector<qint64>* >(data)->size()*(qint64)sizeof(qint64);
+	case AbstractColumn::Integer:
+		return static_cast< const QVector<int>* >(data)->size()*(qint64)sizeof(int);
+	case AbstractColumn::Float:
+		return static_cast< const QVector<float>* >(data)->size()*(qint64)sizeof(float);
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Serialize the values \c data of a column with the mode \c mode, e.g. to move undo data to the disk
+ *
+ * \sa readData()
+ */
+void ColumnPrivate::writeData(QDataStream& out, AbstractColumn::ColumnMode mode, const void* data) {
+	switch(mode) {
+	case AbstractColumn::Numeric:
+		out << *static_cast< const QVector<double>* >(data);
+		break;
+	case AbstractColumn::Text: {
+			const ColumnTextData* text = static_cast< const ColumnTextData* >(data);
+			out << text->isEncoded() << text->toStringList();
+			break;
+		}
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+	case AbstractColumn::BigInt:
+		out << *static_cast< const QVector<qint64>* >(data);
+		break;
+	case AbstractColumn::Integer:
+		out << *static_cast< const QVector<int>* >(data);
+		break;
+	case AbstractColumn::Float:
+		out << *static_cast< const QVector<float>* >(data);
+		break;
+	}
+}
+
+/**
+ * \brief Create the values of a column with the mode \c mode from the data written by writeData()
+ *
+ * The caller takes ownership of the returned data.
+ */
+void* ColumnPrivate::readData(QDataStream& in, AbstractColumn::ColumnMode mode) {
+	switch(mode) {
+	case AbstractColumn::Numeric: {
+			QVector<double>* data = new QVector<double>();
+			in >> *data;
+			return data;
+		}
+	case AbstractColumn::Text: {
+			bool encoded;
+			QStringList strings;
+			in >> encoded >> strings;
+			ColumnTextData* data = new ColumnTextData(strings);
+			if (encoded)
+				data->encode();
+			return data;
+		}
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+	case AbstractColumn::BigInt: {
+			QVector<qint64>* data = new QVector<qint64>();
+			in >> *data;
+			return data;
+		}
+	case AbstractColumn::Integer: {
+			QVector<int>* data = new QVector<int>();
+			in >> *data;
+			return data;
+		}
+	case AbstractColumn::Float: {
+			QVector<float>* data = new QVector<float>();
+			in >> *data;
+			return data;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Delete the values \c data of a column with the mode \c mode
+ */
+void ColumnPrivate::deleteData(AbstractColumn::ColumnMode mode, void* data) {
+	switch(mode) {
+	case AbstractColumn::Numeric:
+		delete static_cast< QVector<double>* >(data);
+		break;
+	case AbstractColumn::Text:
+		delete static_cast< ColumnTextData* >(data);
+		break;
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+	case AbstractColumn::BigInt:
+		delete static_cast< QVector<qint64>* >(data);
+		break;
+	case AbstractColumn::Integer:
+		delete static_cast< QVector<int>* >(data);
+		break;
+	case AbstractColumn::Float:
+		delete static_cast< QVector<float>* >(data);
+		break;
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
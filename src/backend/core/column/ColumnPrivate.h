@@ -32,8 +32,12 @@
 
 #include "backend/lib/IntervalAttribute.h"
 #include "backend/core/column/Column.h"
+#include "backend/core/column/ColumnMappedData.h"
+#include "backend/core/column/ColumnTextData.h"
+#include "backend/core/column/ColumnVirtualData.h"
 
 class AbstractSimpleFilter;
+class QDataStream;
 
 class ColumnPrivate: QObject {
 	Q_OBJECT
@@ -52,6 +56,7 @@ class ColumnPrivate: QObject {
 		bool copy(const ColumnPrivate * source, int source_start, int dest_start, int num_rows);
 		int rowCount() const;
 		void resizeTo(int new_size);
+		void restoreRows(int row_count, const ColumnPrivate* backup, const QList< Interval<int> >& rows);
 		void insertRows(int before, int count);
 		void removeRows(int first, int count);
 		QString name() const;
@@ -60,6 +65,15 @@ class ColumnPrivate: QObject {
 		int width() const;
 		void setWidth(int value);
 		void *dataPointer() const;
+		bool mapData(const QString& fileName, qint64 offset, qint64 rows);
+		const ColumnMappedData* mappedData() const;
+		void unmapData();
+		void materialize(ColumnMappedData*& mapped, ColumnVirtualData*& data);
+		void restoreData(ColumnMappedData* mapped, ColumnVirtualData* data);
+		bool makeVirtual();
+		void replaceVirtualData(const QVector<double>& values);
+		const ColumnVirtualData* virtualData() const;
+		void invalidateVirtualData(int first, int last);
 		AbstractSimpleFilter* inputFilter() const;
 		AbstractSimpleFilter* outputFilter() const;
 		void replaceModeData(AbstractColumn::ColumnMode mode, void * data, AbstractSimpleFilter *in_filter,
@@ -82,6 +96,8 @@ class ColumnPrivate: QObject {
 		QString textAt(int row) const;
 		void setTextAt(int row, const QString& new_value);
 		void replaceTexts(int first, const QStringList& new_values);
+		const ColumnTextData* textData() const;
+		bool encodeText();
 		QDate dateAt(int row) const;
 		void setDateAt(int row, const QDate& new_value);
 		QTime timeAt(int row) const;
@@ -90,15 +106,40 @@ class ColumnPrivate: QObject {
 		void setDateTimeAt(int row, const QDateTime& new_value);
 		void replaceDateTimes(int first, const QList<QDateTime>& new_values);
 		double valueAt(int row) const;
+		QVector<double> numericValues() const;
 		void setValueAt(int row, double new_value);
 		void replaceValues(int first, const QVector<double>& new_values);
 
+		double minimum() const;
+		double maximum() const;
+		void invalidateExtrema();
+
+		static const qint64 invalidDateTime;
+		static qint64 dateTimeToMSecs(const QDateTime&);
+		static QDateTime msecsToDateTime(qint64);
+		static QList<QDateTime> dateTimeList(const QVector<qint64>&);
+		static qint64 dataSize(AbstractColumn::ColumnMode, const void* data);
+		static void writeData(QDataStream&, AbstractColumn::ColumnMode, const void* data);
+		static void* readData(QDataStream&, AbstractColumn::ColumnMode);
+		static void deleteData(AbstractColumn::ColumnMode, void* data);
+
 		Column::ColumnStatistics statistics;
 		bool statisticsAvailable;
 
 	private:
+		static const qint64 msecsPerDay = Q_INT64_C(86400000);
+
+		void beginDataChange(int first, int last);
+		void endDataChange();
+		void updateExtrema() const;
+		void extendExtrema(double value);
+		void dropMappedData();
+		void dropVirtualData();
+
 		AbstractColumn::ColumnMode m_column_mode;
 		void* m_data;
+		ColumnMappedData* m_mapped; //file backed values of Numeric columns, 0 if the values are in m_data
+		ColumnVirtualData* m_virtual; //values of Numeric columns computed from the formula, 0 if the values are in m_data
 		AbstractSimpleFilter* m_input_filter;
 		AbstractSimpleFilter* m_output_filter;
 		QString m_formula;
@@ -108,6 +149,12 @@ class ColumnPrivate: QObject {
 		AbstractColumn::PlotDesignation m_plot_designation;
 		int m_width;
 		Column* m_owner;
+
+		//cached extrema of the numeric data, calculated on demand and kept up to date
+		//by the modifying functions as long as this is possible without a full scan
+		mutable bool m_extremaAvailable;
+		mutable double m_minimum;
+		mutable double m_maximum;
 };
 
 #endif
@@ -0,0 +1,270 @@
+/***************************************************************************
+    File                 : ColumnTextData.cpp
+    Project              : LabPlot
+    Description          : Storage of the values of Text columns
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "backend/core/column/ColumnTextData.h"
+
+//! columns with less rows are never encoded
+static const int minEncodedRowCount = 64;
+//! the dictionary encoding is used if there are at most rows/maxDictionaryFraction distinct values
+static const int maxDictionaryFraction = 4;
+
+/**
+ * \class ColumnTextData
+ * \brief Storage of the values of Text columns
+ *
+ * The values are either stored as a plain list of strings or dictionary encoded,
+ * i.e. as a table of the distinct strings together with a 32-bit index
+ * into this table for every row. The dictionary encoding is used for columns
+ * with a low cardinality (categorical data like names, units, flags etc.)
+ * and reduces the memory consumption considerably. Furthermore, sorting and comparing
+ * the values can be done on the integer codes instead of the strings.
+ *
+ * The encoding is chosen by calling encode(), the plain storage is restored
+ * with decode() or automatically as soon as the number of distinct values becomes too large.
+ *
+ * QHash doesn't distinguish between the null string and the empty string. The null string marks
+ * invalid rows however (see Column::isValid()), so it gets its own code that is not kept in the hash.
+ */
+
+ColumnTextData::ColumnTextData() : m_encoded(false), m_nullCode(-1) {
+}
+
+ColumnTextData::ColumnTextData(const QStringList& strings) : m_encoded(false), m_strings(strings), m_nullCode(-1) {
+}
+
+int ColumnTextData::size() const {
+	return m_encoded ? m_codes.size() : m_strings.size();
+}
+
+bool ColumnTextData::isEmpty() const {
+	return (size() == 0);
+}
+
+/**
+ * Returns the string in row \c row or an empty string if \c row is out of range.
+ */
+QString ColumnTextData::value(int row) const {
+	if (!m_encoded)
+		return m_strings.value(row);
+
+	if (row < 0 || row >= m_codes.size())
+		return QString();
+	return m_dictionary.at(m_codes.at(row));
+}
+
+/**
+ * Returns \c count strings starting at row \c first, all remaining strings if \c count is -1.
+ */
+QStringList ColumnTextData::mid(int first, int count) const {
+	if (!m_encoded)
+		return m_strings.mid(first, count);
+
+	const int last = (count < 0 || first + count > m_codes.size()) ? m_codes.size() : first + count;
+	QStringList list;
+	for (int i = first; i < last; ++i)
+		list << m_dictionary.at(m_codes.at(i));
+	return list;
+}
+
+QStringList ColumnTextData::toStringList() const {
+	return m_encoded ? mid(0) : m_strings;
+}
+
+void ColumnTextData::replace(int row, const QString& value) {
+	if (m_encoded) {
+		m_codes[row] = codeOf(value);
+		checkDictionarySize();
+	} else {
+		m_strings.replace(row, value);
+	}
+}
+
+void ColumnTextData::append(const QString& value) {
+	if (m_encoded) {
+		m_codes.append(codeOf(value));
+		checkDictionarySize();
+	} else {
+		m_strings.append(value);
+	}
+}
+
+ColumnTextData& ColumnTextData::operator<<(const QString& value) {
+	append(value);
+	return *this;
+}
+
+/**
+ * Inserts \c count empty strings before row \c before.
+ */
+void ColumnTextData::insert(int before, int count) {
+	if (m_encoded) {
+		m_codes.insert(before, count, codeOf(QString()));
+	} else {
+		for (int i = 0; i < count; ++i)
+			m_strings.insert(before, QString());
+	}
+}
+
+void ColumnTextData::remove(int first, int count) {
+	if (m_encoded) {
+		m_codes.remove(first, count);
+	} else {
+		for (int i = 0; i < count; ++i)
+			m_strings.removeAt(first);
+	}
+}
+
+/**
+ * Resizes the storage to \c new_size rows, new rows contain empty strings.
+ */
+void ColumnTextData::resize(int new_size) {
+	const int old_size = size();
+	if (new_size > old_size)
+		insert(old_size, new_size - old_size);
+	else if (new_size < old_size)
+		remove(new_size, old_size - new_size);
+}
+
+void ColumnTextData::clear() {
+	m_encoded = false;
+	m_strings.clear();
+	m_dictionary.clear();
+	m_dictionaryIndex.clear();
+	m_nullCode = -1;
+	m_codes.clear();
+}
+
+bool ColumnTextData::isEncoded() const {
+	return m_encoded;
+}
+
+//! switch to the dictionary encoding if the number of distinct strings is small compared to the number of rows
+/**
+ * Returns \c true if the data is dictionary encoded after the call.
+ * An already encoded storage is re-encoded which removes the strings that are not used anymore from the dictionary.
+ */
+bool ColumnTextData::encode() {
+	const int rows = size();
+	if (rows < minEncodedRowCount) {
+		decode();
+		return false;
+	}
+
+	const int maxDictionarySize = rows / maxDictionaryFraction;
+	QStringList dictionary;
+	QHash<QString, int> dictionaryIndex;
+	int nullCode = -1;
+	QVector<int> codes(rows);
+	for (int row = 0; row < rows; ++row) {
+		const QString& str = m_encoded ? m_dictionary.at(m_codes.at(row)) : m_strings.at(row);
+		if (str.isNull() && nullCode != -1) {
+			codes[row] = nullCode;
+			continue;
+		}
+
+		QHash<QString, int>::const_iterator it = dictionaryIndex.constFind(str);
+		if (!str.isNull() && it != dictionaryIndex.constEnd()) {
+			codes[row] = it.value();
+		} else {
+			if (dictionary.size() == maxDictionarySize) {
+				//too many distinct values, the plain storage needs less memory
+				decode();
+				return false;
+			}
+			codes[row] = dictionary.size();
+			if (str.isNull())
+				nullCode = dictionary.size();
+			else
+				dictionaryIndex.insert(str, dictionary.size());
+			dictionary << str;
+		}
+	}
+
+	m_strings.clear();
+	m_dictionary = dictionary;
+	m_dictionaryIndex = dictionaryIndex;
+	m_nullCode = nullCode;
+	m_codes = codes;
+	m_encoded = true;
+	return true;
+}
+
+//! switch back to the plain storage of the strings
+void ColumnTextData::decode() {
+	if (!m_encoded)
+		return;
+
+	m_strings = mid(0);
+	m_dictionary.clear();
+	m_dictionaryIndex.clear();
+	m_nullCode = -1;
+	m_codes.clear();
+	m_encoded = false;
+}
+
+/**
+ * Returns the table of the distinct strings. Only valid if isEncoded() is \c true.
+ */
+const QStringList& ColumnTextData::dictionary() const {
+	return m_dictionary;
+}
+
+/**
+ * Returns the index into dictionary() for every row. Only valid if isEncoded() is \c true.
+ * Two rows contain the same string if and only if their codes are equal,
+ * the null string and the empty string have different codes.
+ */
+const QVector<int>& ColumnTextData::codes() const {
+	return m_codes;
+}
+
+//! returns the dictionary index of \c value, the value is added to the dictionary if not available yet
+int ColumnTextData::codeOf(const QString& value) {
+	if (value.isNull()) {
+		if (m_nullCode == -1) {
+			m_nullCode = m_dictionary.size();
+			m_dictionary << QString();
+		}
+		return m_nullCode;
+	}
+
+	QHash<QString, int>::const_iterator it = m_dictionaryIndex.constFind(value);
+	if (it != m_dictionaryIndex.constEnd())
+		return it.value();
+
+	const int code = m_dictionary.size();
+	m_dictionaryIndex.insert(value, code);
+	m_dictionary << value;
+	return code;
+}
+
+//! go back to the plain storage if the dictionary became too large after modifying the data
+void ColumnTextData::checkDictionarySize() {
+	if (m_dictionary.size() > qMax(minEncodedRowCount, m_codes.size() / 2))
+		decode();
+}
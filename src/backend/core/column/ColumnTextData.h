@@ -0,0 +1,73 @@
+/***************************************************************************
+    File                 : ColumnTextData.h
+    Project              : LabPlot
+    Description          : Storage of the values of Text columns
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef COLUMNTEXTDATA_H
+#define COLUMNTEXTDATA_H
+
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+class ColumnTextData {
+	public:
+		ColumnTextData();
+		explicit ColumnTextData(const QStringList&);
+
+		int size() const;
+		bool isEmpty() const;
+		QString value(int row) const;
+		QStringList mid(int first, int count = -1) const;
+		QStringList toStringList() const;
+
+		void replace(int row, const QString&);
+		void append(const QString&);
+		ColumnTextData& operator<<(const QString&);
+		void insert(int before, int count);
+		void remove(int first, int count);
+		void resize(int new_size);
+		void clear();
+
+		bool isEncoded() const;
+		bool encode();
+		void decode();
+		const QStringList& dictionary() const;
+		const QVector<int>& codes() const;
+
+	private:
+		int codeOf(const QString&);
+		void checkDictionarySize();
+
+		bool m_encoded;
+		QStringList m_strings;
+		QStringList m_dictionary;
+		QHash<QString, int> m_dictionaryIndex;
+		int m_nullCode;
+		QVector<int> m_codes;
+};
+
+#endif
@@ -0,0 +1,340 @@
+/***************************************************************************
+    File                 : ColumnVirtualData.cpp
+    Project              : LabPlot
+    Description          : Values of Numeric columns computed from a formula on access
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "backend/core/column/ColumnVirtualData.h"
+#include "backend/core/column/Column.h"
+#include "backend/core/Project.h"
+#include "backend/gsl/ExpressionParser.h"
+#include "backend/gsl/parser.h"
+#include "backend/lib/macros.h"
+
+#include <QMutexLocker>
+#include <QSet>
+
+#include <cmath>
+
+namespace {
+//! number of rows evaluated at once on access
+const int blockSize = 4096;
+//! maximal number of evaluated blocks kept in memory
+const int cachedBlocks = 32;
+}
+
+/**
+ * \class ColumnVirtualData
+ * \brief Values of Numeric columns computed from a formula on access
+ *
+ * Derived quantities like unit conversions, normalized values or log(x) don't need to be stored
+ * in memory. The values of a virtual column are defined by the formula of the column (see Column::formula())
+ * over the columns with the pathes Column::formulaVariableColumnPathes(). The formula is compiled once and
+ * evaluated block-wise when the values are accessed via value(). Only the most recently used blocks are kept,
+ * so the memory used stays small and constant also for very large source columns.
+ * toVector() evaluates all rows in parallel for the bulk access via Column::numericView(), the result is not cached.
+ *
+ * As for the other columns, the number of rows is given by the largest source column,
+ * the rows for which not all source columns have values are NaN.
+ * The virtual data is read-only, ColumnPrivate computes the values and keeps them in memory before they are modified.
+ *
+ * The source columns can be virtual columns themselves, they are never accessed while the lock of this object is held.
+ * They are looked up in the project in resolveSources(), only in the thread of the project since the aspect tree is not
+ * thread-safe. The values can be read in any thread.
+ * A formula referring to the column itself via virtual source columns is rejected by Column::setVirtualFormula(),
+ * such a column has no rows if it becomes cyclic later (see isCyclic()).
+ */
+
+ColumnVirtualData::ColumnVirtualData(Column* owner) : m_owner(owner), m_context(0), m_program(0),
+	m_cyclic(false), m_generation(0), m_blocks(cachedBlocks) {
+}
+
+ColumnVirtualData::~ColumnVirtualData() {
+	freeProgram();
+}
+
+/**
+ * Sets the formula and the source columns, compiles the formula and looks up the source columns.
+ * Has to be called in the thread of the project.
+ */
+void ColumnVirtualData::setFormula(const QString& formula, const QStringList& variableNames, const QStringList& variableColumnPathes) {
+	{
+		QMutexLocker locker(&m_mutex);
+		freeProgram();
+		m_formula = formula;
+		m_variableNames = variableNames;
+		m_variableColumnPathes = variableColumnPathes;
+		m_blocks.clear();
+		++m_generation;
+
+		if (m_variableNames.size() == m_variableColumnPathes.size()) {
+			m_context = parser_context_new();
+			for (int n = 0; n < m_variableNames.size(); ++n)
+				m_symbols << parser_context_assign_variable(m_context, m_variableNames.at(n).toLocal8Bit().data(), 0);
+			m_program = parser_context_compile(m_context, m_formula.toLocal8Bit().data());
+		}
+	}
+
+	resolveSources();
+}
+
+int ColumnVirtualData::size() const {
+	return rows(sources());
+}
+
+/**
+ * Returns the value in the row \c row, the block containing the row is evaluated if it is not cached.
+ */
+double ColumnVirtualData::value(int row) const {
+	//the source columns are accessed without holding the lock, they can be virtual columns themselves
+	quint64 generation;
+	const QList<Column*> sources = this->sources(&generation);
+	const int count = rows(sources);
+	if (row < 0 || row >= count)
+		return NAN;
+
+	const int index = row/blockSize;
+	{
+		QMutexLocker locker(&m_mutex);
+		const QVector<double>* block = m_blocks.object(index);
+		if (block)
+			return block->at(row - index*blockSize);
+	}
+
+	QVector<double>* block = computeBlock(index, sources, count);
+	const double value = block->at(row - index*blockSize);
+
+	//the block is outdated if the formula or the source columns were changed in the meantime
+	QMutexLocker locker(&m_mutex);
+	if (m_generation == generation)
+		m_blocks.insert(index, block);
+	else
+		delete block;
+	return value;
+}
+
+/**
+ * Evaluates the formula for all rows, the rows are evaluated in parallel.
+ */
+QVector<double> ColumnVirtualData::toVector() const {
+	const QList<Column*> sources = this->sources();
+	QVector<double> values(rows(sources), NAN);
+
+	QString formula;
+	QStringList variableNames;
+	{
+		QMutexLocker locker(&m_mutex);
+		if (!m_program)
+			return values;
+		formula = m_formula;
+		variableNames = m_variableNames;
+	}
+	if (values.isEmpty())
+		return values;
+
+	//the values of Numeric source columns are shared and not copied
+	QVector< QVector<double> > sourceValues;
+	foreach (const Column* source, sources)
+		sourceValues << source->numericView().values();
+
+	QVector<QVector<double>*> xVectors;
+	for (int n = 0; n < sourceValues.size(); ++n)
+		xVectors << &sourceValues[n];
+
+	ExpressionParser::getInstance()->evaluateCartesian(formula, variableNames, xVectors, &values);
+	return values;
+}
+
+/**
+ * Drops the cached values of the rows \c first to \c last, called in the thread of the project when the source columns were changed.
+ * If all rows are invalidated, the source columns are looked up again.
+ */
+void ColumnVirtualData::invalidate(int first, int last) {
+	const int count = rows(sources());
+	if (first <= 0 && last >= count - 1) {
+		resolveSources();
+		return;
+	}
+
+	QMutexLocker locker(&m_mutex);
+	++m_generation;
+	foreach (int index, m_blocks.keys()) {
+		if (index*blockSize <= last && (index + 1)*blockSize > first)
+			m_blocks.remove(index);
+	}
+}
+
+/**
+ * Returns whether the formula of \c column with the source columns \c variableColumnPathes refers to \c column itself,
+ * directly or via the formulas of virtual source columns. Reading the values of such a column would never end.
+ * The formulas of the non-virtual source columns don't matter, their values are kept in memory.
+ */
+bool ColumnVirtualData::isCyclic(Column* column, const QStringList& variableColumnPathes) {
+	Project* project = column->project();
+	if (!project)
+		return false;
+
+	const QList<Column*> columns = project->children<Column>(AbstractAspect::Recursive);
+	QStringList pathes = variableColumnPathes;
+	QSet<const Column*> visited;
+	while (!pathes.isEmpty()) {
+		const QString path = pathes.takeFirst();
+		foreach (Column* source, columns) {
+			if (source->path() != path)
+				continue;
+
+			if (source == column)
+				return true;
+			if (source->isVirtual() && !visited.contains(source)) {
+				visited << source;
+				pathes << source->formulaVariableColumnPathes();
+			}
+			break;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Looks up the source columns by their pathes in the project of the owner and drops the cached values.
+ * Has to be called in the thread of the project, e.g. by FormulaDependencyGraph after columns were added or removed.
+ */
+void ColumnVirtualData::resolveSources() {
+	QList< QPointer<Column> > sources;
+	bool cyclic = false;
+	Project* project = m_owner->project();
+	if (project) {
+		//the formula can become cyclic after the formula of a virtual source column was changed
+		cyclic = isCyclic(m_owner, m_variableColumnPathes);
+		if (cyclic && !m_cyclic)
+			WARNING("ColumnVirtualData: the formula of the column " << m_owner->path().toStdString() << " refers to the column itself, no values are computed");
+
+		const QList<Column*> columns = cyclic ? QList<Column*>() : project->children<Column>(AbstractAspect::Recursive);
+		foreach (const QString& path, m_variableColumnPathes) {
+			Column* source = 0;
+			foreach (Column* column, columns) {
+				if (column != m_owner && column->path() == path) {
+					source = column;
+					break;
+				}
+			}
+
+			if (!source) {
+				sources.clear();
+				break;
+			}
+			sources << source;
+		}
+	}
+
+	QMutexLocker locker(&m_mutex);
+	m_sources = sources;
+	m_cyclic = cyclic;
+	m_blocks.clear();
+	++m_generation;
+}
+
+/**
+ * Returns the source columns found by resolveSources() and the current generation of the values in \c generation.
+ * An empty list is returned if not all of them exist.
+ */
+QList<Column*> ColumnVirtualData::sources(quint64* generation) const {
+	QMutexLocker locker(&m_mutex);
+	if (generation)
+		*generation = m_generation;
+
+	QList<Column*> sources;
+	foreach (const QPointer<Column>& source, m_sources) {
+		//a deleted source column is looked up again after FormulaDependencyGraph was rebuilt
+		if (!source)
+			return QList<Column*>();
+		sources << source.data();
+	}
+	return sources;
+}
+
+//! the number of rows, given by the largest source column
+int ColumnVirtualData::rows(const QList<Column*>& sources) const {
+	int count = 0;
+	foreach (const Column* source, sources) {
+		if (source->rowCount() > count)
+			count = source->rowCount();
+	}
+
+	return count;
+}
+
+//! evaluate the formula for the rows of the block \c index, the source columns are read without holding the lock
+QVector<double>* ColumnVirtualData::computeBlock(int index, const QList<Column*>& sources, int rows) const {
+	const int first = index*blockSize;
+	const int count = qMin(blockSize, rows - first);
+	QVector<double>* block = new QVector<double>(count, NAN);
+
+	//only the rows for which all source columns have values are evaluated
+	int valid = count;
+	foreach (const Column* source, sources)
+		valid = qMin(valid, source->rowCount() - first);
+	if (valid <= 0)
+		return block;
+
+	QVector< QVector<double> > sourceValues(sources.size());
+	QVector<const double*> values;
+	for (int n = 0; n < sources.size(); ++n) {
+		const Column* source = sources.at(n);
+		QVector<double>& vector = sourceValues[n];
+		vector.resize(valid);
+		for (int row = 0; row < valid; ++row)
+			vector[row] = source->valueAt(first + row);
+		values << vector.constData();
+	}
+
+	//the compiled program and its variables are shared, only the evaluation is done with the lock held
+	QMutexLocker locker(&m_mutex);
+	if (!m_program || m_symbols.size() != values.size())
+		return block;
+
+	double* y = block->data();
+	program_eval_batch(m_program, m_symbols.constData(), values.constData(), m_symbols.size(), valid, y);
+	for (int i = 0; i < valid; ++i) {
+		if (!std::isfinite(y[i]))
+			y[i] = NAN;
+	}
+
+	return block;
+}
+
+void ColumnVirtualData::freeProgram() {
+	if (m_program) {
+		program_free(m_program);
+		m_program = 0;
+	}
+	if (m_context) {
+		parser_context_free(m_context);
+		m_context = 0;
+	}
+	m_symbols.clear();
+}
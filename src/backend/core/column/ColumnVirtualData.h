@@ -0,0 +1,78 @@
+/***************************************************************************
+    File                 : ColumnVirtualData.h
+    Project              : LabPlot
+    Description          : Values of Numeric columns computed from a formula on access
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef COLUMNVIRTUALDATA_H
+#define COLUMNVIRTUALDATA_H
+
+#include <QCache>
+#include <QMutex>
+#include <QPointer>
+#include <QStringList>
+#include <QVector>
+
+class Column;
+struct parser_context;
+struct parser_program;
+struct symrec;
+
+class ColumnVirtualData {
+	public:
+		explicit ColumnVirtualData(Column* owner);
+		~ColumnVirtualData();
+
+		void setFormula(const QString& formula, const QStringList& variableNames, const QStringList& variableColumnPathes);
+		int size() const;
+		double value(int row) const;
+		QVector<double> toVector() const;
+		void invalidate(int first, int last);
+		void resolveSources();
+
+		static bool isCyclic(Column*, const QStringList& variableColumnPathes);
+
+	private:
+		QList<Column*> sources(quint64* generation = 0) const;
+		int rows(const QList<Column*>& sources) const;
+		QVector<double>* computeBlock(int index, const QList<Column*>& sources, int rows) const;
+		void freeProgram();
+
+		Column* m_owner;
+		QString m_formula;
+		QStringList m_variableNames;
+		QStringList m_variableColumnPathes;
+		parser_context* m_context;
+		parser_program* m_program;
+		QVector<symrec*> m_symbols;
+		QList< QPointer<Column> > m_sources;
+		bool m_cyclic;
+		quint64 m_generation;
+		mutable QCache<int, QVector<double> > m_blocks;
+		mutable QMutex m_mutex;
+};
+
+#endif
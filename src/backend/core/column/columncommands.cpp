@@ -31,8 +31,97 @@
 #include "columncommands.h"
 #include "ColumnPrivate.h"
 #include <KLocale>
+#include <QDataStream>
 #include <cmath>
 
+namespace {
+//! number of rows that are compared and backed up together by the copy commands
+const int backupChunkSize = 4096;
+
+//! returns \c true if row \c row of \c col contains the same value as row \c src_row of \c src
+bool sameValue(const ColumnPrivate* col, int row, const AbstractColumn* src, int src_row) {
+	switch (col->columnMode()) {
+	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float: {
+			const double value = col->valueAt(row);
+			const double src_value = src->valueAt(src_row);
+			return (value == src_value) || (std::isnan(value) && std::isnan(src_value));
+		}
+	case AbstractColumn::Text:
+		return col->textAt(row) == src->textAt(src_row);
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		return col->dateTimeAt(row) == src->dateTimeAt(src_row);
+	}
+
+	return false;
+}
+
+//! returns the rows of \c col that change when \c count rows of \c src starting at \c src_start are copied to \c dest_start
+/**
+ * The rows are compared in chunks of backupChunkSize rows, a chunk is returned completely
+ * if at least one of its rows changes. Rows beyond the end of one of the columns are always changed.
+ */
+QList< Interval<int> > changedRows(const ColumnPrivate* col, int dest_start, const AbstractColumn* src, int src_start, int count) {
+	QList< Interval<int> > rows;
+	const int col_rows = col->rowCount();
+	const int src_rows = src->rowCount();
+	for (int first = 0; first < count; first += backupChunkSize) {
+		const int last = qMin(first + backupChunkSize, count) - 1;
+		bool changed = false;
+		for (int i = first; i <= last && !changed; ++i)
+			changed = (dest_start + i >= col_rows) || (src_start + i >= src_rows)
+				|| !sameValue(col, dest_start + i, src, src_start + i);
+		if (!changed)
+			continue;
+
+		if (!rows.isEmpty() && rows.last().end() == dest_start + first - 1)
+			rows.last().setEnd(dest_start + last);
+		else
+			rows << Interval<int>(dest_start + first, dest_start + last);
+	}
+	return rows;
+}
+
+//! returns the parts of the intervals \c rows that are within the first \c row_count rows
+QList< Interval<int> > clippedRows(QList< Interval<int> > rows, int row_count) {
+	Interval<int>::restrictList(&rows, Interval<int>(0, row_count - 1));
+	return rows;
+}
+
+//! copies the rows \c rows of \c source, shifted by \c offset, without gaps into \c backup
+template <typename Source> void backupRows(ColumnPrivate* backup, const Source* source, int offset, const QList< Interval<int> >& rows) {
+	int backup_row = 0;
+	foreach (const Interval<int>& interval, rows) {
+		backup->copy(source, interval.start() + offset, backup_row, interval.size());
+		backup_row += interval.size();
+	}
+}
+
+//! returns the number of bytes used by the values of the backup column \c backup
+qint64 backupSize(const ColumnPrivate* backup) {
+	return backup ? ColumnPrivate::dataSize(backup->columnMode(), backup->dataPointer()) : 0;
+}
+
+void writeBackup(QDataStream& out, const ColumnPrivate* backup) {
+	ColumnPrivate::writeData(out, backup->columnMode(), backup->dataPointer());
+}
+
+void readBackup(QDataStream& in, ColumnPrivate* backup) {
+	backup->replaceData(ColumnPrivate::readData(in, backup->columnMode()));
+}
+
+//! free the values of the backup column \c backup after they were written to the disk
+void releaseBackup(ColumnPrivate* backup) {
+	void* data = backup->dataPointer();
+	backup->replaceData(0);
+	ColumnPrivate::deleteData(backup->columnMode(), data);
+}
+}
+
 /** ***************************************************************************
  * \class ColumnSetModeCmd
  * \brief Set the column mode
@@ -97,7 +186,7 @@
  * \brief Ctor
  */
 ColumnSetModeCmd::ColumnSetModeCmd(ColumnPrivate * col, AbstractColumn::ColumnMode mode, QUndoCommand * parent )
-: QUndoCommand( parent ), m_col(col), m_mode(mode)
+: QUndoCommand( parent ), m_col(col), m_mode(mode), m_old_data(0), m_new_data(0)
 {
 	setText(i18n("%1: change column type", col->name()));
 	m_undone = false;
@@ -108,37 +197,13 @@ ColumnSetModeCmd::ColumnSetModeCmd(ColumnPrivate * col, AbstractColumn::ColumnMo
  * \brief Dtor
  */
 ColumnSetModeCmd::~ColumnSetModeCmd() {
-	if(m_undone) {
-		if(m_new_data != m_old_data)
-			switch (m_mode) {
-				case AbstractColumn::Numeric:
-					delete static_cast< QVector<double>* >(m_new_data);
-					break;
-				case AbstractColumn::Text:
-					delete static_cast< QStringList* >(m_new_data);
-					break;
-				case AbstractColumn::DateTime:
-				case AbstractColumn::Month:
-				case AbstractColumn::Day:
-					delete static_cast< QList<QDateTime>* >(m_new_data);
-					break;
-			}
-	} else {
-		if(m_new_data != m_old_data)
-			switch (m_old_mode) {
-				case AbstractColumn::Numeric:
-					delete static_cast< QVector<double>* >(m_old_data);
-					break;
-				case AbstractColumn::Text:
-					delete static_cast< QStringList* >(m_old_data);
-					break;
-				case AbstractColumn::DateTime:
-				case AbstractColumn::Month:
-				case AbstractColumn::Day:
-					delete static_cast< QList<QDateTime>* >(m_old_data);
-					break;
-			}
-	}
+	if(m_new_data == m_old_data)
+		return;
+
+	if(m_undone)
+		ColumnPrivate::deleteData(m_mode, m_new_data);
+	else
+		ColumnPrivate::deleteData(m_old_mode, m_old_data);
 }
 
 /**
@@ -146,6 +211,7 @@ ColumnSetModeCmd::~ColumnSetModeCmd() {
  */
 void ColumnSetModeCmd::redo()
 {
+	reload();
 	if(!m_executed)
 	{
 		// save old values
@@ -176,12 +242,51 @@ void ColumnSetModeCmd::redo()
  */
 void ColumnSetModeCmd::undo()
 {
+	reload();
 	// reset to old values
 	m_col->replaceModeData(m_old_mode, m_old_data, m_old_in_filter, m_old_out_filter);
 
 	m_undone = true;
 }
 
+/**
+ * \brief Return the size of the data not used by the column, i.e. the old data or the new data if undone
+ */
+qint64 ColumnSetModeCmd::payloadSize() const
+{
+	if(!m_executed || m_new_data == m_old_data)
+		return 0;
+
+	return m_undone ? ColumnPrivate::dataSize(m_mode, m_new_data) : ColumnPrivate::dataSize(m_old_mode, m_old_data);
+}
+
+void ColumnSetModeCmd::writePayload(QDataStream& out) const
+{
+	if(m_undone)
+		ColumnPrivate::writeData(out, m_mode, m_new_data);
+	else
+		ColumnPrivate::writeData(out, m_old_mode, m_old_data);
+}
+
+void ColumnSetModeCmd::readPayload(QDataStream& in)
+{
+	if(m_undone)
+		m_new_data = ColumnPrivate::readData(in, m_mode);
+	else
+		m_old_data = ColumnPrivate::readData(in, m_old_mode);
+}
+
+void ColumnSetModeCmd::releasePayload()
+{
+	if(m_undone) {
+		ColumnPrivate::deleteData(m_mode, m_new_data);
+		m_new_data = 0;
+	} else {
+		ColumnPrivate::deleteData(m_old_mode, m_old_data);
+		m_old_data = 0;
+	}
+}
+
 /** ***************************************************************************
  * \class ColumnFullCopyCmd
  * \brief Copy a complete column
@@ -199,7 +304,7 @@ void ColumnSetModeCmd::undo()
 
 /**
  * \var ColumnFullCopyCmd::m_backup
- * \brief A backup column
+ * \brief The previous values of the changed rows
  */
 
 /**
@@ -211,11 +316,42 @@ void ColumnSetModeCmd::undo()
  * replacement without too much copying.
  */
 
+/**
+ * \var ColumnFullCopyCmd::m_new_backup
+ * \brief The new values of the changed rows
+ */
+
+/**
+ * \var ColumnFullCopyCmd::m_new_backup_owner
+ * \brief A dummy owner for the backup of the new values
+ */
+
+/**
+ * \var ColumnFullCopyCmd::m_old_rows
+ * \brief The changed rows stored in m_backup
+ */
+
+/**
+ * \var ColumnFullCopyCmd::m_new_rows
+ * \brief The changed rows stored in m_new_backup
+ */
+
+/**
+ * \var ColumnFullCopyCmd::m_old_row_count
+ * \brief Previous number of rows in the column
+ */
+
+/**
+ * \var ColumnFullCopyCmd::m_new_row_count
+ * \brief Number of rows in the column after the copy
+ */
+
 /**
  * \brief Ctor
  */
 ColumnFullCopyCmd::ColumnFullCopyCmd(ColumnPrivate * col, const AbstractColumn * src, QUndoCommand * parent )
-: QUndoCommand( parent ), m_col(col), m_src(src), m_backup(0), m_backup_owner(0)
+: QUndoCommand( parent ), m_col(col), m_src(src), m_backup(0), m_backup_owner(0), m_new_backup(0), m_new_backup_owner(0),
+	m_old_row_count(0), m_new_row_count(0)
 {
 	setText(i18n("%1: change cell values", col->name()));
 }
@@ -226,7 +362,9 @@ ColumnFullCopyCmd::ColumnFullCopyCmd(ColumnPrivate * col, const AbstractColumn *
 ColumnFullCopyCmd::~ColumnFullCopyCmd()
 {
 	delete m_backup;
+	delete m_new_backup;
 	delete m_backup_owner;
+	delete m_new_backup_owner;
 }
 
 /**
@@ -234,20 +372,26 @@ ColumnFullCopyCmd::~ColumnFullCopyCmd()
  */
 void ColumnFullCopyCmd::redo()
 {
+	reload();
 	if(m_backup == 0)
 	{
-		m_backup_owner = new Column("temp", m_src->columnMode());
-		m_backup = new ColumnPrivate(m_backup_owner, m_src->columnMode());
-		m_backup->copy(m_col);
+		// only the chunks of rows that are changed by the copy are backed up
+		m_old_row_count = m_col->rowCount();
+		m_new_row_count = m_src->rowCount();
+		const QList< Interval<int> > rows = changedRows(m_col, 0, m_src, 0, qMax(m_old_row_count, m_new_row_count));
+		m_old_rows = clippedRows(rows, m_old_row_count);
+		m_new_rows = clippedRows(rows, m_new_row_count);
+
+		m_backup_owner = new Column("temp", m_col->columnMode());
+		m_backup = new ColumnPrivate(m_backup_owner, m_col->columnMode());
+		backupRows(m_backup, m_col, 0, m_old_rows);
 		m_col->copy(m_src);
+		m_new_backup_owner = new Column("temp", m_col->columnMode());
+		m_new_backup = new ColumnPrivate(m_new_backup_owner, m_col->columnMode());
+		backupRows(m_new_backup, m_col, 0, m_new_rows);
 	}
 	else
-	{
-		// swap data of orig. column and backup
-		void * data_temp = m_col->dataPointer();
-		m_col->replaceData(m_backup->dataPointer());
-		m_backup->replaceData(data_temp);
-	}
+		m_col->restoreRows(m_new_row_count, m_new_backup, m_new_rows);
 }
 
 /**
@@ -255,10 +399,31 @@ void ColumnFullCopyCmd::redo()
  */
 void ColumnFullCopyCmd::undo()
 {
-	// swap data of orig. column and backup
-	void * data_temp = m_col->dataPointer();
-	m_col->replaceData(m_backup->dataPointer());
-	m_backup->replaceData(data_temp);
+	reload();
+	m_col->restoreRows(m_old_row_count, m_backup, m_old_rows);
+}
+
+qint64 ColumnFullCopyCmd::payloadSize() const
+{
+	return backupSize(m_backup) + backupSize(m_new_backup);
+}
+
+void ColumnFullCopyCmd::writePayload(QDataStream& out) const
+{
+	writeBackup(out, m_backup);
+	writeBackup(out, m_new_backup);
+}
+
+void ColumnFullCopyCmd::readPayload(QDataStream& in)
+{
+	readBackup(in, m_backup);
+	readBackup(in, m_new_backup);
+}
+
+void ColumnFullCopyCmd::releasePayload()
+{
+	releaseBackup(m_backup);
+	releaseBackup(m_new_backup);
 }
 
 /** ***************************************************************************
@@ -278,12 +443,12 @@ void ColumnFullCopyCmd::undo()
 
 /**
  * \var ColumnPartialCopyCmd::m_col_backup
- * \brief A backup of the original column
+ * \brief The previous values of the changed rows
  */
 
 /**
  * \var ColumnPartialCopyCmd::m_src_backup
- * \brief A backup of the source column
+ * \brief The values of the source column copied into the changed rows
  */
 
 /**
@@ -319,16 +484,32 @@ void ColumnFullCopyCmd::undo()
  * \brief Number of rows to copy
  */
 
+/**
+ * \var ColumnPartialCopyCmd::m_old_rows
+ * \brief The changed rows stored in m_col_backup
+ */
+
+/**
+ * \var ColumnPartialCopyCmd::m_new_rows
+ * \brief The changed rows stored in m_src_backup
+ */
+
 /**
  * \var ColumnPartialCopyCmd::m_old_row_count
  * \brief Previous number of rows in the destination column
  */
 
+/**
+ * \var ColumnPartialCopyCmd::m_new_row_count
+ * \brief Number of rows in the destination column after the copy
+ */
+
 /**
  * \brief Ctor
  */
 ColumnPartialCopyCmd::ColumnPartialCopyCmd(ColumnPrivate * col, const AbstractColumn * src, int src_start, int dest_start, int num_rows, QUndoCommand * parent )
-: QUndoCommand( parent ), m_col(col), m_src(src), m_col_backup(0), m_src_backup(0), m_col_backup_owner(0), m_src_backup_owner(0), m_src_start(src_start), m_dest_start(dest_start), m_num_rows(num_rows)
+: QUndoCommand( parent ), m_col(col), m_src(src), m_col_backup(0), m_src_backup(0), m_col_backup_owner(0), m_src_backup_owner(0), m_src_start(src_start), m_dest_start(dest_start), m_num_rows(num_rows),
+	m_old_row_count(0), m_new_row_count(0)
 {
 	setText(i18n("%1: change cell values", col->name()));
 }
@@ -349,18 +530,23 @@ ColumnPartialCopyCmd::~ColumnPartialCopyCmd()
  */
 void ColumnPartialCopyCmd::redo()
 {
+	reload();
 	if(m_src_backup == 0)
 	{
-		// copy the relevant rows of source and destination column into backup columns
+		// copy the chunks of rows that are changed by the copy from source and destination column into backup columns
+		m_old_row_count = m_col->rowCount();
+		m_new_row_count = qMax(m_old_row_count, m_dest_start + m_num_rows);
+		m_new_rows = changedRows(m_col, m_dest_start, m_src, m_src_start, m_num_rows);
+		m_old_rows = clippedRows(m_new_rows, m_old_row_count);
+
 		m_src_backup_owner = new Column("temp", m_col->columnMode());
 		m_src_backup = new ColumnPrivate(m_src_backup_owner, m_col->columnMode());
-		m_src_backup->copy(m_src, m_src_start, 0, m_num_rows);
+		backupRows(m_src_backup, m_src, m_src_start - m_dest_start, m_new_rows);
 		m_col_backup_owner = new Column("temp", m_col->columnMode());
 		m_col_backup = new ColumnPrivate(m_col_backup_owner, m_col->columnMode());
-		m_col_backup->copy(m_col, m_dest_start, 0, m_num_rows);
-		m_old_row_count = m_col->rowCount();
+		backupRows(m_col_backup, m_col, 0, m_old_rows);
 	}
-	m_col->copy(m_src_backup, 0, m_dest_start, m_num_rows);
+	m_col->restoreRows(m_new_row_count, m_src_backup, m_new_rows);
 }
 
 /**
@@ -368,9 +554,31 @@ void ColumnPartialCopyCmd::redo()
  */
 void ColumnPartialCopyCmd::undo()
 {
-	m_col->copy(m_col_backup, 0, m_dest_start, m_num_rows);
-	m_col->resizeTo(m_old_row_count);
-	m_col->replaceData(m_col->dataPointer());
+	reload();
+	m_col->restoreRows(m_old_row_count, m_col_backup, m_old_rows);
+}
+
+qint64 ColumnPartialCopyCmd::payloadSize() const
+{
+	return backupSize(m_col_backup) + backupSize(m_src_backup);
+}
+
+void ColumnPartialCopyCmd::writePayload(QDataStream& out) const
+{
+	writeBackup(out, m_col_backup);
+	writeBackup(out, m_src_backup);
+}
+
+void ColumnPartialCopyCmd::readPayload(QDataStream& in)
+{
+	readBackup(in, m_col_backup);
+	readBackup(in, m_src_backup);
+}
+
+void ColumnPartialCopyCmd::releasePayload()
+{
+	releaseBackup(m_col_backup);
+	releaseBackup(m_src_backup);
 }
 
 /** ***************************************************************************
@@ -450,7 +658,7 @@ void ColumnInsertRowsCmd::undo()
  * \brief Ctor
  */
 ColumnRemoveRowsCmd::ColumnRemoveRowsCmd(ColumnPrivate * col, int first, int count, QUndoCommand * parent )
-: QUndoCommand(parent), m_col(col), m_first(first), m_count(count), m_backup(0)
+: QUndoCommand(parent), m_col(col), m_first(first), m_count(count), m_backup(0), m_backup_owner(0)
 {
 }
 
@@ -468,6 +676,7 @@ ColumnRemoveRowsCmd::~ColumnRemoveRowsCmd()
  */
 void ColumnRemoveRowsCmd::redo()
 {
+	reload();
 	if(m_backup == 0)
 	{
 		if(m_first >= m_col->rowCount())
@@ -491,12 +700,33 @@ void ColumnRemoveRowsCmd::redo()
  */
 void ColumnRemoveRowsCmd::undo()
 {
+	reload();
 	m_col->insertRows(m_first, m_count);
 	m_col->copy(m_backup, 0, m_first, m_data_row_count);
 	m_col->resizeTo(m_old_size);
 	m_col->replaceFormulas(m_formulas);
 }
 
+qint64 ColumnRemoveRowsCmd::payloadSize() const
+{
+	return backupSize(m_backup);
+}
+
+void ColumnRemoveRowsCmd::writePayload(QDataStream& out) const
+{
+	writeBackup(out, m_backup);
+}
+
+void ColumnRemoveRowsCmd::readPayload(QDataStream& in)
+{
+	readBackup(in, m_backup);
+}
+
+void ColumnRemoveRowsCmd::releasePayload()
+{
+	releaseBackup(m_backup);
+}
+
 /** ***************************************************************************
  * \class ColumnSetPlotDesignationCmd
  * \brief Sets a column's plot designation
@@ -568,6 +798,14 @@ void ColumnSetPlotDesignationCmd::undo()
  * \brief Status flag
  */
 
+/**
+ * \var ColumnClearCmd::m_mode
+ * \brief The mode of the column when it was cleared, the mode of the old and the empty data
+ *
+ * The column can be converted to another mode by later commands while the data of this command
+ * is kept or moved to the disk, so the mode of the column must not be used for the data of the command.
+ */
+
 /**
  * \brief Ctor
  */
@@ -575,6 +813,7 @@ ColumnClearCmd::ColumnClearCmd(ColumnPrivate * col, QUndoCommand * parent )
 : QUndoCommand( parent ), m_col(col)
 {
 	setText(i18n("%1: clear column", col->name()));
+	m_mode = col->columnMode();
 	m_empty_data = 0;
 	m_data = 0;
 	m_undone = false;
@@ -585,37 +824,10 @@ ColumnClearCmd::ColumnClearCmd(ColumnPrivate * col, QUndoCommand * parent )
  */
 ColumnClearCmd::~ColumnClearCmd()
 {
-	if(m_undone) {
-		if (!m_empty_data) return;
-		switch(m_col->columnMode()) {
-			case AbstractColumn::Numeric:
-				delete static_cast< QVector<double>* >(m_empty_data);
-				break;
-			case AbstractColumn::Text:
-				delete static_cast< QStringList* >(m_empty_data);
-				break;
-			case AbstractColumn::DateTime:
-			case AbstractColumn::Month:
-			case AbstractColumn::Day:
-				delete static_cast< QList<QDateTime>* >(m_empty_data);
-				break;
-		}
-	} else {
-		if (!m_data) return;
-		switch(m_col->columnMode()) {
-			case AbstractColumn::Numeric:
-				delete static_cast< QVector<double>* >(m_data);
-				break;
-			case AbstractColumn::Text:
-				delete static_cast< QStringList* >(m_data);
-				break;
-			case AbstractColumn::DateTime:
-			case AbstractColumn::Month:
-			case AbstractColumn::Day:
-				delete static_cast< QList<QDateTime>* >(m_data);
-				break;
-		}
-	}
+	if(m_undone)
+		ColumnPrivate::deleteData(m_mode, m_empty_data);
+	else
+		ColumnPrivate::deleteData(m_mode, m_data);
 }
 
 /**
@@ -623,9 +835,11 @@ ColumnClearCmd::~ColumnClearCmd()
  */
 void ColumnClearCmd::redo()
 {
+	reload();
 	if(!m_empty_data) {
 		const int rowCount = m_col->rowCount();
-		switch(m_col->columnMode()) {
+		m_mode = m_col->columnMode();
+		switch(m_mode) {
 			case AbstractColumn::Numeric:
 			{
 				QVector<double>* vec = new QVector<double>(rowCount);
@@ -638,15 +852,25 @@ void ColumnClearCmd::redo()
 			case AbstractColumn::DateTime:
 			case AbstractColumn::Month:
 			case AbstractColumn::Day:
-				m_empty_data = new QList<QDateTime>();
-				for(int i=0; i<rowCount; i++)
-					static_cast< QList<QDateTime> *>(m_empty_data)->append(QDateTime());
+				m_empty_data = new QVector<qint64>(rowCount, ColumnPrivate::invalidDateTime);
+				break;
+			case AbstractColumn::Integer:
+				m_empty_data = new QVector<int>(rowCount);
+				break;
+			case AbstractColumn::BigInt:
+				m_empty_data = new QVector<qint64>(rowCount);
+				break;
+			case AbstractColumn::Float:
+				m_empty_data = new QVector<float>(rowCount, NAN);
 				break;
 			case AbstractColumn::Text:
-				m_empty_data = new QStringList();
-				for(int i=0; i<rowCount; i++)
-					static_cast< QStringList *>(m_empty_data)->append(QString());
+			{
+				ColumnTextData* data = new ColumnTextData();
+				data->resize(rowCount);
+				data->encode();
+				m_empty_data = data;
 				break;
+			}
 		}
 		m_data = m_col->dataPointer();
 	}
@@ -659,10 +883,43 @@ void ColumnClearCmd::redo()
  */
 void ColumnClearCmd::undo()
 {
+	reload();
 	m_col->replaceData(m_data);
 	m_undone = true;
 }
 
+/**
+ * \brief Return the size of the data not used by the column, i.e. the old data or the empty data if undone
+ */
+qint64 ColumnClearCmd::payloadSize() const
+{
+	return ColumnPrivate::dataSize(m_mode, m_undone ? m_empty_data : m_data);
+}
+
+void ColumnClearCmd::writePayload(QDataStream& out) const
+{
+	ColumnPrivate::writeData(out, m_mode, m_undone ? m_empty_data : m_data);
+}
+
+void ColumnClearCmd::readPayload(QDataStream& in)
+{
+	if(m_undone)
+		m_empty_data = ColumnPrivate::readData(in, m_mode);
+	else
+		m_data = ColumnPrivate::readData(in, m_mode);
+}
+
+void ColumnClearCmd::releasePayload()
+{
+	if(m_undone) {
+		ColumnPrivate::deleteData(m_mode, m_empty_data);
+		m_empty_data = 0;
+	} else {
+		ColumnPrivate::deleteData(m_mode, m_data);
+		m_data = 0;
+	}
+}
+
 
 /** ***************************************************************************
  * \class ColumSetGlobalFormulaCmd
@@ -688,6 +945,91 @@ void ColumnSetGlobalFormulaCmd::undo() {
 	m_col->setFormula(m_formula, m_variableNames, m_variableColumnPathes);
 }
 
+/** ***************************************************************************
+ * \class ColumnSetVirtualFormulaCmd
+ * \brief Set the formula for the entire column and compute the values from it on access
+ *
+ * The values kept in memory before are restored on undo.
+ ** ***************************************************************************/
+ColumnSetVirtualFormulaCmd::ColumnSetVirtualFormulaCmd(ColumnPrivate* col, const QString& formula, const QStringList& variableNames, const QStringList& variableColumns)
+: QUndoCommand(), m_col(col), m_newFormula(formula), m_newVariableNames(variableNames), m_newVariableColumnPathes(variableColumns),
+	m_virtual(false), m_copied(false) {
+	setText(i18n("%1: compute values from formula", col->name()));
+}
+
+void ColumnSetVirtualFormulaCmd::redo() {
+	reload();
+	if(!m_copied) {
+		m_formula = m_col->formula();
+		m_variableNames = m_col->formulaVariableNames();
+		m_variableColumnPathes = m_col->formulaVariableColumnPathes();
+		m_virtual = (m_col->virtualData() != 0);
+		if (!m_virtual)
+			m_values = m_col->numericValues();
+		m_copied = true;
+	}
+
+	m_col->setFormula(m_newFormula, m_newVariableNames, m_newVariableColumnPathes);
+	m_col->makeVirtual();
+}
+
+void ColumnSetVirtualFormulaCmd::undo() {
+	reload();
+	m_col->setFormula(m_formula, m_variableNames, m_variableColumnPathes);
+	if (!m_virtual)
+		m_col->replaceVirtualData(m_values);
+}
+
+/**
+ * \brief Return the size of the values kept in memory before the column was made virtual
+ */
+qint64 ColumnSetVirtualFormulaCmd::payloadSize() const {
+	return m_values.size()*(qint64)sizeof(double);
+}
+
+void ColumnSetVirtualFormulaCmd::writePayload(QDataStream& out) const {
+	out << m_values;
+}
+
+void ColumnSetVirtualFormulaCmd::readPayload(QDataStream& in) {
+	in >> m_values;
+}
+
+void ColumnSetVirtualFormulaCmd::releasePayload() {
+	m_values = QVector<double>();
+}
+
+/** ***************************************************************************
+ * \class ColumnMaterializeCmd
+ * \brief Keep the values of a mapped or virtual column in memory
+ *
+ * Executed before the values are modified. The mapped file or the formula
+ * program is kept to read or to compute the values again on undo.
+ ** ***************************************************************************/
+ColumnMaterializeCmd::ColumnMaterializeCmd(ColumnPrivate* col, QUndoCommand* parent)
+: QUndoCommand(parent), m_col(col), m_mapped(0), m_virtual(0), m_materialized(false) {
+	setText(i18n("%1: keep values in memory", col->name()));
+}
+
+ColumnMaterializeCmd::~ColumnMaterializeCmd() {
+	if (m_materialized) {
+		delete m_mapped;
+		delete m_virtual;
+	}
+}
+
+void ColumnMaterializeCmd::redo() {
+	m_col->materialize(m_mapped, m_virtual);
+	m_materialized = true;
+}
+
+void ColumnMaterializeCmd::undo() {
+	m_col->restoreData(m_mapped, m_virtual);
+	m_mapped = 0;
+	m_virtual = 0;
+	m_materialized = false;
+}
+
 
 /** ***************************************************************************
  * \class ColumSetFormulaCmd
@@ -1023,7 +1365,7 @@ void ColumnReplaceTextsCmd::redo()
 {
 	if(!m_copied)
 	{
-		m_old_values = static_cast< QStringList* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
+		m_old_values = static_cast< ColumnTextData* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
 		m_row_count = m_col->rowCount();
 		m_copied = true;
 	}
@@ -1090,9 +1432,10 @@ ColumnReplaceValuesCmd::ColumnReplaceValuesCmd(ColumnPrivate * col, int first, c
  */
 void ColumnReplaceValuesCmd::redo()
 {
+	reload();
 	if(!m_copied)
 	{
-		m_old_values = static_cast< QVector<double>* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
+		m_old_values = m_col->numericValues().mid(m_first, m_new_values.count());
 		m_row_count = m_col->rowCount();
 		m_copied = true;
 	}
@@ -1104,11 +1447,33 @@ void ColumnReplaceValuesCmd::redo()
  */
 void ColumnReplaceValuesCmd::undo()
 {
+	reload();
 	m_col->replaceValues(m_first, m_old_values);
 	m_col->resizeTo(m_row_count);
 	m_col->replaceData(m_col->dataPointer());
 }
 
+qint64 ColumnReplaceValuesCmd::payloadSize() const
+{
+	return (m_new_values.size() + m_old_values.size())*(qint64)sizeof(double);
+}
+
+void ColumnReplaceValuesCmd::writePayload(QDataStream& out) const
+{
+	out << m_new_values << m_old_values;
+}
+
+void ColumnReplaceValuesCmd::readPayload(QDataStream& in)
+{
+	in >> m_new_values >> m_old_values;
+}
+
+void ColumnReplaceValuesCmd::releasePayload()
+{
+	m_new_values = QVector<double>();
+	m_old_values = QVector<double>();
+}
+
 /** ***************************************************************************
  * \class ColumnReplaceDateTimesCmd
  * \brief Replace a range of date-times in a date-time column
@@ -1161,7 +1526,9 @@ void ColumnReplaceDateTimesCmd::redo()
 {
 	if(!m_copied)
 	{
-		m_old_values = static_cast< QList<QDateTime>* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
+		const int last = qMin(m_first + m_new_values.count(), m_col->rowCount());
+		for (int i=m_first; i<last; ++i)
+			m_old_values << m_col->dateTimeAt(i);
 		m_row_count = m_col->rowCount();
 		m_copied = true;
 	}
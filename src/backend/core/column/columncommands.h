@@ -33,14 +33,17 @@
 
 #include "backend/lib/IntervalAttribute.h"
 #include "backend/core/column/Column.h"
+#include "backend/lib/SpillableUndoCommand.h"
 
 #include <QUndoCommand>
 #include <QStringList>
 #include <QDateTime>
 
 class AbstractSimpleFilter;
+class ColumnMappedData;
+class ColumnVirtualData;
 
-class ColumnSetModeCmd : public QUndoCommand
+class ColumnSetModeCmd : public QUndoCommand, public SpillableUndoCommand
 {
 public:
 	explicit ColumnSetModeCmd(ColumnPrivate* col, AbstractColumn::ColumnMode mode, QUndoCommand* parent = 0);
@@ -49,6 +52,13 @@ public:
 	virtual void redo();
 	virtual void undo();
 
+	virtual qint64 payloadSize() const;
+
+protected:
+	virtual void writePayload(QDataStream&) const;
+	virtual void readPayload(QDataStream&);
+	virtual void releasePayload();
+
 private:
 	ColumnPrivate* m_col;
 	AbstractColumn::ColumnMode m_old_mode;
@@ -63,7 +73,7 @@ private:
 	bool m_executed;
 };
 
-class ColumnFullCopyCmd : public QUndoCommand
+class ColumnFullCopyCmd : public QUndoCommand, public SpillableUndoCommand
 {
 public:
 	explicit ColumnFullCopyCmd(ColumnPrivate* col, const AbstractColumn* src, QUndoCommand* parent = 0);
@@ -72,15 +82,27 @@ public:
 	virtual void redo();
 	virtual void undo();
 
+	virtual qint64 payloadSize() const;
+
+protected:
+	virtual void writePayload(QDataStream&) const;
+	virtual void readPayload(QDataStream&);
+	virtual void releasePayload();
+
 private:
 	ColumnPrivate* m_col;
 	const AbstractColumn * m_src;
 	ColumnPrivate* m_backup;
 	Column * m_backup_owner;
-
+	ColumnPrivate* m_new_backup;
+	Column * m_new_backup_owner;
+	QList< Interval<int> > m_old_rows;
+	QList< Interval<int> > m_new_rows;
+	int m_old_row_count;
+	int m_new_row_count;
 };
 
-class ColumnPartialCopyCmd : public QUndoCommand
+class ColumnPartialCopyCmd : public QUndoCommand, public SpillableUndoCommand
 {
 public:
 	explicit ColumnPartialCopyCmd(ColumnPrivate* col, const AbstractColumn* src, int src_start, int dest_start, int num_rows, QUndoCommand* parent = 0);
@@ -89,6 +111,13 @@ public:
 	virtual void redo();
 	virtual void undo();
 
+	virtual qint64 payloadSize() const;
+
+protected:
+	virtual void writePayload(QDataStream&) const;
+	virtual void readPayload(QDataStream&);
+	virtual void releasePayload();
+
 private:
 	ColumnPrivate* m_col;
 	const AbstractColumn * m_src;
@@ -99,7 +128,10 @@ private:
 	int m_src_start;
 	int m_dest_start;
 	int m_num_rows;
+	QList< Interval<int> > m_old_rows;
+	QList< Interval<int> > m_new_rows;
 	int m_old_row_count;
+	int m_new_row_count;
 };
 
 class ColumnInsertRowsCmd : public QUndoCommand
@@ -115,7 +147,7 @@ private:
 	int m_before, m_count;
 };
 
-class ColumnRemoveRowsCmd : public QUndoCommand
+class ColumnRemoveRowsCmd : public QUndoCommand, public SpillableUndoCommand
 {
 public:
 	explicit ColumnRemoveRowsCmd(ColumnPrivate* col, int first, int count, QUndoCommand* parent = 0);
@@ -124,6 +156,13 @@ public:
 	virtual void redo();
 	virtual void undo();
 
+	virtual qint64 payloadSize() const;
+
+protected:
+	virtual void writePayload(QDataStream&) const;
+	virtual void readPayload(QDataStream&);
+	virtual void releasePayload();
+
 private:
 	ColumnPrivate* m_col;
 	int m_first, m_count;
@@ -148,7 +187,7 @@ private:
 	AbstractColumn::PlotDesignation m_old_pd;
 };
 
-class ColumnClearCmd : public QUndoCommand
+class ColumnClearCmd : public QUndoCommand, public SpillableUndoCommand
 {
 public:
 	explicit ColumnClearCmd(ColumnPrivate* col, QUndoCommand* parent = 0);
@@ -157,11 +196,19 @@ public:
 	virtual void redo();
 	virtual void undo();
 
+	virtual qint64 payloadSize() const;
+
+protected:
+	virtual void writePayload(QDataStream&) const;
+	virtual void readPayload(QDataStream&);
+	virtual void releasePayload();
+
 private:
 	ColumnPrivate* m_col;
 	void * m_data;
 	void * m_empty_data;
 	bool m_undone;
+	AbstractColumn::ColumnMode m_mode;
 
 };
 
@@ -183,6 +230,47 @@ private:
 	bool m_copied;
 };
 
+class ColumnSetVirtualFormulaCmd : public QUndoCommand, public SpillableUndoCommand {
+public:
+	explicit ColumnSetVirtualFormulaCmd(ColumnPrivate* col, const QString& formula, const QStringList& variableNames, const QStringList& variableColumnPathes);
+
+	virtual void redo();
+	virtual void undo();
+
+	virtual qint64 payloadSize() const;
+
+protected:
+	virtual void writePayload(QDataStream&) const;
+	virtual void readPayload(QDataStream&);
+	virtual void releasePayload();
+
+private:
+	ColumnPrivate* m_col;
+	QString m_formula;
+	QStringList m_variableNames;
+	QStringList m_variableColumnPathes;
+	QString m_newFormula;
+	QStringList m_newVariableNames;
+	QStringList m_newVariableColumnPathes;
+	QVector<double> m_values;
+	bool m_virtual;
+	bool m_copied;
+};
+
+class ColumnMaterializeCmd : public QUndoCommand {
+public:
+	explicit ColumnMaterializeCmd(ColumnPrivate* col, QUndoCommand* parent = 0);
+	~ColumnMaterializeCmd();
+
+	virtual void redo();
+	virtual void undo();
+
+private:
+	ColumnPrivate* m_col;
+	ColumnMappedData* m_mapped;
+	ColumnVirtualData* m_virtual;
+	bool m_materialized;
+};
 
 class ColumnSetFormulaCmd : public QUndoCommand
 {
@@ -281,7 +369,7 @@ private:
 	int m_row_count;
 };
 
-class ColumnReplaceValuesCmd : public QUndoCommand
+class ColumnReplaceValuesCmd : public QUndoCommand, public SpillableUndoCommand
 {
 public:
 	explicit ColumnReplaceValuesCmd(ColumnPrivate* col, int first, const QVector<double>& new_values, QUndoCommand* parent = 0);
@@ -289,6 +377,13 @@ public:
 	virtual void redo();
 	virtual void undo();
 
+	virtual qint64 payloadSize() const;
+
+protected:
+	virtual void writePayload(QDataStream&) const;
+	virtual void readPayload(QDataStream&);
+	virtual void releasePayload();
+
 private:
 	ColumnPrivate* m_col;
 	int m_first;
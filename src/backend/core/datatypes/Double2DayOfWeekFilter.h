@@ -61,7 +61,7 @@ class Double2DayOfWeekFilter : public AbstractSimpleFilter
 	protected:
 		//! Using typed ports: only double inputs are accepted.
 		virtual bool inputAcceptable(int, const AbstractColumn *source) {
-			return source->columnMode() == AbstractColumn::Numeric;
+			return AbstractColumn::isNumeric(source->columnMode());
 		}
 };
 
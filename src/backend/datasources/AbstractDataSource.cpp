@@ -55,10 +55,11 @@ void AbstractDataSource::clear() {
 }
 
 /*!
-	resize data source to cols columns
+	resize data source to cols columns with the column mode \c columnMode
 	returns column offset depending on import mode
 */
-int AbstractDataSource::resize(AbstractFileFilter::ImportMode mode, QStringList colNameList, int cols) {
+int AbstractDataSource::resize(AbstractFileFilter::ImportMode mode, QStringList colNameList, int cols,
+							   AbstractColumn::ColumnMode columnMode) {
 	// name additional columns
 	for (int k=colNameList.size(); k<cols; k++ )
 		colNameList.append( "Column " + QString::number(k+1) );
@@ -69,14 +70,14 @@ int AbstractDataSource::resize(AbstractFileFilter::ImportMode mode, QStringList
         if (mode==AbstractFileFilter::Append){
                 columnOffset=childCount<Column>();
                 for ( int n=0; n<cols; n++ ){
-                        newColumn = new Column(colNameList.at(n), AbstractColumn::Numeric);
+                        newColumn = new Column(colNameList.at(n), columnMode);
                         newColumn->setUndoAware(false);
                         addChildFast(newColumn);
                 }
 	}else if (mode==AbstractFileFilter::Prepend){
                 Column* firstColumn = child<Column>(0);
                 for ( int n=0; n<cols; n++ ){
-                        newColumn = new Column(colNameList.at(n), AbstractColumn::Numeric);
+                        newColumn = new Column(colNameList.at(n), columnMode);
                         newColumn->setUndoAware(false);
                         insertChildBeforeFast(newColumn, firstColumn);
                 }
@@ -94,7 +95,7 @@ int AbstractDataSource::resize(AbstractFileFilter::ImportMode mode, QStringList
                         //rename the columns, that are already available
                         for (int i=0; i<cols; i++){
                                 child<Column>(i)->setUndoAware(false);
-                                child<Column>(i)->setColumnMode( AbstractColumn::Numeric);
+                                child<Column>(i)->setColumnMode(columnMode);
                                 child<Column>(i)->setName(colNameList.at(i));
                                 child<Column>(i)->setSuppressDataChangedSignal(true);
                         }
@@ -102,14 +103,14 @@ int AbstractDataSource::resize(AbstractFileFilter::ImportMode mode, QStringList
                         //rename the columns, that are already available
                         for (int i=0; i<columns; i++){
                                 child<Column>(i)->setUndoAware(false);
-                                child<Column>(i)->setColumnMode( AbstractColumn::Numeric);
+                                child<Column>(i)->setColumnMode(columnMode);
                                 child<Column>(i)->setName(colNameList.at(i));
                                 child<Column>(i)->setSuppressDataChangedSignal(true);
                         }
 
                         //create additional columns if needed
                         for(int i=columns; i < cols; i++) {
-                                newColumn = new Column(colNameList.at(i), AbstractColumn::Numeric);
+                                newColumn = new Column(colNameList.at(i), columnMode);
                                 newColumn->setUndoAware(false);
                                 addChildFast(newColumn);
                                 child<Column>(i)->setSuppressDataChangedSignal(true);
@@ -186,3 +187,53 @@ int AbstractDataSource::create(QVector<QVector<double>*>& dataPointers, Abstract
 
 	return columnOffset;
 }
+
+/*!
+	prepares the spreadsheet for the import of \c actualCols columns with the numeric column mode \c columnMode.
+	In contrast to the function above the data is stored in its native width, the pointers to the data vectors
+	(QVector<int>, QVector<qint64>, QVector<float> or QVector<double> depending on \c columnMode) are returned in \c dataPointers.
+	Only spreadsheets are supported, matrices always store double values.
+*/
+int AbstractDataSource::create(QVector<void*>& dataPointers, AbstractFileFilter::ImportMode mode,
+							   int actualRows, int actualCols, AbstractColumn::ColumnMode columnMode) {
+	Spreadsheet* spreadsheet = dynamic_cast<Spreadsheet*>(this);
+	Q_ASSERT(spreadsheet);
+	setUndoAware(false);
+
+	int columnOffset = this->resize(mode, QStringList(), actualCols, columnMode);
+
+	// resize the spreadsheet
+	if (mode == AbstractFileFilter::Replace) {
+		spreadsheet->clear();
+		spreadsheet->setRowCount(actualRows);
+	}  else {
+		if (spreadsheet->rowCount() < actualRows)
+			spreadsheet->setRowCount(actualRows);
+	}
+
+	dataPointers.resize(actualCols);
+	for (int n = 0; n < actualCols; n++) {
+		void* data = this->child<Column>(columnOffset+n)->data();
+		switch (columnMode) {
+		case AbstractColumn::Integer:
+			static_cast<QVector<int>* >(data)->resize(actualRows);
+			break;
+		case AbstractColumn::BigInt:
+			static_cast<QVector<qint64>* >(data)->resize(actualRows);
+			break;
+		case AbstractColumn::Float:
+			static_cast<QVector<float>* >(data)->resize(actualRows);
+			break;
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Text:
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day:
+			static_cast<QVector<double>* >(data)->resize(actualRows);
+			break;
+		}
+		dataPointers[n] = data;
+	}
+
+	return columnOffset;
+}
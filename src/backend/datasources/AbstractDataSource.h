@@ -31,6 +31,7 @@ Copyright	: (C) 2015 Stefan Gerlach (stefan.gerlach@uni.kn)
 #include "backend/core/AbstractPart.h"
 #include "backend/core/AbstractScriptingEngine.h"
 #include "backend/datasources/filters/AbstractFileFilter.h"
+#include "backend/core/AbstractColumn.h"
 
 #include <QStringList>
 
@@ -40,9 +41,12 @@ class AbstractDataSource : public AbstractPart, public scripted{
    		AbstractDataSource(AbstractScriptingEngine *engine, const QString& name);
         virtual ~AbstractDataSource() {}
 		void clear();
-		int resize(AbstractFileFilter::ImportMode mode, QStringList colNameList, int cols);
+		int resize(AbstractFileFilter::ImportMode mode, QStringList colNameList, int cols,
+				   AbstractColumn::ColumnMode columnMode = AbstractColumn::Numeric);
 		int create(QVector<QVector<double>*>& dataPointers, AbstractFileFilter::ImportMode mode,
 				   int actualRows, int actualCols, QStringList colNameList = QStringList());
+		int create(QVector<void*>& dataPointers, AbstractFileFilter::ImportMode mode,
+				   int actualRows, int actualCols, AbstractColumn::ColumnMode columnMode);
 };
 
 #endif // ifndef ABSTRACTDATASOURCE_H
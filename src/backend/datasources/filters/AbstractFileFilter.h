@@ -53,6 +53,7 @@ class AbstractFileFilter : public QObject {
 
 	signals:
 		void completed(int) const; //!< int ranging from 0 to 100 notifies about the status of a read/write process		
+		void truncated(qint64 rows, qint64 importedRows) const; //!< notifies that only the first importedRows of the rows in the file are imported
 };
 
 #endif
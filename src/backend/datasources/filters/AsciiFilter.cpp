@@ -134,14 +134,14 @@ int AsciiFilter::columnNumber(const QString & fileName) {
 /*!
   returns the number of lines in the file \c fileName.
 */
-size_t AsciiFilter::lineNumber(const QString & fileName) {
+qint64 AsciiFilter::lineNumber(const QString & fileName) {
 	//TODO: compare the speed of this function with the speed of wc from GNU-coreutils.
 	QIODevice *device = KFilterDev::deviceForFile(fileName);
 	if (!device->open(QIODevice::ReadOnly))
 		return 0;
 
 	QTextStream in(device);
-	size_t rows = 0;
+	qint64 rows = 0;
 	while (!in.atEnd()) {
 		in.readLine();
 		rows++;
@@ -351,7 +351,15 @@ QList<QStringList> AsciiFilterPrivate::readData(const QString & fileName, Abstra
 
 	//qDebug()<<"	vector names ="<<vectorNameList;
 
-	int actualRows = AsciiFilter::lineNumber(fileName);	// data rows
+	qint64 fileRows = AsciiFilter::lineNumber(fileName);	// data rows
+	//the values are imported into Numeric columns, see the double vectors created below
+	const qint64 maxRows = AbstractColumn::maxRowCount(AbstractColumn::Numeric);
+	if (fileRows > maxRows) {
+		WARNING("AsciiFilter: the file contains " << fileRows << " lines, only the first " << maxRows << " lines are imported");
+		emit q->truncated(fileRows, maxRows);
+		fileRows = maxRows;
+	}
+	int actualRows = fileRows;
 	int actualEndRow;
 	if (endRow == -1)
 		actualEndRow = actualRows;
@@ -44,7 +44,7 @@ class AsciiFilter : public AbstractFileFilter{
 	static QStringList predefinedFilters();
 
 	static int columnNumber(const QString & fileName);
-	static size_t lineNumber(const QString & fileName);
+	static qint64 lineNumber(const QString & fileName);
 
 	void read(const QString & fileName, AbstractDataSource* dataSource,
 			AbstractFileFilter::ImportMode importMode = AbstractFileFilter::Replace);
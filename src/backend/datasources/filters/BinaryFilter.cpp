@@ -28,6 +28,8 @@ Copyright            : (C) 2015-2017 by Stefan Gerlach (stefan.gerlach@uni.kn)
 #include "backend/datasources/filters/BinaryFilterPrivate.h"
 #include "backend/datasources/FileDataSource.h"
 #include "backend/core/column/Column.h"
+#include "backend/core/column/ColumnMappedData.h"
+#include "backend/lib/macros.h"
 
 #include <QDataStream>
 #include <QDebug>
@@ -95,16 +97,41 @@ int BinaryFilter::dataSize(BinaryFilter::DataType type) {
 	return sizes[(int)type];
 }
 
+/*!
+  returns the column mode used to store the values of the data type \c type in a spreadsheet.
+  The integer and single precision values are stored in their native width, uint64 doesn't fit into the integer modes and is stored as double.
+*/
+AbstractColumn::ColumnMode BinaryFilter::columnMode(BinaryFilter::DataType type) {
+	switch (type) {
+	case INT8:
+	case INT16:
+	case INT32:
+	case UINT8:
+	case UINT16:
+		return AbstractColumn::Integer;
+	case INT64:
+	case UINT32:
+		return AbstractColumn::BigInt;
+	case REAL32:
+		return AbstractColumn::Float;
+	case UINT64:
+	case REAL64:
+		break;
+	}
+
+	return AbstractColumn::Numeric;
+}
+
 /*!
   returns the number of rows (length of vectors) in the file \c fileName.
 */
-long BinaryFilter::rowNumber(const QString & fileName, const int vectors, const BinaryFilter::DataType type) {
+qint64 BinaryFilter::rowNumber(const QString & fileName, const int vectors, const BinaryFilter::DataType type) {
 	QIODevice *device = KFilterDev::deviceForFile(fileName);
 	if (!device->open(QIODevice::ReadOnly))
 		return 0;
 
 	QDataStream in(device);
-	long rows=0;
+	qint64 rows=0;
 	while (!in.atEnd()) {
 		// one row
 		for (int i=0; i < vectors; ++i) {
@@ -203,6 +230,33 @@ bool BinaryFilter::isAutoModeEnabled() const {
 //################### Private implementation ##########################
 //#####################################################################
 
+namespace {
+//! files with double values larger than this are mapped into memory instead of being read, see BinaryFilterPrivate::mapData()
+const qint64 mappingThreshold = Q_INT64_C(256)*1024*1024;
+
+//! store \c value in row \c row of the data vector \c data of a column with the mode \c mode
+template <typename T> void setValue(void* data, AbstractColumn::ColumnMode mode, int row, T value) {
+	switch (mode) {
+	case AbstractColumn::Integer:
+		static_cast<QVector<int>* >(data)->operator[](row) = value;
+		break;
+	case AbstractColumn::BigInt:
+		static_cast<QVector<qint64>* >(data)->operator[](row) = value;
+		break;
+	case AbstractColumn::Float:
+		static_cast<QVector<float>* >(data)->operator[](row) = value;
+		break;
+	case AbstractColumn::Numeric:
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		static_cast<QVector<double>* >(data)->operator[](row) = value;
+		break;
+	}
+}
+}
+
 BinaryFilterPrivate::BinaryFilterPrivate(BinaryFilter* owner) :
 	q(owner), vectors(2), dataType(BinaryFilter::INT8), byteOrder(BinaryFilter::LittleEndian), skipStartBytes(0), startRow(1), endRow(-1), skipBytes(0) {
 }
@@ -225,7 +279,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 	else if (byteOrder == BinaryFilter::LittleEndian)
 		in.setByteOrder(QDataStream::LittleEndian);
 
-	int numRows=BinaryFilter::rowNumber(fileName,vectors,dataType);
+	qint64 numRows=BinaryFilter::rowNumber(fileName,vectors,dataType);
 
 	// catch case that skipStartBytes or startRow is bigger than file
 	if (skipStartBytes >= BinaryFilter::dataSize(dataType)*vectors*numRows || startRow > numRows) {
@@ -249,13 +303,38 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 	}
 
 	// set range of rows
-	int actualRows;
+	qint64 selectedRows;
 	if (endRow == -1)
-		actualRows = numRows-startRow+1;
+		selectedRows = numRows-startRow+1;
 	else if (endRow > numRows-startRow+1)
-		actualRows = numRows;
+		selectedRows = numRows;
 	else
-		actualRows = endRow-startRow+1;
+		selectedRows = endRow-startRow+1;
+
+	//large files with double values are not read but used directly as the storage of the columns,
+	//the mapped values don't need to fit into the memory
+	if ((lines == -1 || lines >= selectedRows) && !dynamic_cast<KFilterDev*>(device)) {
+		const qint64 mappedRows = qMin(selectedRows, ColumnMappedData::maxSize());
+		if (mapData(fileName, dynamic_cast<Spreadsheet*>(dataSource), mode, mappedRows)) {
+			if (mappedRows < selectedRows) {
+				WARNING("BinaryFilter: " << selectedRows << " rows selected, only the first " << mappedRows << " rows are imported");
+				emit q->truncated(selectedRows, mappedRows);
+			}
+			return dataStrings;
+		}
+	}
+
+	//spreadsheets store the values in their native width, matrices as double
+	const AbstractColumn::ColumnMode columnMode = dynamic_cast<Spreadsheet*>(dataSource) ? BinaryFilter::columnMode(dataType) : AbstractColumn::Numeric;
+
+	//the values that are read have to fit into the memory
+	const qint64 maxRows = AbstractColumn::maxRowCount(columnMode);
+	if (selectedRows > maxRows) {
+		WARNING("BinaryFilter: " << selectedRows << " rows selected, only the first " << maxRows << " rows are imported");
+		emit q->truncated(selectedRows, maxRows);
+		selectedRows = maxRows;
+	}
+	int actualRows = selectedRows;
 	int actualCols = vectors;
 	if (lines == -1)
 		lines = actualRows;
@@ -268,10 +347,16 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 	qDebug()<<"	lines ="<<lines;
 #endif
 
-	QVector<QVector<double>*> dataPointers;
+	QVector<void*> dataPointers;
 	int columnOffset = 0;
-	if (dataSource != NULL)
-		columnOffset = dataSource->create(dataPointers, mode, actualRows, actualCols);
+	if (dynamic_cast<Spreadsheet*>(dataSource)) {
+		columnOffset = dataSource->create(dataPointers, mode, actualRows, actualCols, columnMode);
+	} else if (dataSource != NULL) {
+		QVector<QVector<double>*> doublePointers;
+		columnOffset = dataSource->create(doublePointers, mode, actualRows, actualCols);
+		foreach (QVector<double>* vector, doublePointers)
+			dataPointers << vector;
+	}
 
 	// read data
 	for (int i = 0; i < qMin(actualRows, lines); i++) {
@@ -282,7 +367,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				qint8 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					setValue(dataPointers[n], columnMode, i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -291,7 +376,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				qint16 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					setValue(dataPointers[n], columnMode, i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -300,7 +385,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				qint32 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					setValue(dataPointers[n], columnMode, i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -309,7 +394,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				qint64 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					setValue(dataPointers[n], columnMode, i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -318,7 +403,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				quint8 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					setValue(dataPointers[n], columnMode, i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -327,7 +412,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				quint16 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					setValue(dataPointers[n], columnMode, i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -336,7 +421,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				quint32 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					setValue(dataPointers[n], columnMode, i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -345,7 +430,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				quint64 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					setValue(dataPointers[n], columnMode, i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -354,7 +439,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				float value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					setValue(dataPointers[n], columnMode, i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -363,7 +448,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				double value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					setValue(dataPointers[n], columnMode, i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -407,6 +492,54 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 }
 
 
+/*!
+    maps the file \c fileName into memory instead of reading it into the spreadsheet \c spreadsheet.
+    This is only done for files with one vector of double values in the native byte order that are larger than
+    mappingThreshold bytes and if the content of the spreadsheet is replaced. The values of several
+    interleaved vectors are not contiguous and are read.
+    Returns \c false if the data has to be read, also if the file can't be mapped. The spreadsheet is only
+    cleared after it was checked that the column can be mapped.
+*/
+bool BinaryFilterPrivate::mapData(const QString& fileName, Spreadsheet* spreadsheet, AbstractFileFilter::ImportMode mode, qint64 rows) {
+	if (!spreadsheet || mode != AbstractFileFilter::Replace || dataType != BinaryFilter::REAL64 || vectors != 1)
+		return false;
+
+	const BinaryFilter::ByteOrder nativeByteOrder = (QSysInfo::ByteOrder == QSysInfo::BigEndian) ? BinaryFilter::BigEndian : BinaryFilter::LittleEndian;
+	if (byteOrder != nativeByteOrder)
+		return false;
+
+	const qint64 offset = skipStartBytes + (qint64)(startRow-1)*sizeof(double);
+	if (rows*(qint64)sizeof(double) < mappingThreshold || offset + rows*(qint64)sizeof(double) > QFile(fileName).size())
+		return false;
+
+	//check that the column can be mapped before the content of the spreadsheet is removed
+	ColumnMappedData mappedData;
+	if (!mappedData.map(fileName, offset, rows)) {
+		WARNING("BinaryFilter: mapping of the data failed, the data is read instead");
+		return false;
+	}
+
+	spreadsheet->setUndoAware(false);
+	const int columnOffset = spreadsheet->resize(mode, QStringList(), 1);
+	spreadsheet->clear();
+
+	Column* column = spreadsheet->column(columnOffset);
+	if (!column->mapData(fileName, offset, rows)) {
+		//the file was changed in the meantime, the spreadsheet is filled by reading the data
+		WARNING("BinaryFilter: mapping of the data failed, the data is read instead");
+		spreadsheet->setUndoAware(true);
+		return false;
+	}
+	column->setComment(i18np("numerical data, %1 element", "numerical data, %1 elements", rows));
+	column->setUndoAware(true);
+	column->setSuppressDataChangedSignal(false);
+	column->setChanged();
+	spreadsheet->setUndoAware(true);
+	emit q->completed(100);
+
+	return true;
+}
+
 void BinaryFilterPrivate::read(const QString & fileName, AbstractDataSource* dataSource, AbstractFileFilter::ImportMode mode) {
 	readData(fileName,dataSource,mode);
 }
@@ -29,6 +29,7 @@ Copyright            : (C) 2015 Stefan Gerlach (stefan.gerlach@uni.kn)
 
 #include <QStringList>
 #include "backend/datasources/filters/AbstractFileFilter.h"
+#include "backend/core/AbstractColumn.h"
 
 class BinaryFilterPrivate;
 class BinaryFilter : public AbstractFileFilter{
@@ -44,7 +45,8 @@ class BinaryFilter : public AbstractFileFilter{
 	static QStringList dataTypes();
 	static QStringList byteOrders();
 	static int dataSize(BinaryFilter::DataType);
-	static long rowNumber(const QString & fileName, const int vectors, const BinaryFilter::DataType type);
+	static AbstractColumn::ColumnMode columnMode(BinaryFilter::DataType);
+	static qint64 rowNumber(const QString & fileName, const int vectors, const BinaryFilter::DataType type);
 
 	void read(const QString & fileName, AbstractDataSource* dataSource, AbstractFileFilter::ImportMode importMode=AbstractFileFilter::Replace);
 	QList <QStringList> readData(const QString & fileName, AbstractDataSource* dataSource, AbstractFileFilter::ImportMode importMode=AbstractFileFilter::Replace, int lines=-1);
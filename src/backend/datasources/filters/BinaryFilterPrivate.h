@@ -28,6 +28,7 @@ Copyright            : (C) 2015 Stefan Gerlach (stefan.gerlach@uni.kn)
 #define BINARYFILTERPRIVATE_H
 
 class AbstractDataSource;
+class Spreadsheet;
 
 class BinaryFilterPrivate {
 
@@ -53,6 +54,7 @@ class BinaryFilterPrivate {
 
 	private:
 		void clearDataSource(AbstractDataSource*) const;
+		bool mapData(const QString& fileName, Spreadsheet*, AbstractFileFilter::ImportMode, qint64 rows);
 };
 
 #endif
@@ -29,6 +29,7 @@ Copyright            : (C) 2016 by Fabian Kristof (fkristofszabolcs@gmail.com)
 #include "FITSFilterPrivate.h"
 #include "backend/datasources/FileDataSource.h"
 #include "backend/core/column/Column.h"
+#include "backend/core/column/ColumnTextData.h"
 #include "backend/core/datatypes/Double2StringFilter.h"
 #include "commonfrontend/matrix/MatrixView.h"
 #include "backend/matrix/MatrixModel.h"
@@ -455,7 +456,7 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 
 		if (endRow != -1)
 			lines = endRow;
-		QVector<QStringList*> stringDataPointers;
+		QVector<ColumnTextData*> stringDataPointers;
 		QVector<QVector<double>*> numericDataPointers;
 		QList<bool> columnNumericTypes;
 
@@ -540,7 +541,7 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 							datap->clear();
 					} else {
 						spreadsheet->column(columnOffset+ n)->setColumnMode(AbstractColumn::Text);
-						QStringList* list = static_cast<QStringList* >(spreadsheet->column(columnOffset+n)->data());
+						ColumnTextData* list = static_cast<ColumnTextData* >(spreadsheet->column(columnOffset+n)->data());
 						stringDataPointers.push_back(list);
 						if (importMode == AbstractFileFilter::Replace)
 							list->clear();
@@ -626,6 +627,8 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 					Column* column = spreadsheet->column(columnOffset+n);
 					column->setComment(columnUnits.at(n));
 					//TODO: column->setName(); ?
+					if (column->columnMode() == AbstractColumn::Text)
+						column->encodeText();
 					column->setUndoAware(true);
 					if (importMode==AbstractFileFilter::Replace) {
 						column->setSuppressDataChangedSignal(false);
@@ -854,7 +857,10 @@ void FITSFilterPrivate::writeCHDU(const QString &fileName, AbstractDataSource *d
 					strcpy(tunit[i], "");
 				}
 				switch (column->columnMode()) {
-				case AbstractColumn::Numeric: {
+				case AbstractColumn::Numeric:
+				case AbstractColumn::Integer:
+				case AbstractColumn::BigInt:
+				case AbstractColumn::Float: {
 						int maxSize = -1;
 						for (int row = 0; row < nrows; ++row) {
 							if (QString::number(column->valueAt(row)).size() > maxSize)
@@ -945,7 +951,7 @@ void FITSFilterPrivate::writeCHDU(const QString &fileName, AbstractDataSource *d
 				const Column* c =  spreadsheet->column(col-1);
 				AbstractColumn::ColumnMode columnMode = c->columnMode();
 
-				if (columnMode == AbstractColumn::Numeric) {
+				if (AbstractColumn::isNumeric(columnMode)) {
 					for (int row = 0; row < nrows; ++row)
 						columnNumeric[row] = c->valueAt(row);
 
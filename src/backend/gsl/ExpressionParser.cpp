@@ -31,6 +31,11 @@
 
 #include <klocale.h>
 #include <QDebug>
+#include <QCoreApplication>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
 
 #include <cmath>
 extern "C" {
@@ -1107,34 +1112,42 @@ bool ExpressionParser::isValid(const QString& expr, const QStringList& vars) {
 	return !(parse_errors()>0);
 }
 
+/*
+	evaluates the compiled program for the n values \c x of the variable \c var,
+	writes the results to \c y and replaces non-finite results by NAN.
+ */
+static void evaluateProgram(const parser_program* prog, symrec* var, const double* x, double* y, int n) {
+	program_eval_batch(prog, &var, &x, 1, n, y);
+
+	for (int i = 0; i < n; i++) {
+		if (!std::isfinite(y[i]))
+			y[i] = NAN;
+	}
+}
+
 bool ExpressionParser::evaluateCartesian(const QString& expr, const QString& min, const QString& max,
 										 int count, QVector<double>* xVector, QVector<double>* yVector,
 										 const QStringList& paramNames, const QVector<double>& paramValues) {
 	double xMin = parse(min.toLocal8Bit().data());
 	double xMax = parse(max.toLocal8Bit().data());
 	double step = (xMax - xMin)/(double)(count - 1);
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
+	QByteArray funcba = expr.toLocal8Bit();
 	gsl_set_error_handler_off();
 
 	for (int i = 0; i < paramNames.size(); ++i)
 		assign_variable(paramNames.at(i).toLocal8Bit().data(), paramValues.at(i));
 
-	for (int i = 0; i < count; i++) {
-		x = xMin + step * i;
-		assign_variable("x", x);
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
-
-		(*xVector)[i] = x;
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
+	//parse the expression only once and evaluate the compiled program for all x
+	symrec* xSymbol = assign_variable("x", xMin);
+	parser_program* prog = parse_compile(funcba.data());
+	if (!prog)
+		return false;
+
+	for (int i = 0; i < count; i++)
+		(*xVector)[i] = xMin + step * i;
+	evaluateProgram(prog, xSymbol, xVector->constData(), yVector->data(), count);
 
+	program_free(prog);
 	return true;
 }
 
@@ -1143,118 +1156,158 @@ bool ExpressionParser::evaluateCartesian(const QString& expr, const QString& min
 	double xMin = parse(min.toLocal8Bit().data());
 	double xMax = parse(max.toLocal8Bit().data());
 	double step = (xMax - xMin)/(double)(count - 1);
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
+	QByteArray funcba = expr.toLocal8Bit();
 	gsl_set_error_handler_off();
 
-	for (int i = 0; i < count; i++) {
-		x = xMin + step*i;
-		assign_variable("x", x);
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
-
-		(*xVector)[i] = x;
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
+	symrec* xSymbol = assign_variable("x", xMin);
+	parser_program* prog = parse_compile(funcba.data());
+	if (!prog)
+		return false;
 
+	for (int i = 0; i < count; i++)
+		(*xVector)[i] = xMin + step*i;
+	evaluateProgram(prog, xSymbol, xVector->constData(), yVector->data(), count);
+
+	program_free(prog);
 	return true;
 }
 
 bool ExpressionParser::evaluateCartesian(const QString& expr, QVector<double>* xVector, QVector<double>* yVector) {
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
+	QByteArray funcba = expr.toLocal8Bit();
 	gsl_set_error_handler_off();
 
-	for (int i = 0; i < xVector->count(); i++) {
-		x = xVector->at(i);
-		assign_variable("x", x);
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
+	symrec* xSymbol = assign_variable("x", 0);
+	parser_program* prog = parse_compile(funcba.data());
+	if (!prog)
+		return false;
 
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
+	evaluateProgram(prog, xSymbol, xVector->constData(), yVector->data(), xVector->count());
 
+	program_free(prog);
 	return true;
 }
 
 bool ExpressionParser::evaluateCartesian(const QString& expr, QVector<double>* xVector, QVector<double>* yVector,
 		const QStringList& paramNames, const QVector<double>& paramValues) {
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
+	QByteArray funcba = expr.toLocal8Bit();
 	gsl_set_error_handler_off();
 
 	for (int i = 0; i < paramNames.size(); ++i)
 		assign_variable(paramNames.at(i).toLocal8Bit().data(), paramValues.at(i));
 
-	for (int i = 0; i < xVector->count(); i++) {
-		x = xVector->at(i);
-		assign_variable("x", x);
-		y = parse(func);
+	symrec* xSymbol = assign_variable("x", 0);
+	parser_program* prog = parse_compile(funcba.data());
+	if (!prog)
+		return false;
 
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
+	evaluateProgram(prog, xSymbol, xVector->constData(), yVector->data(), xVector->count());
 
+	program_free(prog);
 	return true;
 }
 
+/* task evaluating a multivariate function for the rows [start, end). Every task uses an own parser context. */
+class EvaluateCartesianTask : public QRunnable {
+public:
+	EvaluateCartesianTask(const char* func, const QStringList& vars, const QVector<const double*>& xData, double* yData, int start, int end, QSemaphore* done)
+		: m_func(func), m_vars(vars), m_xData(xData), m_yData(yData), m_start(start), m_end(end), m_done(done) {
+	}
+
+	void run() {
+		parser_context* context = parser_context_new();
+		QVector<symrec*> varSymbols;
+		QVector<const double*> values;
+		for (int n = 0; n < m_vars.size(); ++n) {
+			varSymbols << parser_context_assign_variable(context, m_vars.at(n).toLocal8Bit().data(), 0);
+			values << m_xData.at(n) + m_start;
+		}
+
+		parser_program* prog = parser_context_compile(context, m_func);
+		if (prog) {
+			double* y = m_yData + m_start;
+			const int count = m_end - m_start;
+			program_eval_batch(prog, varSymbols.constData(), values.constData(), varSymbols.size(), count, y);
+			for (int i = 0; i < count; ++i) {
+				if (!std::isfinite(y[i]))
+					y[i] = NAN;
+			}
+			program_free(prog);
+		}
+		parser_context_free(context);
+
+		if (m_done)
+			m_done->release();
+	}
+
+private:
+	const char* m_func;
+	const QStringList m_vars;
+	const QVector<const double*> m_xData;
+	double* m_yData;
+	int m_start;
+	int m_end;
+	QSemaphore* m_done;
+};
+
 /*!
 	evaluates multivariate function y=f(x_1, x_2, ...).
 	Variable names (x_1, x_2, ...) are stored in \c vars.
 	Data is stored in \c dataVectors.
+	The rows are evaluated in parallel if called from the GUI thread. In other threads, e.g. in the tasks
+	of the global thread pool, all rows are evaluated in the calling thread since the other threads of the
+	pool might be busy waiting for the calling thread. The function doesn't use the global parser context.
  */
 bool ExpressionParser::evaluateCartesian(const QString& expr, const QStringList& vars, const QVector<QVector<double>*>& xVectors, QVector<double>* yVector) {
 	Q_ASSERT(vars.size() == xVectors.size());
-	const char* func = expr.toLocal8Bit().data();
-	double y, varValue;
-	QString varName;
+	QByteArray funcba = expr.toLocal8Bit();
 
 	gsl_set_error_handler_off();
 
-	bool stop = false;
-	for (int i = 0; i < yVector->size(); i++) {
-		//stop iterating over i if one of the x-vectors has no elements anymore.
-		for (int n = 0; n < xVectors.size(); ++n) {
-			if (i == xVectors.at(n)->size()) {
-				stop = true;
-				break;
-			}
-		}
-		if (stop)
+	//check the expression before starting the parallel evaluation
+	parser_context* context = parser_context_new();
+	for (int n = 0; n < vars.size(); ++n)
+		parser_context_assign_variable(context, vars.at(n).toLocal8Bit().data(), 0);
+	parser_program* prog = parser_context_compile(context, funcba.data());
+	const bool valid = (prog != 0);
+	if (prog)
+		program_free(prog);
+	parser_context_free(context);
+	if (!valid)
+		return false;
+
+	//stop iterating if one of the x-vectors has no elements anymore.
+	int rows = yVector->size();
+	QVector<const double*> xData;
+	for (int n = 0; n < xVectors.size(); ++n) {
+		if (xVectors.at(n)->size() < rows)
+			rows = xVectors.at(n)->size();
+		xData << xVectors.at(n)->constData();
+	}
+	double* yData = yVector->data();
+
+	if (rows <= 0)
+		return true;
+
+	QThreadPool* pool = QThreadPool::globalInstance();
+	const bool guiThread = (QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread());
+	const int tasks = guiThread ? pool->maxThreadCount() : 1;
+	const int range = ceil(double(rows)/tasks);
+	QSemaphore done;
+	int started = 0;
+	for (int i = 1; i < tasks; ++i) {
+		const int start = i*range;
+		if (start >= rows)
 			break;
-
-		for (int n = 0; n < vars.size(); ++n) {
-			varName = vars.at(n);
-			varValue = xVectors.at(n)->at(i);
-			assign_variable(varName.toLocal8Bit().data(), varValue);
-		}
-
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
+		int end = (i+1)*range;
+		if (end > rows) end = rows;
+		pool->start(new EvaluateCartesianTask(funcba.constData(), vars, xData, yData, start, end, &done));
+		++started;
 	}
 
+	//the first range is evaluated in the calling thread
+	EvaluateCartesianTask(funcba.constData(), vars, xData, yData, 0, qMin(range, rows), 0).run();
+	done.acquire(started);
+
 	return true;
 }
 
@@ -1264,26 +1317,27 @@ bool ExpressionParser::evaluatePolar(const QString& expr, const QString& min, co
 	double maxValue = parse(max.toLocal8Bit().data());
 	double step = (maxValue - minValue)/(double)(count - 1);
 	QByteArray funcba = expr.toLocal8Bit();
-	const char* func = funcba.data();
-	double r, phi;
 	gsl_set_error_handler_off();
 
+	symrec* phiSymbol = assign_variable("phi", minValue);
+	parser_program* prog = parse_compile(funcba.data());
+	if (!prog)
+		return false;
+
+	//calculate r(phi) for all phi (stored in xVector) and convert to cartesian coordinates
+	for (int i = 0; i < count; i++)
+		(*xVector)[i] = minValue + step * i;
+	evaluateProgram(prog, phiSymbol, xVector->constData(), yVector->data(), count);
+
+	double r, phi;
 	for (int i = 0; i < count; i++) {
-		phi = minValue + step * i;
-		assign_variable("phi", phi);
-		r = parse(func);
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(r)) {
-			(*xVector)[i] = r*cos(phi);
-			(*yVector)[i] = r*sin(phi);
-		} else {
-			(*xVector)[i] = NAN;
-			(*yVector)[i] = NAN;
-		}
+		phi = xVector->at(i);
+		r = yVector->at(i);
+		(*xVector)[i] = r*cos(phi);
+		(*yVector)[i] = r*sin(phi);
 	}
 
+	program_free(prog);
 	return true;
 }
 
@@ -1293,33 +1347,26 @@ bool ExpressionParser::evaluateParametric(const QString& expr1, const QString& e
 	double maxValue = parse(max.toLocal8Bit().data());
 	double step = (maxValue - minValue)/(double)(count - 1);
 	QByteArray xfuncba = expr1.toLocal8Bit();
-	const char* xFunc = xfuncba.data();
 	QByteArray yfuncba = expr2.toLocal8Bit();
-	const char* yFunc = yfuncba.data();
-	double x, y, t;
 	gsl_set_error_handler_off();
 
-	for (int i = 0; i < count; i++) {
-		t = minValue + step*i;
-		assign_variable("t", t);
-		x = parse(xFunc);
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(x))
-			(*xVector)[i] = x;
-		else
-			(*xVector)[i] = NAN;
-
-		y = parse(yFunc);
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
+	symrec* tSymbol = assign_variable("t", minValue);
+	parser_program* xProg = parse_compile(xfuncba.data());
+	if (!xProg)
+		return false;
+	parser_program* yProg = parse_compile(yfuncba.data());
+	if (!yProg) {
+		program_free(xProg);
+		return false;
 	}
 
+	QVector<double> tVector(count);
+	for (int i = 0; i < count; i++)
+		tVector[i] = minValue + step*i;
+	evaluateProgram(xProg, tSymbol, tVector.constData(), xVector->data(), count);
+	evaluateProgram(yProg, tSymbol, tVector.constData(), yVector->data(), count);
+
+	program_free(xProg);
+	program_free(yProg);
 	return true;
 }
@@ -63,13 +63,37 @@ typedef struct symrec {
 	struct symrec *next;	/* next field */
 } symrec;
 
+/* compiled expression (see parse_compile()) */
+typedef struct parser_program parser_program;
+/* parser context with an own symbol table (use one context per thread) */
+typedef struct parser_context parser_context;
+
+/* The symbol returned by assign_variable() is a handle of the variable: it stays valid
+   as long as the symbol table exists and setting sym->value.var changes the variable
+   without looking it up again (use this in loops). */
+
+/* functions using the global default context (not thread-safe) */
 void init_table();	/* initialize symbol table */
 void delete_table();	/* delete symbol table */
 int parse_errors();
 symrec* assign_variable(const char* symb_name, double value);
-/*new style: symrec* assign_variable(symrec *sym_table, parser_var var);*/
 double parse(const char *str);
 double parse_with_vars(const char[], const parser_var[], int nvars);
+/* parse once, evaluate many times */
+parser_program* parse_compile(const char *str);
+
+/* reentrant functions */
+parser_context* parser_context_new(void);
+void parser_context_free(parser_context *ctx);
+int parser_context_errors(const parser_context *ctx);
+symrec* parser_context_assign_variable(parser_context *ctx, const char* symb_name, double value);
+double parser_context_parse(parser_context *ctx, const char *str);
+parser_program* parser_context_compile(parser_context *ctx, const char *str);
+
+double program_eval(const parser_program *prog);
+double program_eval_deriv(const parser_program *prog, symrec * const wrt[], int nwrt, double *grad);
+void program_eval_batch(const parser_program *prog, symrec * const vars[], const double * const values[], int nvars, int n, double *result);
+void program_free(parser_program *prog);
 
 extern struct con _constants[];
 extern struct func _functions[];
@@ -1,21 +1,22 @@
-/* A Bison parser, made by GNU Bison 2.7.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
-   
-      Copyright (C) 1984, 1989-1990, 2000-2012 Free Software Foundation, Inc.
-   
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
    the Free Software Foundation, either version 3 of the License, or
    (at your option) any later version.
-   
+
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
    GNU General Public License for more details.
-   
+
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -26,13 +27,17 @@
    special exception, which will cause the skeleton and the resulting
    Bison output files to be licensed under the GNU General Public
    License without this special exception.
-   
+
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,17 +45,17 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "2.7"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 2
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -61,11 +66,12 @@
 
 
 
-/* Copy the first part of user declarations.  */
-/* Line 371 of yacc.c  */
+/* First part of user prologue.  */
 #line 30 "parser.y"
 
+#include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <ctype.h>
 #include <locale.h>
 #include "parser.h"
@@ -80,39 +86,94 @@
 
 #define YYERROR_VERBOSE 1
 
+/* stack size for evaluating programs without allocation */
+#define PARSER_STACK_SIZE 64
+/* number of points evaluated together in program_eval_batch() */
+#define PARSER_BATCH_SIZE 256
+
+/* instructions of a compiled expression */
+typedef enum opcode {
+	OP_NUM,		/* push number */
+	OP_VAR,		/* push value of variable */
+	OP_ASSIGN,	/* assign top of stack to variable (value stays on stack) */
+	OP_FNCT,	/* call function with nargs arguments from the stack */
+	OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW,	/* binary operators */
+	OP_NEG,		/* unary minus */
+	OP_SQRT, OP_FABS	/* functions evaluated inline (vectorizable in program_eval_batch()) */
+} opcode;
+
+#define IS_UNARY(op) ((op) == OP_NEG || (op) == OP_SQRT || (op) == OP_FABS)
+
+typedef struct instr {
+	opcode op;
+	int nargs;		/* number of arguments of OP_FNCT */
+	union {
+		double num;	/* value of OP_NUM */
+		symrec *sym;	/* symbol of OP_VAR and OP_ASSIGN */
+		func_t fnct;	/* function of OP_FNCT */
+	} arg;
+} instr;
+
+/* compiled expression: the instructions in postfix order, evaluated on a stack */
+struct parser_program {
+	instr *code;
+	int length;	/* number of instructions */
+	int size;	/* allocated number of instructions */
+	int sp;		/* stack depth after the last instruction (used while compiling) */
+	int depth;	/* maximal stack depth needed for the evaluation */
+};
+
+/* number of buckets of the symbol table (power of 2) */
+#define PARSER_HASH_SIZE 1024
+
+/* parser context: every context has its own symbol table, so different
+   contexts can be used in different threads at the same time */
+struct parser_context {
+	symrec *sym_table[PARSER_HASH_SIZE];	/* the hashed symbol table (symbols chained by symrec->next) */
+	int errors;		/* number of errors of the last parse */
+};
+
 /* params passed to yylex (and yyerror) */
 typedef struct param {
 	unsigned int pos;	/* current position in string */
 	char *string;		/* the string to parse */
-/*	symrec *sym_table;	the symbol table (not used) */
+	parser_context *ctx;	/* the context (symbol table) used for parsing */
+	parser_program *prog;	/* the program the grammar actions append to */
+	char *symbuf;		/* buffer for reading symbol names */
+	int symlength;		/* length of symbuf */
 } param;
 
-int yyerror(param *p, const char *err);
-int yylex(param *p);
 
-double res;
+static void emit_num(parser_program *prog, double value);
+static void emit_sym(parser_program *prog, opcode op, symrec *sym);
+static void emit_fnct(parser_program *prog, func_t fnct, int nargs);
+static void emit_op(parser_program *prog, opcode op);
 
-/* Line 371 of yacc.c  */
-#line 97 "parser.tab.c"
+#line 153 "parser.tab.c"
 
-# ifndef YY_NULL
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULL nullptr
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
 #  else
-#   define YY_NULL 0
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
 #  endif
 # endif
-
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
 
 
-/* Enabling traces.  */
+/* Debug traces.  */
 #ifndef YYDEBUG
 # define YYDEBUG 0
 #endif
@@ -120,90 +181,170 @@ double res;
 extern int yydebug;
 #endif
 
-/* Tokens.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     NUM = 258,
-     VAR = 259,
-     FNCT = 260,
-     NEG = 261
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    NUM = 258,                     /* NUM  */
+    VAR = 259,                     /* VAR  */
+    FNCT = 260,                    /* FNCT  */
+    NEG = 261                      /* NEG  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
-
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
+union YYSTYPE
 {
-/* Line 387 of yacc.c  */
-#line 62 "parser.y"
+#line 116 "parser.y"
 
 double dval;	/* For returning numbers */
 symrec *tptr;   /* For returning symbol-table pointers */
 
+#line 211 "parser.tab.c"
 
-/* Line 387 of yacc.c  */
-#line 149 "parser.tab.c"
-} YYSTYPE;
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
 # define YYSTYPE_IS_DECLARED 1
 #endif
 
-extern YYSTYPE yylval;
 
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void *YYPARSE_PARAM);
-#else
-int yyparse ();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
+
+
 int yyparse (param *p);
-#else
-int yyparse ();
-#endif
-#endif /* ! YYPARSE_PARAM */
 
 
 
-/* Copy the second part of user declarations.  */
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_NUM = 3,                        /* NUM  */
+  YYSYMBOL_VAR = 4,                        /* VAR  */
+  YYSYMBOL_FNCT = 5,                       /* FNCT  */
+  YYSYMBOL_6_ = 6,                         /* '='  */
+  YYSYMBOL_7_ = 7,                         /* '-'  */
+  YYSYMBOL_8_ = 8,                         /* '+'  */
+  YYSYMBOL_9_ = 9,                         /* '*'  */
+  YYSYMBOL_10_ = 10,                       /* '/'  */
+  YYSYMBOL_NEG = 11,                       /* NEG  */
+  YYSYMBOL_12_ = 12,                       /* '^'  */
+  YYSYMBOL_13_n_ = 13,                     /* '\n'  */
+  YYSYMBOL_14_ = 14,                       /* '('  */
+  YYSYMBOL_15_ = 15,                       /* ')'  */
+  YYSYMBOL_16_ = 16,                       /* ','  */
+  YYSYMBOL_YYACCEPT = 17,                  /* $accept  */
+  YYSYMBOL_input = 18,                     /* input  */
+  YYSYMBOL_line = 19,                      /* line  */
+  YYSYMBOL_expr = 20                       /* expr  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+/* Second part of user prologue.  */
+#line 121 "parser.y"
+
+int yyerror(param *p, const char *err);
+int yylex(YYSTYPE *lvalp, param *p);
+
+#line 261 "parser.tab.c"
 
-/* Line 390 of yacc.c  */
-#line 177 "parser.tab.c"
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#elif (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
 typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef short int yytype_int8;
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -211,16 +352,28 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
@@ -234,32 +387,71 @@ typedef short int yytype_int16;
 # endif
 #endif
 
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-/* Identity function, used to suppress warnings about constant conditions.  */
-#ifndef lint
-# define YYID(N) (N)
-#else
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static int
-YYID (int yyi)
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
 #else
-static int
-YYID (yyi)
-    int yyi;
+# define YY_INITIAL_VALUE(Value) Value
 #endif
-{
-  return yyi;
-}
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
 #endif
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -276,8 +468,7 @@ YYID (yyi)
 #    define alloca _alloca
 #   else
 #    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
 #     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
       /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
 #     ifndef EXIT_SUCCESS
@@ -289,8 +480,8 @@ YYID (yyi)
 # endif
 
 # ifdef YYSTACK_ALLOC
-   /* Pacify GCC's `empty if-body' warning.  */
-#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (YYID (0))
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
     /* The OS might guarantee only one guard page at the bottom of the stack,
        and a page size can be as small as 4096 bytes.  So we cannot safely
@@ -306,7 +497,7 @@ YYID (yyi)
 #  endif
 #  if (defined __cplusplus && ! defined EXIT_SUCCESS \
        && ! ((defined YYMALLOC || defined malloc) \
-	     && (defined YYFREE || defined free)))
+             && (defined YYFREE || defined free)))
 #   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
 #   ifndef EXIT_SUCCESS
 #    define EXIT_SUCCESS 0
@@ -314,40 +505,37 @@ YYID (yyi)
 #  endif
 #  ifndef YYMALLOC
 #   define YYMALLOC malloc
-#   if ! defined malloc && ! defined EXIT_SUCCESS && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined malloc && ! defined EXIT_SUCCESS
 void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 #  ifndef YYFREE
 #   define YYFREE free
-#   if ! defined free && ! defined EXIT_SUCCESS && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined free && ! defined EXIT_SUCCESS
 void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
-	 || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
 # define YYCOPY_NEEDED 1
@@ -357,16 +545,16 @@ union yyalloc
    elements in the stack, and YYPTR gives the new location of the
    stack.  Advance YYPTR to a properly aligned location for the next
    stack.  */
-# define YYSTACK_RELOCATE(Stack_alloc, Stack)				\
-    do									\
-      {									\
-	YYSIZE_T yynewbytes;						\
-	YYCOPY (&yyptr->Stack_alloc, Stack, yysize);			\
-	Stack = &yyptr->Stack_alloc;					\
-	yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-	yyptr += yynewbytes / sizeof (*yyptr);				\
-      }									\
-    while (YYID (0))
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
 
 #endif
 
@@ -376,16 +564,16 @@ union yyalloc
 # ifndef YYCOPY
 #  if defined __GNUC__ && 1 < __GNUC__
 #   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
 #  else
 #   define YYCOPY(Dst, Src, Count)              \
       do                                        \
         {                                       \
-          YYSIZE_T yyi;                         \
+          YYPTRDIFF_T yyi;                      \
           for (yyi = 0; yyi < (Count); yyi++)   \
             (Dst)[yyi] = (Src)[yyi];            \
         }                                       \
-      while (YYID (0))
+      while (0)
 #  endif
 # endif
 #endif /* !YYCOPY_NEEDED */
@@ -401,18 +589,23 @@ union yyalloc
 #define YYNNTS  4
 /* YYNRULES -- Number of rules.  */
 #define YYNRULES  22
-/* YYNRULES -- Number of states.  */
+/* YYNSTATES -- Number of states.  */
 #define YYNSTATES  44
 
-/* YYTRANSLATE(YYLEX) -- Bison symbol number corresponding to YYLEX.  */
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   261
 
-#define YYTRANSLATE(YYX)						\
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
 
-/* YYTRANSLATE[YYLEX] -- Bison symbol number corresponding to YYLEX.  */
-static const yytype_uint8 yytranslate[] =
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
       13,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -444,97 +637,51 @@ static const yytype_uint8 yytranslate[] =
 };
 
 #if YYDEBUG
-/* YYPRHS[YYN] -- Index of the first RHS symbol of rule number YYN in
-   YYRHS.  */
-static const yytype_uint8 yyprhs[] =
-{
-       0,     0,     3,     4,     7,     9,    12,    15,    17,    19,
-      23,    27,    32,    39,    48,    59,    63,    67,    71,    75,
-      78,    82,    87
-};
-
-/* YYRHS -- A `-1'-separated list of the rules' RHS.  */
-static const yytype_int8 yyrhs[] =
-{
-      18,     0,    -1,    -1,    18,    19,    -1,    13,    -1,    20,
-      13,    -1,     1,    13,    -1,     3,    -1,     4,    -1,     4,
-       6,    20,    -1,     5,    14,    15,    -1,     5,    14,    20,
-      15,    -1,     5,    14,    20,    16,    20,    15,    -1,     5,
-      14,    20,    16,    20,    16,    20,    15,    -1,     5,    14,
-      20,    16,    20,    16,    20,    16,    20,    15,    -1,    20,
-       8,    20,    -1,    20,     7,    20,    -1,    20,     9,    20,
-      -1,    20,    10,    20,    -1,     7,    20,    -1,    20,    12,
-      20,    -1,    20,     9,     9,    20,    -1,    14,    20,    15,
-      -1
-};
-
-/* YYRLINE[YYN] -- source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    78,    78,    79,    82,    83,    84,    87,    88,    89,
-      90,    91,    92,    93,    94,    95,    96,    97,    98,    99,
-     100,   101,   102
+       0,   138,   138,   139,   142,   143,   144,   147,   148,   149,
+     150,   151,   152,   153,   154,   155,   156,   157,   158,   159,
+     160,   161,   162
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "NUM", "VAR", "FNCT", "'='", "'-'",
-  "'+'", "'*'", "'/'", "NEG", "'^'", "'\\n'", "'('", "')'", "','",
-  "$accept", "input", "line", "expr", YY_NULL
+  "\"end of file\"", "error", "\"invalid token\"", "NUM", "VAR", "FNCT",
+  "'='", "'-'", "'+'", "'*'", "'/'", "NEG", "'^'", "'\\n'", "'('", "')'",
+  "','", "$accept", "input", "line", "expr", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[YYLEX-NUM] -- Internal token number corresponding to
-   token YYLEX-NUM.  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,    61,    45,    43,    42,
-      47,   261,    94,    10,    40,    41,    44
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
-{
-       0,    17,    18,    18,    19,    19,    19,    20,    20,    20,
-      20,    20,    20,    20,    20,    20,    20,    20,    20,    20,
-      20,    20,    20
-};
+#define YYPACT_NINF (-13)
 
-/* YYR2[YYN] -- Number of symbols composing right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
-{
-       0,     2,     0,     2,     1,     2,     2,     1,     1,     3,
-       3,     4,     6,     8,    10,     3,     3,     3,     3,     2,
-       3,     4,     3
-};
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-/* YYDEFACT[STATE-NAME] -- Default reduction number in state STATE-NUM.
-   Performed when YYTABLE doesn't specify something else to do.  Zero
-   means the default is an error.  */
-static const yytype_uint8 yydefact[] =
-{
-       2,     0,     1,     0,     7,     8,     0,     0,     4,     0,
-       3,     0,     6,     0,     0,    19,     0,     0,     0,     0,
-       0,     0,     5,     9,    10,     0,    22,    16,    15,     0,
-      17,    18,    20,    11,     0,    21,     0,    12,     0,     0,
-      13,     0,     0,    14
-};
+#define YYTABLE_NINF (-1)
 
-/* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
-{
-      -1,     1,    10,    11
-};
+#define yytable_value_is_error(Yyn) \
+  0
 
 /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
    STATE-NUM.  */
-#define YYPACT_NINF -13
 static const yytype_int8 yypact[] =
 {
      -13,    16,   -13,   -12,   -13,    -3,   -10,    42,   -13,    42,
@@ -544,17 +691,34 @@ static const yytype_int8 yypact[] =
      -13,    42,    82,   -13
 };
 
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       2,     0,     1,     0,     7,     8,     0,     0,     4,     0,
+       3,     0,     6,     0,     0,    19,     0,     0,     0,     0,
+       0,     0,     5,     9,    10,     0,    22,    16,    15,     0,
+      17,    18,    20,    11,     0,    21,     0,    12,     0,     0,
+      13,     0,     0,    14
+};
+
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
      -13,   -13,   -13,    -7
 };
 
-/* YYTABLE[YYPACT[STATE-NUM]].  What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule which
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int8 yydefgoto[] =
+{
+       0,     1,    10,    11
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
-#define YYTABLE_NINF -1
-static const yytype_uint8 yytable[] =
+static const yytype_int8 yytable[] =
 {
       15,    12,    16,    13,    14,     0,    23,    25,    21,     0,
       27,    28,    30,    31,    32,     0,     2,     3,     0,     4,
@@ -570,12 +734,6 @@ static const yytype_uint8 yytable[] =
       21,    19,    20,     0,    21
 };
 
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-13)))
-
-#define yytable_value_is_error(Yytable_value) \
-  YYID (0)
-
 static const yytype_int8 yycheck[] =
 {
        7,    13,     9,     6,    14,    -1,    13,    14,    12,    -1,
@@ -592,9 +750,9 @@ static const yytype_int8 yycheck[] =
       12,     9,    10,    -1,    12
 };
 
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
        0,    18,     0,     1,     3,     4,     5,     7,    13,    14,
       19,    20,    13,     6,    14,    20,    20,     7,     8,     9,
@@ -603,67 +761,57 @@ static const yytype_uint8 yystos[] =
       15,    16,    20,    15
 };
 
-#define yyerrok		(yyerrstatus = 0)
-#define yyclearin	(yychar = YYEMPTY)
-#define YYEMPTY		(-2)
-#define YYEOF		0
-
-#define YYACCEPT	goto yyacceptlab
-#define YYABORT		goto yyabortlab
-#define YYERROR		goto yyerrorlab
-
-
-/* Like YYERROR except do call yyerror.  This remains here temporarily
-   to ease the transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  However,
-   YYFAIL appears to be in use.  Nevertheless, it is formally deprecated
-   in Bison 2.4.2's NEWS entry, where a plan to phase it out is
-   discussed.  */
-
-#define YYFAIL		goto yyerrlab
-#if defined YYFAIL
-  /* This is here to suppress warnings from the GCC cpp's
-     -Wunused-macros.  Normally we don't worry about that warning, but
-     some users do, and we want to make it easy for users to remove
-     YYFAIL uses, which will produce warnings from Bison 2.5.  */
-#endif
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    17,    18,    18,    19,    19,    19,    20,    20,    20,
+      20,    20,    20,    20,    20,    20,    20,    20,    20,    20,
+      20,    20,    20
+};
 
-#define YYRECOVERING()  (!!yyerrstatus)
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     0,     2,     1,     2,     2,     1,     1,     3,
+       3,     4,     6,     8,    10,     3,     3,     3,     3,     2,
+       3,     4,     3
+};
 
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (p, YY_("syntax error: cannot back up")); \
-      YYERROR;							\
-    }								\
-while (YYID (0))
-
-/* Error token number */
-#define YYTERROR	1
-#define YYERRCODE	256
-
-
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
 
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (p, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
-/* YYLEX -- calling `yylex' with the right arguments.  */
-#ifdef YYLEX_PARAM
-# define YYLEX yylex (YYLEX_PARAM)
-#else
-# define YYLEX yylex (p)
-#endif
 
 /* Enable debugging if requested.  */
 #if YYDEBUG
@@ -673,85 +821,59 @@ while (YYID (0))
 #  define YYFPRINTF fprintf
 # endif
 
-# define YYDPRINTF(Args)			\
-do {						\
-  if (yydebug)					\
-    YYFPRINTF Args;				\
-} while (YYID (0))
-
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)			  \
-do {									  \
-  if (yydebug)								  \
-    {									  \
-      YYFPRINTF (stderr, "%s ", Title);					  \
-      yy_symbol_print (stderr,						  \
-		  Type, Value, p); \
-      YYFPRINTF (stderr, "\n");						  \
-    }									  \
-} while (YYID (0))
-
-
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
-
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, param *p)
-#else
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, p); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep, p)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-    param *p;
-#endif
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, param *p)
 {
-  FILE *yyo = yyoutput;
-  YYUSE (yyo);
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (p);
   if (!yyvaluep)
     return;
-  YYUSE (p);
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# else
-  YYUSE (yyoutput);
-# endif
-  switch (yytype)
-    {
-      default:
-        break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, param *p)
-#else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep, p)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-    param *p;
-#endif
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, param *p)
 {
-  if (yytype < YYNTOKENS)
-    YYFPRINTF (yyoutput, "token %s (", yytname[yytype]);
-  else
-    YYFPRINTF (yyoutput, "nterm %s (", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, p);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, p);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -759,16 +881,8 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, p)
 | TOP (included).                                                   |
 `------------------------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
-#else
 static void
-yy_stack_print (yybottom, yytop)
-    yytype_int16 *yybottom;
-    yytype_int16 *yytop;
-#endif
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
@@ -779,64 +893,56 @@ yy_stack_print (yybottom, yytop)
   YYFPRINTF (stderr, "\n");
 }
 
-# define YY_STACK_PRINT(Bottom, Top)				\
-do {								\
-  if (yydebug)							\
-    yy_stack_print ((Bottom), (Top));				\
-} while (YYID (0))
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
 
 
 /*------------------------------------------------.
 | Report that the YYRULE is going to be reduced.  |
 `------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_reduce_print (YYSTYPE *yyvsp, int yyrule, param *p)
-#else
 static void
-yy_reduce_print (yyvsp, yyrule, p)
-    YYSTYPE *yyvsp;
-    int yyrule;
-    param *p;
-#endif
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, param *p)
 {
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  unsigned long int yylno = yyrline[yyrule];
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
-	     yyrule - 1, yylno);
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
-      yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
-		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       		       , p);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], p);
       YYFPRINTF (stderr, "\n");
     }
 }
 
-# define YY_REDUCE_PRINT(Rule)		\
-do {					\
-  if (yydebug)				\
-    yy_reduce_print (yyvsp, Rule, p); \
-} while (YYID (0))
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, p); \
+} while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
 
 
 /* YYINITDEPTH -- initial size of the parser's stacks.  */
-#ifndef	YYINITDEPTH
+#ifndef YYINITDEPTH
 # define YYINITDEPTH 200
 #endif
 
@@ -852,365 +958,84 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
-
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static YYSIZE_T
-yystrlen (const char *yystr)
-#else
-static YYSIZE_T
-yystrlen (yystr)
-    const char *yystr;
-#endif
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-#else
-static char *
-yystpcpy (yydest, yysrc)
-    char *yydest;
-    const char *yysrc;
-#endif
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
-
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
-
-  return yyd - 1;
-}
-#  endif
-# endif
 
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-	switch (*++yyp)
-	  {
-	  case '\'':
-	  case ',':
-	    goto do_not_strip_quotes;
-
-	  case '\\':
-	    if (*++yyp != '\\')
-	      goto do_not_strip_quotes;
-	    /* Fall through.  */
-	  default:
-	    if (yyres)
-	      yyres[yyn] = *yyp;
-	    yyn++;
-	    break;
-
-	  case '"':
-	    if (yyres)
-	      yyres[yyn] = '\0';
-	    return yyn;
-	  }
-    do_not_strip_quotes: ;
-    }
 
-  if (! yyres)
-    return yystrlen (yystr);
 
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
-
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
-
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
-                yytype_int16 *yyssp, int yytoken)
-{
-  YYSIZE_T yysize0 = yytnamerr (YY_NULL, yytname[yytoken]);
-  YYSIZE_T yysize = yysize0;
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULL;
-  /* Arguments of yyformat. */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Number of reported tokens (one for the "unexpected", one per
-     "expected"). */
-  int yycount = 0;
-
-  /* There are many possibilities here to consider:
-     - Assume YYFAIL is not used.  It's too flawed to consider.  See
-       <http://lists.gnu.org/archive/html/bison-patches/2009-12/msg00024.html>
-       for details.  YYERROR is fine as it does not invoke this
-       function.
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[*yyssp];
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYSIZE_T yysize1 = yysize + yytnamerr (YY_NULL, yytname[yyx]);
-                  if (! (yysize <= yysize1
-                         && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                    return 2;
-                  yysize = yysize1;
-                }
-              }
-        }
-    }
-
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
-
-  {
-    YYSIZE_T yysize1 = yysize + yystrlen (yyformat);
-    if (! (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-      return 2;
-    yysize = yysize1;
-  }
-
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
-
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          yyp++;
-          yyformat++;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, param *p)
-#else
 static void
-yydestruct (yymsg, yytype, yyvaluep, p)
-    const char *yymsg;
-    int yytype;
-    YYSTYPE *yyvaluep;
-    param *p;
-#endif
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, param *p)
 {
-  YYUSE (yyvaluep);
-  YYUSE (p);
-
+  YY_USE (yyvaluep);
+  YY_USE (p);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
-
-  switch (yytype)
-    {
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
-      default:
-        break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
 
 
-/* The lookahead symbol.  */
-int yychar;
-
-
-#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END
-#endif
-#ifndef YY_INITIAL_VALUE
-# define YY_INITIAL_VALUE(Value) /* Nothing. */
-#endif
-
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval YY_INITIAL_VALUE(yyval_default);
-
-/* Number of syntax errors so far.  */
-int yynerrs;
 
 
 /*----------.
 | yyparse.  |
 `----------*/
 
-#ifdef YYPARSE_PARAM
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void *YYPARSE_PARAM)
-#else
-int
-yyparse (YYPARSE_PARAM)
-    void *YYPARSE_PARAM;
-#endif
-#else /* ! YYPARSE_PARAM */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 int
 yyparse (param *p)
-#else
-int
-yyparse (p)
-    param *p;
-#endif
-#endif
 {
-    int yystate;
-    /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+/* Lookahead token kind.  */
+int yychar;
 
-    /* The stacks and their tools:
-       `yyss': related to states.
-       `yyvs': related to semantic values.
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-    /* The semantic value stack.  */
-    YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    YYSIZE_T yystacksize;
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
@@ -1218,102 +1043,107 @@ yyparse (p)
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
-	/* Give user a chance to reallocate the stack.  Use copies of
-	   these so that the &'s don't force the real ones into
-	   memory.  */
-	YYSTYPE *yyvs1 = yyvs;
-	yytype_int16 *yyss1 = yyss;
-
-	/* Each stack pointer address is followed by the size of the
-	   data in use in that stack, in bytes.  This used to be a
-	   conditional around just the two extra args, but that might
-	   be undefined if yyoverflow is a macro.  */
-	yyoverflow (YY_("memory exhausted"),
-		    &yyss1, yysize * sizeof (*yyssp),
-		    &yyvs1, yysize * sizeof (*yyvsp),
-		    &yystacksize);
-
-	yyss = yyss1;
-	yyvs = yyvs1;
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-	goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
-	yystacksize = YYMAXDEPTH;
+        yystacksize = YYMAXDEPTH;
 
       {
-	yytype_int16 *yyss1 = yyss;
-	union yyalloc *yyptr =
-	  (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
-	if (! yyptr)
-	  goto yyexhaustedlab;
-	YYSTACK_RELOCATE (yyss_alloc, yyss);
-	YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
-	if (yyss1 != yyssa)
-	  YYSTACK_FREE (yyss1);
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-		  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
-	YYABORT;
+        YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
@@ -1324,18 +1154,29 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = YYLEX;
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, p);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1363,15 +1204,13 @@ yybackup:
 
   /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
   yystate = yyn;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1386,14 +1225,14 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
   yylen = yyr2[yyn];
 
   /* If YYLEN is nonzero, implement the default value of the action:
-     `$$ = $1'.
+     '$$ = $1'.
 
      Otherwise, the following line sets YYVAL to garbage.
      This behavior is undocumented and Bison
@@ -1406,117 +1245,111 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 5:
-/* Line 1792 of yacc.c  */
-#line 83 "parser.y"
-    { res=(yyvsp[(1) - (2)].dval); }
+  case 6: /* line: error '\n'  */
+#line 144 "parser.y"
+                     { yyerrok; }
+#line 1252 "parser.tab.c"
     break;
 
-  case 6:
-/* Line 1792 of yacc.c  */
-#line 84 "parser.y"
-    { yyerrok; }
+  case 7: /* expr: NUM  */
+#line 147 "parser.y"
+                     { emit_num(p->prog, (yyvsp[0].dval));              }
+#line 1258 "parser.tab.c"
     break;
 
-  case 7:
-/* Line 1792 of yacc.c  */
-#line 87 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (1)].dval);                         }
+  case 8: /* expr: VAR  */
+#line 148 "parser.y"
+                     { emit_sym(p->prog, OP_VAR, (yyvsp[0].tptr));      }
+#line 1264 "parser.tab.c"
     break;
 
-  case 8:
-/* Line 1792 of yacc.c  */
-#line 88 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (1)].tptr)->value.var;              }
+  case 9: /* expr: VAR '=' expr  */
+#line 149 "parser.y"
+                     { emit_sym(p->prog, OP_ASSIGN, (yyvsp[-2].tptr));   }
+#line 1270 "parser.tab.c"
     break;
 
-  case 9:
-/* Line 1792 of yacc.c  */
-#line 89 "parser.y"
-    { (yyval.dval) = (yyvsp[(3) - (3)].dval); (yyvsp[(1) - (3)].tptr)->value.var = (yyvsp[(3) - (3)].dval);     }
+  case 10: /* expr: FNCT '(' ')'  */
+#line 150 "parser.y"
+                     { emit_fnct(p->prog, (yyvsp[-2].tptr)->value.fnctptr, 0); }
+#line 1276 "parser.tab.c"
     break;
 
-  case 10:
-/* Line 1792 of yacc.c  */
-#line 90 "parser.y"
-    { (yyval.dval) = (*((yyvsp[(1) - (3)].tptr)->value.fnctptr))();   }
+  case 11: /* expr: FNCT '(' expr ')'  */
+#line 151 "parser.y"
+                     { emit_fnct(p->prog, (yyvsp[-3].tptr)->value.fnctptr, 1); }
+#line 1282 "parser.tab.c"
     break;
 
-  case 11:
-/* Line 1792 of yacc.c  */
-#line 91 "parser.y"
-    { (yyval.dval) = (*((yyvsp[(1) - (4)].tptr)->value.fnctptr))((yyvsp[(3) - (4)].dval)); }
+  case 12: /* expr: FNCT '(' expr ',' expr ')'  */
+#line 152 "parser.y"
+                              { emit_fnct(p->prog, (yyvsp[-5].tptr)->value.fnctptr, 2); }
+#line 1288 "parser.tab.c"
     break;
 
-  case 12:
-/* Line 1792 of yacc.c  */
-#line 92 "parser.y"
-    { (yyval.dval) = (*((yyvsp[(1) - (6)].tptr)->value.fnctptr))((yyvsp[(3) - (6)].dval),(yyvsp[(5) - (6)].dval)); }
+  case 13: /* expr: FNCT '(' expr ',' expr ',' expr ')'  */
+#line 153 "parser.y"
+                                      { emit_fnct(p->prog, (yyvsp[-7].tptr)->value.fnctptr, 3); }
+#line 1294 "parser.tab.c"
     break;
 
-  case 13:
-/* Line 1792 of yacc.c  */
-#line 93 "parser.y"
-    { (yyval.dval) = (*((yyvsp[(1) - (8)].tptr)->value.fnctptr))((yyvsp[(3) - (8)].dval),(yyvsp[(5) - (8)].dval),(yyvsp[(7) - (8)].dval)); }
+  case 14: /* expr: FNCT '(' expr ',' expr ',' expr ',' expr ')'  */
+#line 154 "parser.y"
+                                               { emit_fnct(p->prog, (yyvsp[-9].tptr)->value.fnctptr, 4); }
+#line 1300 "parser.tab.c"
     break;
 
-  case 14:
-/* Line 1792 of yacc.c  */
-#line 94 "parser.y"
-    { (yyval.dval) = (*((yyvsp[(1) - (10)].tptr)->value.fnctptr))((yyvsp[(3) - (10)].dval),(yyvsp[(5) - (10)].dval),(yyvsp[(7) - (10)].dval),(yyvsp[(9) - (10)].dval)); }
+  case 15: /* expr: expr '+' expr  */
+#line 155 "parser.y"
+                     { emit_op(p->prog, OP_ADD);           }
+#line 1306 "parser.tab.c"
     break;
 
-  case 15:
-/* Line 1792 of yacc.c  */
-#line 95 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (3)].dval) + (yyvsp[(3) - (3)].dval);                    }
+  case 16: /* expr: expr '-' expr  */
+#line 156 "parser.y"
+                     { emit_op(p->prog, OP_SUB);           }
+#line 1312 "parser.tab.c"
     break;
 
-  case 16:
-/* Line 1792 of yacc.c  */
-#line 96 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (3)].dval) - (yyvsp[(3) - (3)].dval);                    }
+  case 17: /* expr: expr '*' expr  */
+#line 157 "parser.y"
+                     { emit_op(p->prog, OP_MUL);           }
+#line 1318 "parser.tab.c"
     break;
 
-  case 17:
-/* Line 1792 of yacc.c  */
-#line 97 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (3)].dval) * (yyvsp[(3) - (3)].dval);                    }
+  case 18: /* expr: expr '/' expr  */
+#line 158 "parser.y"
+                     { emit_op(p->prog, OP_DIV);           }
+#line 1324 "parser.tab.c"
     break;
 
-  case 18:
-/* Line 1792 of yacc.c  */
-#line 98 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (3)].dval) / (yyvsp[(3) - (3)].dval);                    }
+  case 19: /* expr: '-' expr  */
+#line 159 "parser.y"
+                     { emit_op(p->prog, OP_NEG);           }
+#line 1330 "parser.tab.c"
     break;
 
-  case 19:
-/* Line 1792 of yacc.c  */
-#line 99 "parser.y"
-    { (yyval.dval) = -(yyvsp[(2) - (2)].dval);                        }
+  case 20: /* expr: expr '^' expr  */
+#line 160 "parser.y"
+                     { emit_op(p->prog, OP_POW);           }
+#line 1336 "parser.tab.c"
     break;
 
-  case 20:
-/* Line 1792 of yacc.c  */
-#line 100 "parser.y"
-    { (yyval.dval) = pow ((yyvsp[(1) - (3)].dval), (yyvsp[(3) - (3)].dval));               }
+  case 21: /* expr: expr '*' '*' expr  */
+#line 161 "parser.y"
+                     { emit_op(p->prog, OP_POW);           }
+#line 1342 "parser.tab.c"
     break;
 
-  case 21:
-/* Line 1792 of yacc.c  */
-#line 101 "parser.y"
-    { (yyval.dval) = pow ((yyvsp[(1) - (4)].dval), (yyvsp[(4) - (4)].dval));               }
+  case 22: /* expr: '(' expr ')'  */
+#line 162 "parser.y"
+                     { }
+#line 1348 "parser.tab.c"
     break;
 
-  case 22:
-/* Line 1792 of yacc.c  */
-#line 102 "parser.y"
-    { (yyval.dval) = (yyvsp[(2) - (3)].dval);                         }
-    break;
 
+#line 1352 "parser.tab.c"
 
-/* Line 1792 of yacc.c  */
-#line 1520 "parser.tab.c"
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1530,96 +1363,58 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
-  /* Now `shift' the result of the reduction.  Determine what state
+  /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
 
-/*------------------------------------.
-| yyerrlab -- here on detecting error |
-`------------------------------------*/
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (p, YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-      {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
-          {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = (char *) YYSTACK_ALLOC (yymsg_alloc);
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
-              {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
-              }
-          }
-        yyerror (p, yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
-	 error, discard it.  */
+         error, discard it.  */
 
       if (yychar <= YYEOF)
-	{
-	  /* Return failure if at end of input.  */
-	  if (yychar == YYEOF)
-	    YYABORT;
-	}
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
       else
-	{
-	  yydestruct ("Error: discarding",
-		      yytoken, &yylval, p);
-	  yychar = YYEMPTY;
-	}
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, p);
+          yychar = YYEMPTY;
+        }
     }
 
   /* Else will try to reuse lookahead token after shifting the error
@@ -1631,14 +1426,13 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
-
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
   YYPOPSTACK (yylen);
   yylen = 0;
@@ -1651,29 +1445,30 @@ yyerrorlab:
 | yyerrlab1 -- common code for both syntax error and YYERROR.  |
 `-------------------------------------------------------------*/
 yyerrlab1:
-  yyerrstatus = 3;	/* Each real token shifted decrements this.  */
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
-	{
-	  yyn += YYTERROR;
-	  if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
-	    {
-	      yyn = yytable[yyn];
-	      if (0 < yyn)
-		break;
-	    }
-	}
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
 
       /* Pop the current state because it cannot handle the error token.  */
       if (yyssp == yyss)
-	YYABORT;
+        YYABORT;
 
 
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp, p);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, p);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -1685,7 +1480,7 @@ yyerrlab1:
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -1696,26 +1491,30 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (p, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
-yyreturn:
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -1724,49 +1523,49 @@ yyreturn:
       yydestruct ("Cleanup: discarding lookahead",
                   yytoken, &yylval, p);
     }
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
   YYPOPSTACK (yylen);
   YY_STACK_PRINT (yyss, yyssp);
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp, p);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, p);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
-  /* Make sure YYID is used.  */
-  return YYID (yyresult);
-}
 
+  return yyresult;
+}
 
-/* Line 2055 of yacc.c  */
-#line 105 "parser.y"
+#line 165 "parser.y"
 
 
-/* global symbol table */
-symrec *sym_table = 0;
-
-int parse_errors() {
-	return yynerrs;
-}
+/* context used by the functions without context argument (not thread-safe) */
+static parser_context *default_context = 0;
 
 int yyerror(param *p, const char *s) {
+	p->ctx->errors++;
 	/* remove trailing newline */
 	p->string[strcspn(p->string, "\n")] = 0;
 	printf("PARSER ERROR: %s @ position %d of string \'%s\'\n", s, p->pos, p->string);
 	return 0;
 }
 
+/* bucket of the symbol in the symbol table (djb2 hash) */
+static unsigned int hash(const char *sym_name) {
+	unsigned int h = 5381;
+	while (*sym_name)
+		h = 33*h + (unsigned char)*sym_name++;
+
+	return h & (PARSER_HASH_SIZE - 1);
+}
+
 /* save symbol in symbol table */
-symrec* putsym(const char *sym_name, int sym_type) {
+symrec* putsym(parser_context *ctx, const char *sym_name, int sym_type) {
 	pdebug("PARSER: putsym(): sym_name = %s\n", sym_name);
 
 	symrec *ptr = (symrec *) malloc(sizeof (symrec));
@@ -1774,19 +1573,21 @@ symrec* putsym(const char *sym_name, int sym_type) {
 	strcpy(ptr->name, sym_name);
 	ptr->type = sym_type;
 	ptr->value.var = 0;	/* set value to 0 even if fctn */
-	ptr->next = (struct symrec *)sym_table;
-	sym_table = ptr;
+	/* new symbols hide older ones with the same name */
+	const unsigned int bucket = hash(sym_name);
+	ptr->next = (struct symrec *)ctx->sym_table[bucket];
+	ctx->sym_table[bucket] = ptr;
 	
 	pdebug("PARSER: putsym() DONE\n");
 	return ptr;
 }
 
 /* get symbol from symbol table */
-symrec* getsym(const char *sym_name) {
+symrec* getsym(parser_context *ctx, const char *sym_name) {
 	pdebug("PARSER: getsym(): sym_name = %s\n", sym_name);
 	
 	symrec *ptr;
-	for (ptr = sym_table; ptr != 0; ptr = (symrec *)ptr->next) {
+	for (ptr = ctx->sym_table[hash(sym_name)]; ptr != 0; ptr = (symrec *)ptr->next) {
 		/* pdebug("%s ", ptr->name); */
 		if (strcmp(ptr->name, sym_name) == 0) {
 			pdebug("PARSER: symbol \'%s\' found\n", sym_name);
@@ -1798,51 +1599,86 @@ symrec* getsym(const char *sym_name) {
 	return 0;
 }
 
-void init_table(void) {
-	pdebug("PARSER: init_table()\n");
+/* create a new context with a symbol table containing all functions and constants */
+parser_context* parser_context_new(void) {
+	pdebug("PARSER: parser_context_new()\n");
+
+	parser_context *ctx = (parser_context *) calloc(1, sizeof(parser_context));
 
 	symrec *ptr = 0;
 	int i;
 	/* add functions */
 	for (i = 0; _functions[i].name != 0; i++) {
-		ptr = putsym (_functions[i].name, FNCT);
+		ptr = putsym(ctx, _functions[i].name, FNCT);
 		ptr->value.fnctptr = _functions[i].fnct;
 	}
 	/* add constants */
 	for (i = 0; _constants[i].name != 0; i++) {
-		ptr = putsym (_constants[i].name, VAR);
+		ptr = putsym(ctx, _constants[i].name, VAR);
 		ptr->value.var = _constants[i].value;
 	}
 
-	pdebug("PARSER: init_table() DONE sym_table = %p\n", ptr);
+	pdebug("PARSER: parser_context_new() DONE ctx = %p\n", ctx);
+	return ctx;
 }
 
-void delete_table(void) {
-	while(sym_table) {
-		symrec *tmp = sym_table;
-		sym_table = sym_table->next;
-		free(tmp->name);
-		free(tmp);
+/* delete the context and its symbol table. Programs compiled in this context can't be used anymore. */
+void parser_context_free(parser_context *ctx) {
+	if (!ctx)
+		return;
+
+	int i;
+	for (i = 0; i < PARSER_HASH_SIZE; i++) {
+		while(ctx->sym_table[i]) {
+			symrec *tmp = ctx->sym_table[i];
+			ctx->sym_table[i] = ctx->sym_table[i]->next;
+			free(tmp->name);
+			free(tmp);
+		}
 	}
+	free(ctx);
 }
 
-symrec* assign_variable(const char* symb_name, double value) {
-	/* new style: pdebug("PARSER: assign_variable(): symb_name = %s value = %g sym_table = %p\n", var.name, var.value, sym_table);*/
-	pdebug("PARSER: assign_variable() : symb_name = %s value=%g\n", symb_name, value);
+int parser_context_errors(const parser_context *ctx) {
+	return ctx->errors;
+}
 
-	/* be sure that the symbol table has been initialized */
-	if (!sym_table)
-		init_table();
+symrec* parser_context_assign_variable(parser_context *ctx, const char* symb_name, double value) {
+	pdebug("PARSER: parser_context_assign_variable() : symb_name = %s value=%g\n", symb_name, value);
 
-	symrec* ptr = getsym(symb_name);
+	symrec* ptr = getsym(ctx, symb_name);
 	if (!ptr) {
 		pdebug("PARSER: calling putsym(): symb_name = %s\n", symb_name);
-		ptr = putsym(symb_name, VAR);
+		ptr = putsym(ctx, symb_name, VAR);
 	}
 	ptr->value.var = value;
 
 	return ptr;
-};
+}
+
+/* functions using the default context */
+void init_table(void) {
+	pdebug("PARSER: init_table()\n");
+
+	if (!default_context)
+		default_context = parser_context_new();
+}
+
+void delete_table(void) {
+	parser_context_free(default_context);
+	default_context = 0;
+}
+
+int parse_errors() {
+	return default_context ? default_context->errors : 0;
+}
+
+symrec* assign_variable(const char* symb_name, double value) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+
+	return parser_context_assign_variable(default_context, symb_name, value);
+}
 
 static int getcharstr(param *p) {
 	pdebug("PARSER: getcharstr() pos = %d\n", p->pos);
@@ -1858,12 +1694,123 @@ static void ungetcstr(unsigned int *pos) {
         (*pos)--;
 }
 
-double parse(const char *str) {
-	pdebug("\nPARSER: parse(\"%s\") len=%zu\n", str, strlen(str));
+/* append an instruction that changes the stack depth by "push" */
+static instr* emit(parser_program *prog, opcode op, int push) {
+	if (prog->length == prog->size) {
+		prog->size = prog->size ? 2*prog->size : 16;
+		prog->code = (instr *) realloc(prog->code, prog->size * sizeof(instr));
+	}
 
-	/* be sure that the symbol table has been initialized */
-	if (!sym_table)
-		init_table();
+	instr *in = &prog->code[prog->length++];
+	in->op = op;
+	in->nargs = 0;
+
+	prog->sp += push;
+	if (prog->sp > prog->depth)
+		prog->depth = prog->sp;
+
+	return in;
+}
+
+static void emit_num(parser_program *prog, double value) {
+	emit(prog, OP_NUM, 1)->arg.num = value;
+}
+
+static void emit_sym(parser_program *prog, opcode op, symrec *sym) {
+	emit(prog, op, op == OP_VAR ? 1 : 0)->arg.sym = sym;
+}
+
+static void emit_op(parser_program *prog, opcode op);
+
+static void emit_fnct(parser_program *prog, func_t fnct, int nargs) {
+	/* functions with an own instruction */
+	if (nargs == 1 && fnct == (func_t) sqrt) {
+		emit_op(prog, OP_SQRT);
+		return;
+	}
+	if (nargs == 1 && fnct == (func_t) fabs) {
+		emit_op(prog, OP_FABS);
+		return;
+	}
+	if (nargs == 2 && fnct == (func_t) pow) {
+		emit_op(prog, OP_POW);
+		return;
+	}
+
+	instr *in = emit(prog, OP_FNCT, 1 - nargs);
+	in->arg.fnct = fnct;
+	in->nargs = nargs;
+}
+
+static double apply_op(opcode op, double a, double b) {
+	switch (op) {
+	case OP_ADD:
+		return a + b;
+	case OP_SUB:
+		return a - b;
+	case OP_MUL:
+		return a * b;
+	case OP_DIV:
+		return a / b;
+	case OP_POW:
+		return pow(a, b);
+	case OP_NEG:
+		return -a;
+	case OP_SQRT:
+		return sqrt(a);
+	case OP_FABS:
+		return fabs(a);
+	case OP_NUM:
+	case OP_VAR:
+	case OP_ASSIGN:
+	case OP_FNCT:
+		break;
+	}
+
+	return NAN;
+}
+
+static void emit_op(parser_program *prog, opcode op) {
+	instr *code = prog->code;
+	const int n = prog->length;
+
+	/* fold operations on numbers (the operands are the last instructions) */
+	if (IS_UNARY(op) && n > 0 && code[n-1].op == OP_NUM) {
+		code[n-1].arg.num = apply_op(op, code[n-1].arg.num, 0);
+		return;
+	}
+	if (!IS_UNARY(op) && n > 1 && code[n-1].op == OP_NUM && code[n-2].op == OP_NUM) {
+		code[n-2].arg.num = apply_op(op, code[n-2].arg.num, code[n-1].arg.num);
+		prog->length--;
+		prog->sp--;
+		return;
+	}
+
+	emit(prog, op, IS_UNARY(op) ? 0 : -1);
+}
+
+static double call_fnct(func_t fnct, int nargs, const double *args) {
+	switch (nargs) {
+	case 0:
+		return (*fnct)();
+	case 1:
+		return (*fnct)(args[0]);
+	case 2:
+		return (*fnct)(args[0], args[1]);
+	case 3:
+		return (*fnct)(args[0], args[1], args[2]);
+	case 4:
+		return (*fnct)(args[0], args[1], args[2], args[3]);
+	}
+
+	return NAN;
+}
+
+/* parse the expression once and return the compiled program (0 on parse errors).
+   The program refers to the symbols of the context's symbol table: variables are read
+   when evaluating the program, so the variables can be assigned between evaluations. */
+parser_program* parser_context_compile(parser_context *ctx, const char *str) {
+	pdebug("\nPARSER: parser_context_compile(\"%s\") len=%zu\n", str, strlen(str));
 
 	param p;
 	p.pos = 0;
@@ -1875,16 +1822,496 @@ double parse(const char *str) {
 	p.string[strlen(p.string)] = '\n';
 	pdebug("\nPARSER: yyparse(\"%s\") len=%zu\n", p.string, strlen(p.string));
 
+	p.ctx = ctx;
+	p.prog = (parser_program *) calloc(1, sizeof(parser_program));
+	p.symbuf = 0;
+	p.symlength = 0;
+
 	/* parameter for yylex */
+	ctx->errors = 0;
 	yyparse(&p);
 
-	pdebug("PARSER: parse() DONE (res = %g, parse errors = %d)\n", res, parse_errors());
+	pdebug("PARSER: parser_context_compile() DONE (instructions = %d, parse errors = %d)\n", p.prog->length, ctx->errors);
 	free(p.string);
 	p.string = 0;
+	free(p.symbuf);
+
+	if (ctx->errors > 0) {
+		program_free(p.prog);
+		return 0;
+	}
+
+	return p.prog;
+}
+
+parser_program* parse_compile(const char *str) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+
+	return parser_context_compile(default_context, str);
+}
+
+/* evaluate a compiled program with the current values of the variables */
+double program_eval(const parser_program *prog) {
+	double buffer[PARSER_STACK_SIZE];
+	double *stack = buffer;
+	int sp = 0, i;
+
+	if (prog->depth > PARSER_STACK_SIZE)
+		stack = (double *) malloc(prog->depth * sizeof(double));
+
+	for (i = 0; i < prog->length; i++) {
+		const instr *in = &prog->code[i];
+		switch (in->op) {
+		case OP_NUM:
+			stack[sp++] = in->arg.num;
+			break;
+		case OP_VAR:
+			stack[sp++] = in->arg.sym->value.var;
+			break;
+		case OP_ASSIGN:
+			in->arg.sym->value.var = stack[sp-1];
+			break;
+		case OP_FNCT:
+			sp -= in->nargs;
+			stack[sp] = call_fnct(in->arg.fnct, in->nargs, &stack[sp]);
+			sp++;
+			break;
+		case OP_ADD:
+			sp--;
+			stack[sp-1] += stack[sp];
+			break;
+		case OP_SUB:
+			sp--;
+			stack[sp-1] -= stack[sp];
+			break;
+		case OP_MUL:
+			sp--;
+			stack[sp-1] *= stack[sp];
+			break;
+		case OP_DIV:
+			sp--;
+			stack[sp-1] /= stack[sp];
+			break;
+		case OP_POW:
+			sp--;
+			stack[sp-1] = pow(stack[sp-1], stack[sp]);
+			break;
+		case OP_NEG:
+			stack[sp-1] = -stack[sp-1];
+			break;
+		case OP_SQRT:
+			stack[sp-1] = sqrt(stack[sp-1]);
+			break;
+		case OP_FABS:
+			stack[sp-1] = fabs(stack[sp-1]);
+			break;
+		}
+	}
+
+	/* result of the last line (empty expression: NAN) */
+	double result = sp > 0 ? stack[sp-1] : NAN;
+	if (stack != buffer)
+		free(stack);
+
+	return result;
+}
+
+/* apply the binary or unary operator to the blocks a (result) and b of length m */
+static void batch_op(opcode op, double * restrict a, const double * restrict b, int m) {
+	int k;
+	switch (op) {
+	case OP_ADD:
+		for (k = 0; k < m; k++)
+			a[k] += b[k];
+		break;
+	case OP_SUB:
+		for (k = 0; k < m; k++)
+			a[k] -= b[k];
+		break;
+	case OP_MUL:
+		for (k = 0; k < m; k++)
+			a[k] *= b[k];
+		break;
+	case OP_DIV:
+		for (k = 0; k < m; k++)
+			a[k] /= b[k];
+		break;
+	case OP_POW:
+		for (k = 0; k < m; k++)
+			a[k] = pow(a[k], b[k]);
+		break;
+	case OP_NEG:
+		for (k = 0; k < m; k++)
+			a[k] = -a[k];
+		break;
+	case OP_SQRT:
+		for (k = 0; k < m; k++)
+			a[k] = sqrt(a[k]);
+		break;
+	case OP_FABS:
+		for (k = 0; k < m; k++)
+			a[k] = fabs(a[k]);
+		break;
+	case OP_NUM:
+	case OP_VAR:
+	case OP_ASSIGN:
+	case OP_FNCT:
+		break;
+	}
+}
+
+/* call the function for the blocks of arguments (the result is written to args) */
+static void batch_fnct(func_t fnct, int nargs, double *args, int m) {
+	const double *a1 = args + PARSER_BATCH_SIZE;
+	const double *a2 = args + 2*PARSER_BATCH_SIZE;
+	const double *a3 = args + 3*PARSER_BATCH_SIZE;
+	int k;
+
+	switch (nargs) {
+	case 0:
+		for (k = 0; k < m; k++)
+			args[k] = (*fnct)();
+		break;
+	case 1: {
+		double (*f)(double) = (double (*)(double)) fnct;
+		for (k = 0; k < m; k++)
+			args[k] = f(args[k]);
+		break;
+	}
+	case 2: {
+		double (*f)(double, double) = (double (*)(double, double)) fnct;
+		for (k = 0; k < m; k++)
+			args[k] = f(args[k], a1[k]);
+		break;
+	}
+	case 3:
+		for (k = 0; k < m; k++)
+			args[k] = (*fnct)(args[k], a1[k], a2[k]);
+		break;
+	case 4:
+		for (k = 0; k < m; k++)
+			args[k] = (*fnct)(args[k], a1[k], a2[k], a3[k]);
+		break;
+	}
+}
+
+/* evaluate the program for n points: for point k the variable vars[j] has the value values[j][k],
+   the result is written to result[k]. All other variables keep their current value.
+   The points are evaluated in blocks, every instruction is a loop over a block. */
+void program_eval_batch(const parser_program *prog, symrec * const vars[], const double * const values[], int nvars, int n, double *result) {
+	int i, j, k, start;
+
+	/* assignments change variables from point to point: evaluate sequentially */
+	for (i = 0; i < prog->length; i++) {
+		if (prog->code[i].op == OP_ASSIGN) {
+			for (k = 0; k < n; k++) {
+				for (j = 0; j < nvars; j++)
+					vars[j]->value.var = values[j][k];
+				result[k] = program_eval(prog);
+			}
+			return;
+		}
+	}
+
+	/* index of the data of all variables (-1: use the current value) */
+	int *index = (int *) malloc((prog->length + 1) * sizeof(int));
+	for (i = 0; i < prog->length; i++) {
+		index[i] = -1;
+		if (prog->code[i].op != OP_VAR)
+			continue;
+		for (j = 0; j < nvars; j++)
+			if (prog->code[i].arg.sym == vars[j])
+				index[i] = j;
+	}
 
+	double *stack = (double *) malloc((prog->depth + 1) * PARSER_BATCH_SIZE * sizeof(double));
+	for (start = 0; start < n; start += PARSER_BATCH_SIZE) {
+		const int m = (n - start < PARSER_BATCH_SIZE) ? n - start : PARSER_BATCH_SIZE;
+		int sp = 0;
+
+		for (i = 0; i < prog->length; i++) {
+			const instr *in = &prog->code[i];
+			double *top = stack + sp*PARSER_BATCH_SIZE;
+			switch (in->op) {
+			case OP_NUM:
+				for (k = 0; k < m; k++)
+					top[k] = in->arg.num;
+				sp++;
+				break;
+			case OP_VAR:
+				if (index[i] >= 0)
+					memcpy(top, values[index[i]] + start, m * sizeof(double));
+				else
+					for (k = 0; k < m; k++)
+						top[k] = in->arg.sym->value.var;
+				sp++;
+				break;
+			case OP_ASSIGN:
+				break;
+			case OP_FNCT:
+				sp -= in->nargs;
+				batch_fnct(in->arg.fnct, in->nargs, stack + sp*PARSER_BATCH_SIZE, m);
+				sp++;
+				break;
+			case OP_NEG:
+			case OP_SQRT:
+			case OP_FABS:
+				batch_op(in->op, top - PARSER_BATCH_SIZE, 0, m);
+				break;
+			case OP_ADD:
+			case OP_SUB:
+			case OP_MUL:
+			case OP_DIV:
+			case OP_POW:
+				sp--;
+				batch_op(in->op, top - 2*PARSER_BATCH_SIZE, top - PARSER_BATCH_SIZE, m);
+				break;
+			}
+		}
+
+		/* result of the last line (empty expression: NAN) */
+		if (sp > 0)
+			memcpy(result + start, stack + (sp-1)*PARSER_BATCH_SIZE, m * sizeof(double));
+		else
+			for (k = 0; k < m; k++)
+				result[start + k] = NAN;
+	}
+
+	free(stack);
+	free(index);
+}
+
+/* derivative of the function of one argument at x if it is known analytically */
+static int fnct_deriv(func_t fnct, double x, double *deriv) {
+	if (fnct == (func_t) gsl_sf_sin)
+		*deriv = cos(x);
+	else if (fnct == (func_t) gsl_sf_cos)
+		*deriv = -sin(x);
+	else if (fnct == (func_t) tan)
+		*deriv = 1./gsl_pow_2(cos(x));
+	else if (fnct == (func_t) gsl_sf_exp || fnct == (func_t) gsl_expm1)
+		*deriv = exp(x);
+	else if (fnct == (func_t) gsl_sf_log)
+		*deriv = 1./x;
+	else if (fnct == (func_t) log10)
+		*deriv = 1./(x*M_LN10);
+	else if (fnct == (func_t) gsl_log1p)
+		*deriv = 1./(1. + x);
+	else if (fnct == (func_t) sinh)
+		*deriv = cosh(x);
+	else if (fnct == (func_t) cosh)
+		*deriv = sinh(x);
+	else if (fnct == (func_t) tanh)
+		*deriv = 1. - gsl_pow_2(tanh(x));
+	else if (fnct == (func_t) asin)
+		*deriv = 1./sqrt(1. - x*x);
+	else if (fnct == (func_t) acos)
+		*deriv = -1./sqrt(1. - x*x);
+	else if (fnct == (func_t) atan)
+		*deriv = 1./(1. + x*x);
+	else if (fnct == (func_t) gsl_asinh)
+		*deriv = 1./sqrt(x*x + 1.);
+	else if (fnct == (func_t) gsl_acosh)
+		*deriv = 1./sqrt(x*x - 1.);
+	else if (fnct == (func_t) gsl_atanh)
+		*deriv = 1./(1. - x*x);
+	else if (fnct == (func_t) gsl_sf_erf)
+		*deriv = M_2_SQRTPI*exp(-x*x);
+	else if (fnct == (func_t) gsl_sf_erfc)
+		*deriv = -M_2_SQRTPI*exp(-x*x);
+	else if (fnct == (func_t) gsl_pow_2)
+		*deriv = 2.*x;
+	else if (fnct == (func_t) gsl_pow_3)
+		*deriv = 3.*x*x;
+	else
+		return 0;
+
+	return 1;
+}
+
+/* call the function with the arguments args[k*stride] (k < nargs) and calculate the derivatives
+   of the result from the derivatives args[k*stride + 1 + j] of the arguments (chain rule).
+   Value and derivatives of the result are stored in place of the first argument. */
+static void deriv_fnct(func_t fnct, int nargs, double *args, int stride) {
+	double x[4], xh[4], df[4];
+	int j, k;
+
+	for (k = 0; k < nargs; k++)
+		x[k] = args[k*stride];
+	const double value = call_fnct(fnct, nargs, x);
+
+	/* partial derivatives of the function */
+	if (nargs != 1 || !fnct_deriv(fnct, x[0], &df[0])) {
+		for (k = 0; k < nargs; k++) {
+			df[k] = 0;
+			/* only needed if the argument depends on the variables */
+			int dependent = 0;
+			for (j = 1; j < stride; j++)
+				if (args[k*stride + j] != 0)
+					dependent = 1;
+			if (!dependent)
+				continue;
+
+			/* central difference */
+			const double h = 6.e-6*GSL_MAX(fabs(x[k]), 1.);
+			memcpy(xh, x, nargs * sizeof(double));
+			xh[k] = x[k] + h;
+			const double fp = call_fnct(fnct, nargs, xh);
+			xh[k] = x[k] - h;
+			const double fm = call_fnct(fnct, nargs, xh);
+			df[k] = (fp - fm)/(2.*h);
+		}
+	}
+
+	/* chain rule (only the j-th derivatives are read when writing the j-th derivative) */
+	for (j = 1; j < stride; j++) {
+		double d = 0;
+		for (k = 0; k < nargs; k++)
+			if (args[k*stride + j] != 0)
+				d += df[k]*args[k*stride + j];
+		args[j] = d;
+	}
+	args[0] = value;
+}
+
+/* evaluate the program and the derivatives grad[j] of the result with respect to the variables wrt[j]
+   (forward mode automatic differentiation). The derivatives are exact except for functions without
+   known derivative, which are differentiated numerically. */
+double program_eval_deriv(const parser_program *prog, symrec * const wrt[], int nwrt, double *grad) {
+	const int stride = nwrt + 1;	/* size of a stack entry: value and derivatives */
+	double buffer[PARSER_STACK_SIZE];
+	double *stack = buffer;
+	int sp = 0, i, j;
+
+	if ((prog->depth + 1) * stride > PARSER_STACK_SIZE)
+		stack = (double *) malloc((prog->depth + 1) * stride * sizeof(double));
+
+	for (i = 0; i < prog->length; i++) {
+		const instr *in = &prog->code[i];
+		double *top = stack + sp*stride;	/* next free entry */
+		double *a = top - 2*stride, *b = top - stride;	/* operands of binary operators */
+		switch (in->op) {
+		case OP_NUM:
+			top[0] = in->arg.num;
+			for (j = 0; j < nwrt; j++)
+				top[1+j] = 0;
+			sp++;
+			break;
+		case OP_VAR:
+			top[0] = in->arg.sym->value.var;
+			for (j = 0; j < nwrt; j++)
+				top[1+j] = (in->arg.sym == wrt[j]) ? 1. : 0.;
+			sp++;
+			break;
+		case OP_ASSIGN:
+			in->arg.sym->value.var = b[0];
+			break;
+		case OP_FNCT:
+			sp -= in->nargs;
+			if (in->nargs == 0) {
+				top[0] = call_fnct(in->arg.fnct, 0, 0);
+				for (j = 0; j < nwrt; j++)
+					top[1+j] = 0;
+			} else
+				deriv_fnct(in->arg.fnct, in->nargs, stack + sp*stride, stride);
+			sp++;
+			break;
+		case OP_ADD:
+			sp--;
+			for (j = 0; j < stride; j++)
+				a[j] += b[j];
+			break;
+		case OP_SUB:
+			sp--;
+			for (j = 0; j < stride; j++)
+				a[j] -= b[j];
+			break;
+		case OP_MUL:
+			sp--;
+			for (j = 1; j < stride; j++)
+				a[j] = a[j]*b[0] + a[0]*b[j];
+			a[0] *= b[0];
+			break;
+		case OP_DIV:
+			sp--;
+			a[0] /= b[0];
+			for (j = 1; j < stride; j++)
+				a[j] = (a[j] - a[0]*b[j])/b[0];
+			break;
+		case OP_POW: {
+			sp--;
+			const double value = pow(a[0], b[0]);
+			for (j = 1; j < stride; j++) {
+				double d = 0;
+				if (a[j] != 0)
+					d += b[0]*pow(a[0], b[0] - 1.)*a[j];
+				if (b[j] != 0)
+					d += value*log(a[0])*b[j];
+				a[j] = d;
+			}
+			a[0] = value;
+			break;
+		}
+		case OP_NEG:
+			for (j = 0; j < stride; j++)
+				b[j] = -b[j];
+			break;
+		case OP_SQRT:
+			b[0] = sqrt(b[0]);
+			for (j = 1; j < stride; j++)
+				b[j] /= 2.*b[0];
+			break;
+		case OP_FABS:
+			if (b[0] < 0)
+				for (j = 0; j < stride; j++)
+					b[j] = -b[j];
+			break;
+		}
+	}
+
+	/* result of the last line (empty expression: NAN) */
+	double result = NAN;
+	for (j = 0; j < nwrt; j++)
+		grad[j] = (sp > 0) ? stack[(sp-1)*stride + 1 + j] : 0;
+	if (sp > 0)
+		result = stack[(sp-1)*stride];
+
+	if (stack != buffer)
+		free(stack);
+
+	return result;
+}
+
+void program_free(parser_program *prog) {
+	if (!prog)
+		return;
+
+	free(prog->code);
+	free(prog);
+}
+
+double parser_context_parse(parser_context *ctx, const char *str) {
+	pdebug("\nPARSER: parser_context_parse(\"%s\") len=%zu\n", str, strlen(str));
+
+	parser_program *prog = parser_context_compile(ctx, str);
+	if (!prog)
+		return NAN;
+
+	double res = program_eval(prog);
+	program_free(prog);
+
+	pdebug("PARSER: parser_context_parse() DONE (res = %g)\n", res);
 	return res;
 }
 
+double parse(const char *str) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+
+	return parser_context_parse(default_context, str);
+}
+
 double parse_with_vars(const char *str, const parser_var *vars, int nvars) {
 	pdebug("\nPARSER: parse_with_var(\"%s\") len=%zu\n", str, strlen(str));
 	int i;
@@ -1896,7 +2323,7 @@ double parse_with_vars(const char *str, const parser_var *vars, int nvars) {
 	return parse(str);
 }
 
-int yylex(param *p) {
+int yylex(YYSTYPE *lvalp, param *p) {
 	pdebug("PARSER: yylex()\n");
 	int c;
 
@@ -1911,7 +2338,7 @@ int yylex(param *p) {
 	/* check for non-ASCII chars */
 	if (!isascii(c)) {
 		pdebug("non-ASCII character found. Giving up\n");
-		yynerrs++;
+		p->ctx->errors++;
 		return 0;
 	}
 
@@ -1943,7 +2370,7 @@ int yylex(param *p) {
 
 		pdebug("PARSER: result = %g\n", result);
 
-		yylval.dval = result;
+		lvalp->dval = result;
 
                 p->pos += strlen(s) - strlen(remain);
 
@@ -1952,22 +2379,20 @@ int yylex(param *p) {
 
 	if (isalpha (c) || c == '.') {
 		pdebug("PARSER: reading identifier (starts with alpha: %c)\n", c);
-		static char *symbuf = 0;
-		static int length = 0;
 		int i = 0;
 
 		/* Initially make the buffer long enough for a 10-character symbol name */
-		if (length == 0)
-			length = 10, symbuf = (char *) malloc(length + 1);
+		if (p->symlength == 0)
+			p->symlength = 10, p->symbuf = (char *) malloc(p->symlength + 1);
 
 		do {
 			pdebug("reading symbol .. ");
 			/* If buffer is full, make it bigger */
-			if (i == length) {
-				length *= 2;
-				symbuf = (char *) realloc(symbuf, length + 1);
+			if (i == p->symlength) {
+				p->symlength *= 2;
+				p->symbuf = (char *) realloc(p->symbuf, p->symlength + 1);
 			}
-			symbuf[i++] = c;
+			p->symbuf[i++] = c;
 			c = getcharstr(p);
 			pdebug("got %c\n", c);
 		}
@@ -1976,19 +2401,19 @@ int yylex(param *p) {
 
 		if (c != EOF)
 			ungetcstr(&(p->pos));
-		symbuf[i] = '\0';
+		p->symbuf[i] = '\0';
 
-		symrec *s = getsym(symbuf);
+		symrec *s = getsym(p->ctx, p->symbuf);
 		if(s == 0) {	/* symbol unknown */
-			pdebug("PARSER: ERROR: symbol \"%s\" UNKNOWN\n", symbuf);
-			yynerrs++;
+			pdebug("PARSER: ERROR: symbol \"%s\" UNKNOWN\n", p->symbuf);
+			p->ctx->errors++;
 			return 0;
 		}
 		/* old behavior */
 		/* if (s == 0)
-			 s = putsym (symbuf, VAR);
+			 s = putsym (p->ctx, p->symbuf, VAR);
 		*/
-		yylval.tptr = s;
+		lvalp->tptr = s;
 		return s->type;
 	}
 
@@ -28,7 +28,9 @@
  ***************************************************************************/
 
 %{
+#include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <ctype.h>
 #include <locale.h>
 #include "parser.h"
@@ -43,19 +45,71 @@
 
 #define YYERROR_VERBOSE 1
 
+/* stack size for evaluating programs without allocation */
+#define PARSER_STACK_SIZE 64
+/* number of points evaluated together in program_eval_batch() */
+#define PARSER_BATCH_SIZE 256
+
+/* instructions of a compiled expression */
+typedef enum opcode {
+	OP_NUM,		/* push number */
+	OP_VAR,		/* push value of variable */
+	OP_ASSIGN,	/* assign top of stack to variable (value stays on stack) */
+	OP_FNCT,	/* call function with nargs arguments from the stack */
+	OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW,	/* binary operators */
+	OP_NEG,		/* unary minus */
+	OP_SQRT, OP_FABS	/* functions evaluated inline (vectorizable in program_eval_batch()) */
+} opcode;
+
+#define IS_UNARY(op) ((op) == OP_NEG || (op) == OP_SQRT || (op) == OP_FABS)
+
+typedef struct instr {
+	opcode op;
+	int nargs;		/* number of arguments of OP_FNCT */
+	union {
+		double num;	/* value of OP_NUM */
+		symrec *sym;	/* symbol of OP_VAR and OP_ASSIGN */
+		func_t fnct;	/* function of OP_FNCT */
+	} arg;
+} instr;
+
+/* compiled expression: the instructions in postfix order, evaluated on a stack */
+struct parser_program {
+	instr *code;
+	int length;	/* number of instructions */
+	int size;	/* allocated number of instructions */
+	int sp;		/* stack depth after the last instruction (used while compiling) */
+	int depth;	/* maximal stack depth needed for the evaluation */
+};
+
+/* number of buckets of the symbol table (power of 2) */
+#define PARSER_HASH_SIZE 1024
+
+/* parser context: every context has its own symbol table, so different
+   contexts can be used in different threads at the same time */
+struct parser_context {
+	symrec *sym_table[PARSER_HASH_SIZE];	/* the hashed symbol table (symbols chained by symrec->next) */
+	int errors;		/* number of errors of the last parse */
+};
+
 /* params passed to yylex (and yyerror) */
 typedef struct param {
 	unsigned int pos;	/* current position in string */
 	char *string;		/* the string to parse */
-/*	symrec *sym_table;	the symbol table (not used) */
+	parser_context *ctx;	/* the context (symbol table) used for parsing */
+	parser_program *prog;	/* the program the grammar actions append to */
+	char *symbuf;		/* buffer for reading symbol names */
+	int symlength;		/* length of symbuf */
 } param;
 
-int yyerror(param *p, const char *err);
-int yylex(param *p);
 
-double res;
+static void emit_num(parser_program *prog, double value);
+static void emit_sym(parser_program *prog, opcode op, symrec *sym);
+static void emit_fnct(parser_program *prog, func_t fnct, int nargs);
+static void emit_op(parser_program *prog, opcode op);
 %}
 
+%define api.pure full
 %lex-param {param *p}
 %parse-param {param *p}
 
@@ -64,9 +118,13 @@ double dval;	/* For returning numbers */
 symrec *tptr;   /* For returning symbol-table pointers */
 }
 
+%{
+int yyerror(param *p, const char *err);
+int yylex(YYSTYPE *lvalp, param *p);
+%}
+
 %token <dval>  NUM 	/* Simple double precision number */
 %token <tptr> VAR FNCT	/* VARiable and FuNCTion */
-%type  <dval>  expr
 
 %right '='
 %left '-' '+'
@@ -74,52 +132,60 @@ symrec *tptr;   /* For returning symbol-table pointers */
 %left NEG     /* Negation--unary minus */
 %right '^'    /* Exponential */
 
+/* the actions don't calculate anything but append the instructions of the expression
+   in postfix order to the program p->prog (see parse_compile()) */
 %%
 input:   /* empty */
 	| input line
 ;
 
 line:	'\n'
-	| expr '\n'   { res=$1; }
+	| expr '\n'
 	| error '\n' { yyerrok; }
 ;
 
-expr:      NUM       { $$ = $1;                         }
-| VAR                { $$ = $1->value.var;              }
-| VAR '=' expr       { $$ = $3; $1->value.var = $3;     }
-| FNCT '(' ')'       { $$ = (*($1->value.fnctptr))();   }
-| FNCT '(' expr ')'  { $$ = (*($1->value.fnctptr))($3); }
-| FNCT '(' expr ',' expr ')'  { $$ = (*($1->value.fnctptr))($3,$5); }
-| FNCT '(' expr ',' expr ','expr ')'  { $$ = (*($1->value.fnctptr))($3,$5,$7); }
-| FNCT '(' expr ',' expr ',' expr ','expr ')'  { $$ = (*($1->value.fnctptr))($3,$5,$7,$9); }
-| expr '+' expr      { $$ = $1 + $3;                    }
-| expr '-' expr      { $$ = $1 - $3;                    }
-| expr '*' expr      { $$ = $1 * $3;                    }
-| expr '/' expr      { $$ = $1 / $3;                    }
-| '-' expr  %prec NEG{ $$ = -$2;                        }
-| expr '^' expr      { $$ = pow ($1, $3);               }
-| expr '*' '*' expr  { $$ = pow ($1, $4);               }
-| '(' expr ')'       { $$ = $2;                         }
+expr:      NUM       { emit_num(p->prog, $1);              }
+| VAR                { emit_sym(p->prog, OP_VAR, $1);      }
+| VAR '=' expr       { emit_sym(p->prog, OP_ASSIGN, $1);   }
+| FNCT '(' ')'       { emit_fnct(p->prog, $1->value.fnctptr, 0); }
+| FNCT '(' expr ')'  { emit_fnct(p->prog, $1->value.fnctptr, 1); }
+| FNCT '(' expr ',' expr ')'  { emit_fnct(p->prog, $1->value.fnctptr, 2); }
+| FNCT '(' expr ',' expr ','expr ')'  { emit_fnct(p->prog, $1->value.fnctptr, 3); }
+| FNCT '(' expr ',' expr ',' expr ','expr ')'  { emit_fnct(p->prog, $1->value.fnctptr, 4); }
+| expr '+' expr      { emit_op(p->prog, OP_ADD);           }
+| expr '-' expr      { emit_op(p->prog, OP_SUB);           }
+| expr '*' expr      { emit_op(p->prog, OP_MUL);           }
+| expr '/' expr      { emit_op(p->prog, OP_DIV);           }
+| '-' expr  %prec NEG{ emit_op(p->prog, OP_NEG);           }
+| expr '^' expr      { emit_op(p->prog, OP_POW);           }
+| expr '*' '*' expr  { emit_op(p->prog, OP_POW);           }
+| '(' expr ')'       { }
 ;
 
 %%
 
-/* global symbol table */
-symrec *sym_table = 0;
-
-int parse_errors() {
-	return yynerrs;
-}
+/* context used by the functions without context argument (not thread-safe) */
+static parser_context *default_context = 0;
 
 int yyerror(param *p, const char *s) {
+	p->ctx->errors++;
 	/* remove trailing newline */
 	p->string[strcspn(p->string, "\n")] = 0;
 	printf("PARSER ERROR: %s @ position %d of string \'%s\'\n", s, p->pos, p->string);
 	return 0;
 }
 
+/* bucket of the symbol in the symbol table (djb2 hash) */
+static unsigned int hash(const char *sym_name) {
+	unsigned int h = 5381;
+	while (*sym_name)
+		h = 33*h + (unsigned char)*sym_name++;
+
+	return h & (PARSER_HASH_SIZE - 1);
+}
+
 /* save symbol in symbol table */
-symrec* putsym(const char *sym_name, int sym_type) {
+symrec* putsym(parser_context *ctx, const char *sym_name, int sym_type) {
 	pdebug("PARSER: putsym(): sym_name = %s\n", sym_name);
 
 	symrec *ptr = (symrec *) malloc(sizeof (symrec));
@@ -127,19 +193,21 @@ symrec* putsym(const char *sym_name, int sym_type) {
 	strcpy(ptr->name, sym_name);
 	ptr->type = sym_type;
 	ptr->value.var = 0;	/* set value to 0 even if fctn */
-	ptr->next = (struct symrec *)sym_table;
-	sym_table = ptr;
+	/* new symbols hide older ones with the same name */
+	const unsigned int bucket = hash(sym_name);
+	ptr->next = (struct symrec *)ctx->sym_table[bucket];
+	ctx->sym_table[bucket] = ptr;
 	
 	pdebug("PARSER: putsym() DONE\n");
 	return ptr;
 }
 
 /* get symbol from symbol table */
-symrec* getsym(const char *sym_name) {
+symrec* getsym(parser_context *ctx, const char *sym_name) {
 	pdebug("PARSER: getsym(): sym_name = %s\n", sym_name);
 	
 	symrec *ptr;
-	for (ptr = sym_table; ptr != 0; ptr = (symrec *)ptr->next) {
+	for (ptr = ctx->sym_table[hash(sym_name)]; ptr != 0; ptr = (symrec *)ptr->next) {
 		/* pdebug("%s ", ptr->name); */
 		if (strcmp(ptr->name, sym_name) == 0) {
 			pdebug("PARSER: symbol \'%s\' found\n", sym_name);
@@ -151,51 +219,86 @@ symrec* getsym(const char *sym_name) {
 	return 0;
 }
 
-void init_table(void) {
-	pdebug("PARSER: init_table()\n");
+/* create a new context with a symbol table containing all functions and constants */
+parser_context* parser_context_new(void) {
+	pdebug("PARSER: parser_context_new()\n");
+
+	parser_context *ctx = (parser_context *) calloc(1, sizeof(parser_context));
 
 	symrec *ptr = 0;
 	int i;
 	/* add functions */
 	for (i = 0; _functions[i].name != 0; i++) {
-		ptr = putsym (_functions[i].name, FNCT);
+		ptr = putsym(ctx, _functions[i].name, FNCT);
 		ptr->value.fnctptr = _functions[i].fnct;
 	}
 	/* add constants */
 	for (i = 0; _constants[i].name != 0; i++) {
-		ptr = putsym (_constants[i].name, VAR);
+		ptr = putsym(ctx, _constants[i].name, VAR);
 		ptr->value.var = _constants[i].value;
 	}
 
-	pdebug("PARSER: init_table() DONE sym_table = %p\n", ptr);
+	pdebug("PARSER: parser_context_new() DONE ctx = %p\n", ctx);
+	return ctx;
 }
 
-void delete_table(void) {
-	while(sym_table) {
-		symrec *tmp = sym_table;
-		sym_table = sym_table->next;
-		free(tmp->name);
-		free(tmp);
+/* delete the context and its symbol table. Programs compiled in this context can't be used anymore. */
+void parser_context_free(parser_context *ctx) {
+	if (!ctx)
+		return;
+
+	int i;
+	for (i = 0; i < PARSER_HASH_SIZE; i++) {
+		while(ctx->sym_table[i]) {
+			symrec *tmp = ctx->sym_table[i];
+			ctx->sym_table[i] = ctx->sym_table[i]->next;
+			free(tmp->name);
+			free(tmp);
+		}
 	}
+	free(ctx);
 }
 
-symrec* assign_variable(const char* symb_name, double value) {
-	/* new style: pdebug("PARSER: assign_variable(): symb_name = %s value = %g sym_table = %p\n", var.name, var.value, sym_table);*/
-	pdebug("PARSER: assign_variable() : symb_name = %s value=%g\n", symb_name, value);
+int parser_context_errors(const parser_context *ctx) {
+	return ctx->errors;
+}
 
-	/* be sure that the symbol table has been initialized */
-	if (!sym_table)
-		init_table();
+symrec* parser_context_assign_variable(parser_context *ctx, const char* symb_name, double value) {
+	pdebug("PARSER: parser_context_assign_variable() : symb_name = %s value=%g\n", symb_name, value);
 
-	symrec* ptr = getsym(symb_name);
+	symrec* ptr = getsym(ctx, symb_name);
 	if (!ptr) {
 		pdebug("PARSER: calling putsym(): symb_name = %s\n", symb_name);
-		ptr = putsym(symb_name, VAR);
+		ptr = putsym(ctx, symb_name, VAR);
 	}
 	ptr->value.var = value;
 
 	return ptr;
-};
+}
+
+/* functions using the default context */
+void init_table(void) {
+	pdebug("PARSER: init_table()\n");
+
+	if (!default_context)
+		default_context = parser_context_new();
+}
+
+void delete_table(void) {
+	parser_context_free(default_context);
+	default_context = 0;
+}
+
+int parse_errors() {
+	return default_context ? default_context->errors : 0;
+}
+
+symrec* assign_variable(const char* symb_name, double value) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+
+	return parser_context_assign_variable(default_context, symb_name, value);
+}
 
 static int getcharstr(param *p) {
 	pdebug("PARSER: getcharstr() pos = %d\n", p->pos);
@@ -211,12 +314,123 @@ static void ungetcstr(unsigned int *pos) {
         (*pos)--;
 }
 
-double parse(const char *str) {
-	pdebug("\nPARSER: parse(\"%s\") len=%zu\n", str, strlen(str));
+/* append an instruction that changes the stack depth by "push" */
+static instr* emit(parser_program *prog, opcode op, int push) {
+	if (prog->length == prog->size) {
+		prog->size = prog->size ? 2*prog->size : 16;
+		prog->code = (instr *) realloc(prog->code, prog->size * sizeof(instr));
+	}
 
-	/* be sure that the symbol table has been initialized */
-	if (!sym_table)
-		init_table();
+	instr *in = &prog->code[prog->length++];
+	in->op = op;
+	in->nargs = 0;
+
+	prog->sp += push;
+	if (prog->sp > prog->depth)
+		prog->depth = prog->sp;
+
+	return in;
+}
+
+static void emit_num(parser_program *prog, double value) {
+	emit(prog, OP_NUM, 1)->arg.num = value;
+}
+
+static void emit_sym(parser_program *prog, opcode op, symrec *sym) {
+	emit(prog, op, op == OP_VAR ? 1 : 0)->arg.sym = sym;
+}
+
+static void emit_op(parser_program *prog, opcode op);
+
+static void emit_fnct(parser_program *prog, func_t fnct, int nargs) {
+	/* functions with an own instruction */
+	if (nargs == 1 && fnct == (func_t) sqrt) {
+		emit_op(prog, OP_SQRT);
+		return;
+	}
+	if (nargs == 1 && fnct == (func_t) fabs) {
+		emit_op(prog, OP_FABS);
+		return;
+	}
+	if (nargs == 2 && fnct == (func_t) pow) {
+		emit_op(prog, OP_POW);
+		return;
+	}
+
+	instr *in = emit(prog, OP_FNCT, 1 - nargs);
+	in->arg.fnct = fnct;
+	in->nargs = nargs;
+}
+
+static double apply_op(opcode op, double a, double b) {
+	switch (op) {
+	case OP_ADD:
+		return a + b;
+	case OP_SUB:
+		return a - b;
+	case OP_MUL:
+		return a * b;
+	case OP_DIV:
+		return a / b;
+	case OP_POW:
+		return pow(a, b);
+	case OP_NEG:
+		return -a;
+	case OP_SQRT:
+		return sqrt(a);
+	case OP_FABS:
+		return fabs(a);
+	case OP_NUM:
+	case OP_VAR:
+	case OP_ASSIGN:
+	case OP_FNCT:
+		break;
+	}
+
+	return NAN;
+}
+
+static void emit_op(parser_program *prog, opcode op) {
+	instr *code = prog->code;
+	const int n = prog->length;
+
+	/* fold operations on numbers (the operands are the last instructions) */
+	if (IS_UNARY(op) && n > 0 && code[n-1].op == OP_NUM) {
+		code[n-1].arg.num = apply_op(op, code[n-1].arg.num, 0);
+		return;
+	}
+	if (!IS_UNARY(op) && n > 1 && code[n-1].op == OP_NUM && code[n-2].op == OP_NUM) {
+		code[n-2].arg.num = apply_op(op, code[n-2].arg.num, code[n-1].arg.num);
+		prog->length--;
+		prog->sp--;
+		return;
+	}
+
+	emit(prog, op, IS_UNARY(op) ? 0 : -1);
+}
+
+static double call_fnct(func_t fnct, int nargs, const double *args) {
+	switch (nargs) {
+	case 0:
+		return (*fnct)();
+	case 1:
+		return (*fnct)(args[0]);
+	case 2:
+		return (*fnct)(args[0], args[1]);
+	case 3:
+		return (*fnct)(args[0], args[1], args[2]);
+	case 4:
+		return (*fnct)(args[0], args[1], args[2], args[3]);
+	}
+
+	return NAN;
+}
+
+/* parse the expression once and return the compiled program (0 on parse errors).
+   The program refers to the symbols of the context's symbol table: variables are read
+   when evaluating the program, so the variables can be assigned between evaluations. */
+parser_program* parser_context_compile(parser_context *ctx, const char *str) {
+	pdebug("\nPARSER: parser_context_compile(\"%s\") len=%zu\n", str, strlen(str));
 
 	param p;
 	p.pos = 0;
@@ -228,16 +442,496 @@ double parse(const char *str) {
 	p.string[strlen(p.string)] = '\n';
 	pdebug("\nPARSER: yyparse(\"%s\") len=%zu\n", p.string, strlen(p.string));
 
+	p.ctx = ctx;
+	p.prog = (parser_program *) calloc(1, sizeof(parser_program));
+	p.symbuf = 0;
+	p.symlength = 0;
+
 	/* parameter for yylex */
+	ctx->errors = 0;
 	yyparse(&p);
 
-	pdebug("PARSER: parse() DONE (res = %g, parse errors = %d)\n", res, parse_errors());
+	pdebug("PARSER: parser_context_compile() DONE (instructions = %d, parse errors = %d)\n", p.prog->length, ctx->errors);
 	free(p.string);
 	p.string = 0;
+	free(p.symbuf);
+
+	if (ctx->errors > 0) {
+		program_free(p.prog);
+		return 0;
+	}
+
+	return p.prog;
+}
+
+parser_program* parse_compile(const char *str) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+
+	return parser_context_compile(default_context, str);
+}
+
+/* evaluate a compiled program with the current values of the variables */
+double program_eval(const parser_program *prog) {
+	double buffer[PARSER_STACK_SIZE];
+	double *stack = buffer;
+	int sp = 0, i;
+
+	if (prog->depth > PARSER_STACK_SIZE)
+		stack = (double *) malloc(prog->depth * sizeof(double));
+
+	for (i = 0; i < prog->length; i++) {
+		const instr *in = &prog->code[i];
+		switch (in->op) {
+		case OP_NUM:
+			stack[sp++] = in->arg.num;
+			break;
+		case OP_VAR:
+			stack[sp++] = in->arg.sym->value.var;
+			break;
+		case OP_ASSIGN:
+			in->arg.sym->value.var = stack[sp-1];
+			break;
+		case OP_FNCT:
+			sp -= in->nargs;
+			stack[sp] = call_fnct(in->arg.fnct, in->nargs, &stack[sp]);
+			sp++;
+			break;
+		case OP_ADD:
+			sp--;
+			stack[sp-1] += stack[sp];
+			break;
+		case OP_SUB:
+			sp--;
+			stack[sp-1] -= stack[sp];
+			break;
+		case OP_MUL:
+			sp--;
+			stack[sp-1] *= stack[sp];
+			break;
+		case OP_DIV:
+			sp--;
+			stack[sp-1] /= stack[sp];
+			break;
+		case OP_POW:
+			sp--;
+			stack[sp-1] = pow(stack[sp-1], stack[sp]);
+			break;
+		case OP_NEG:
+			stack[sp-1] = -stack[sp-1];
+			break;
+		case OP_SQRT:
+			stack[sp-1] = sqrt(stack[sp-1]);
+			break;
+		case OP_FABS:
+			stack[sp-1] = fabs(stack[sp-1]);
+			break;
+		}
+	}
+
+	/* result of the last line (empty expression: NAN) */
+	double result = sp > 0 ? stack[sp-1] : NAN;
+	if (stack != buffer)
+		free(stack);
+
+	return result;
+}
+
+/* apply the binary or unary operator to the blocks a (result) and b of length m */
+static void batch_op(opcode op, double * restrict a, const double * restrict b, int m) {
+	int k;
+	switch (op) {
+	case OP_ADD:
+		for (k = 0; k < m; k++)
+			a[k] += b[k];
+		break;
+	case OP_SUB:
+		for (k = 0; k < m; k++)
+			a[k] -= b[k];
+		break;
+	case OP_MUL:
+		for (k = 0; k < m; k++)
+			a[k] *= b[k];
+		break;
+	case OP_DIV:
+		for (k = 0; k < m; k++)
+			a[k] /= b[k];
+		break;
+	case OP_POW:
+		for (k = 0; k < m; k++)
+			a[k] = pow(a[k], b[k]);
+		break;
+	case OP_NEG:
+		for (k = 0; k < m; k++)
+			a[k] = -a[k];
+		break;
+	case OP_SQRT:
+		for (k = 0; k < m; k++)
+			a[k] = sqrt(a[k]);
+		break;
+	case OP_FABS:
+		for (k = 0; k < m; k++)
+			a[k] = fabs(a[k]);
+		break;
+	case OP_NUM:
+	case OP_VAR:
+	case OP_ASSIGN:
+	case OP_FNCT:
+		break;
+	}
+}
+
+/* call the function for the blocks of arguments (the result is written to args) */
+static void batch_fnct(func_t fnct, int nargs, double *args, int m) {
+	const double *a1 = args + PARSER_BATCH_SIZE;
+	const double *a2 = args + 2*PARSER_BATCH_SIZE;
+	const double *a3 = args + 3*PARSER_BATCH_SIZE;
+	int k;
+
+	switch (nargs) {
+	case 0:
+		for (k = 0; k < m; k++)
+			args[k] = (*fnct)();
+		break;
+	case 1: {
+		double (*f)(double) = (double (*)(double)) fnct;
+		for (k = 0; k < m; k++)
+			args[k] = f(args[k]);
+		break;
+	}
+	case 2: {
+		double (*f)(double, double) = (double (*)(double, double)) fnct;
+		for (k = 0; k < m; k++)
+			args[k] = f(args[k], a1[k]);
+		break;
+	}
+	case 3:
+		for (k = 0; k < m; k++)
+			args[k] = (*fnct)(args[k], a1[k], a2[k]);
+		break;
+	case 4:
+		for (k = 0; k < m; k++)
+			args[k] = (*fnct)(args[k], a1[k], a2[k], a3[k]);
+		break;
+	}
+}
+
+/* evaluate the program for n points: for point k the variable vars[j] has the value values[j][k],
+   the result is written to result[k]. All other variables keep their current value.
+   The points are evaluated in blocks, every instruction is a loop over a block. */
+void program_eval_batch(const parser_program *prog, symrec * const vars[], const double * const values[], int nvars, int n, double *result) {
+	int i, j, k, start;
+
+	/* assignments change variables from point to point: evaluate sequentially */
+	for (i = 0; i < prog->length; i++) {
+		if (prog->code[i].op == OP_ASSIGN) {
+			for (k = 0; k < n; k++) {
+				for (j = 0; j < nvars; j++)
+					vars[j]->value.var = values[j][k];
+				result[k] = program_eval(prog);
+			}
+			return;
+		}
+	}
+
+	/* index of the data of all variables (-1: use the current value) */
+	int *index = (int *) malloc((prog->length + 1) * sizeof(int));
+	for (i = 0; i < prog->length; i++) {
+		index[i] = -1;
+		if (prog->code[i].op != OP_VAR)
+			continue;
+		for (j = 0; j < nvars; j++)
+			if (prog->code[i].arg.sym == vars[j])
+				index[i] = j;
+	}
+
+	double *stack = (double *) malloc((prog->depth + 1) * PARSER_BATCH_SIZE * sizeof(double));
+	for (start = 0; start < n; start += PARSER_BATCH_SIZE) {
+		const int m = (n - start < PARSER_BATCH_SIZE) ? n - start : PARSER_BATCH_SIZE;
+		int sp = 0;
+
+		for (i = 0; i < prog->length; i++) {
+			const instr *in = &prog->code[i];
+			double *top = stack + sp*PARSER_BATCH_SIZE;
+			switch (in->op) {
+			case OP_NUM:
+				for (k = 0; k < m; k++)
+					top[k] = in->arg.num;
+				sp++;
+				break;
+			case OP_VAR:
+				if (index[i] >= 0)
+					memcpy(top, values[index[i]] + start, m * sizeof(double));
+				else
+					for (k = 0; k < m; k++)
+						top[k] = in->arg.sym->value.var;
+				sp++;
+				break;
+			case OP_ASSIGN:
+				break;
+			case OP_FNCT:
+				sp -= in->nargs;
+				batch_fnct(in->arg.fnct, in->nargs, stack + sp*PARSER_BATCH_SIZE, m);
+				sp++;
+				break;
+			case OP_NEG:
+			case OP_SQRT:
+			case OP_FABS:
+				batch_op(in->op, top - PARSER_BATCH_SIZE, 0, m);
+				break;
+			case OP_ADD:
+			case OP_SUB:
+			case OP_MUL:
+			case OP_DIV:
+			case OP_POW:
+				sp--;
+				batch_op(in->op, top - 2*PARSER_BATCH_SIZE, top - PARSER_BATCH_SIZE, m);
+				break;
+			}
+		}
 
+		/* result of the last line (empty expression: NAN) */
+		if (sp > 0)
+			memcpy(result + start, stack + (sp-1)*PARSER_BATCH_SIZE, m * sizeof(double));
+		else
+			for (k = 0; k < m; k++)
+				result[start + k] = NAN;
+	}
+
+	free(stack);
+	free(index);
+}
+
+/* derivative of the function of one argument at x if it is known analytically */
+static int fnct_deriv(func_t fnct, double x, double *deriv) {
+	if (fnct == (func_t) gsl_sf_sin)
+		*deriv = cos(x);
+	else if (fnct == (func_t) gsl_sf_cos)
+		*deriv = -sin(x);
+	else if (fnct == (func_t) tan)
+		*deriv = 1./gsl_pow_2(cos(x));
+	else if (fnct == (func_t) gsl_sf_exp || fnct == (func_t) gsl_expm1)
+		*deriv = exp(x);
+	else if (fnct == (func_t) gsl_sf_log)
+		*deriv = 1./x;
+	else if (fnct == (func_t) log10)
+		*deriv = 1./(x*M_LN10);
+	else if (fnct == (func_t) gsl_log1p)
+		*deriv = 1./(1. + x);
+	else if (fnct == (func_t) sinh)
+		*deriv = cosh(x);
+	else if (fnct == (func_t) cosh)
+		*deriv = sinh(x);
+	else if (fnct == (func_t) tanh)
+		*deriv = 1. - gsl_pow_2(tanh(x));
+	else if (fnct == (func_t) asin)
+		*deriv = 1./sqrt(1. - x*x);
+	else if (fnct == (func_t) acos)
+		*deriv = -1./sqrt(1. - x*x);
+	else if (fnct == (func_t) atan)
+		*deriv = 1./(1. + x*x);
+	else if (fnct == (func_t) gsl_asinh)
+		*deriv = 1./sqrt(x*x + 1.);
+	else if (fnct == (func_t) gsl_acosh)
+		*deriv = 1./sqrt(x*x - 1.);
+	else if (fnct == (func_t) gsl_atanh)
+		*deriv = 1./(1. - x*x);
+	else if (fnct == (func_t) gsl_sf_erf)
+		*deriv = M_2_SQRTPI*exp(-x*x);
+	else if (fnct == (func_t) gsl_sf_erfc)
+		*deriv = -M_2_SQRTPI*exp(-x*x);
+	else if (fnct == (func_t) gsl_pow_2)
+		*deriv = 2.*x;
+	else if (fnct == (func_t) gsl_pow_3)
+		*deriv = 3.*x*x;
+	else
+		return 0;
+
+	return 1;
+}
+
+/* call the function with the arguments args[k*stride] (k < nargs) and calculate the derivatives
+   of the result from the derivatives args[k*stride + 1 + j] of the arguments (chain rule).
+   Value and derivatives of the result are stored in place of the first argument. */
+static void deriv_fnct(func_t fnct, int nargs, double *args, int stride) {
+	double x[4], xh[4], df[4];
+	int j, k;
+
+	for (k = 0; k < nargs; k++)
+		x[k] = args[k*stride];
+	const double value = call_fnct(fnct, nargs, x);
+
+	/* partial derivatives of the function */
+	if (nargs != 1 || !fnct_deriv(fnct, x[0], &df[0])) {
+		for (k = 0; k < nargs; k++) {
+			df[k] = 0;
+			/* only needed if the argument depends on the variables */
+			int dependent = 0;
+			for (j = 1; j < stride; j++)
+				if (args[k*stride + j] != 0)
+					dependent = 1;
+			if (!dependent)
+				continue;
+
+			/* central difference */
+			const double h = 6.e-6*GSL_MAX(fabs(x[k]), 1.);
+			memcpy(xh, x, nargs * sizeof(double));
+			xh[k] = x[k] + h;
+			const double fp = call_fnct(fnct, nargs, xh);
+			xh[k] = x[k] - h;
+			const double fm = call_fnct(fnct, nargs, xh);
+			df[k] = (fp - fm)/(2.*h);
+		}
+	}
+
+	/* chain rule (only the j-th derivatives are read when writing the j-th derivative) */
+	for (j = 1; j < stride; j++) {
+		double d = 0;
+		for (k = 0; k < nargs; k++)
+			if (args[k*stride + j] != 0)
+				d += df[k]*args[k*stride + j];
+		args[j] = d;
+	}
+	args[0] = value;
+}
+
+/* evaluate the program and the derivatives grad[j] of the result with respect to the variables wrt[j]
+   (forward mode automatic differentiation). The derivatives are exact except for functions without
+   known derivative, which are differentiated numerically. */
+double program_eval_deriv(const parser_program *prog, symrec * const wrt[], int nwrt, double *grad) {
+	const int stride = nwrt + 1;	/* size of a stack entry: value and derivatives */
+	double buffer[PARSER_STACK_SIZE];
+	double *stack = buffer;
+	int sp = 0, i, j;
+
+	if ((prog->depth + 1) * stride > PARSER_STACK_SIZE)
+		stack = (double *) malloc((prog->depth + 1) * stride * sizeof(double));
+
+	for (i = 0; i < prog->length; i++) {
+		const instr *in = &prog->code[i];
+		double *top = stack + sp*stride;	/* next free entry */
+		double *a = top - 2*stride, *b = top - stride;	/* operands of binary operators */
+		switch (in->op) {
+		case OP_NUM:
+			top[0] = in->arg.num;
+			for (j = 0; j < nwrt; j++)
+				top[1+j] = 0;
+			sp++;
+			break;
+		case OP_VAR:
+			top[0] = in->arg.sym->value.var;
+			for (j = 0; j < nwrt; j++)
+				top[1+j] = (in->arg.sym == wrt[j]) ? 1. : 0.;
+			sp++;
+			break;
+		case OP_ASSIGN:
+			in->arg.sym->value.var = b[0];
+			break;
+		case OP_FNCT:
+			sp -= in->nargs;
+			if (in->nargs == 0) {
+				top[0] = call_fnct(in->arg.fnct, 0, 0);
+				for (j = 0; j < nwrt; j++)
+					top[1+j] = 0;
+			} else
+				deriv_fnct(in->arg.fnct, in->nargs, stack + sp*stride, stride);
+			sp++;
+			break;
+		case OP_ADD:
+			sp--;
+			for (j = 0; j < stride; j++)
+				a[j] += b[j];
+			break;
+		case OP_SUB:
+			sp--;
+			for (j = 0; j < stride; j++)
+				a[j] -= b[j];
+			break;
+		case OP_MUL:
+			sp--;
+			for (j = 1; j < stride; j++)
+				a[j] = a[j]*b[0] + a[0]*b[j];
+			a[0] *= b[0];
+			break;
+		case OP_DIV:
+			sp--;
+			a[0] /= b[0];
+			for (j = 1; j < stride; j++)
+				a[j] = (a[j] - a[0]*b[j])/b[0];
+			break;
+		case OP_POW: {
+			sp--;
+			const double value = pow(a[0], b[0]);
+			for (j = 1; j < stride; j++) {
+				double d = 0;
+				if (a[j] != 0)
+					d += b[0]*pow(a[0], b[0] - 1.)*a[j];
+				if (b[j] != 0)
+					d += value*log(a[0])*b[j];
+				a[j] = d;
+			}
+			a[0] = value;
+			break;
+		}
+		case OP_NEG:
+			for (j = 0; j < stride; j++)
+				b[j] = -b[j];
+			break;
+		case OP_SQRT:
+			b[0] = sqrt(b[0]);
+			for (j = 1; j < stride; j++)
+				b[j] /= 2.*b[0];
+			break;
+		case OP_FABS:
+			if (b[0] < 0)
+				for (j = 0; j < stride; j++)
+					b[j] = -b[j];
+			break;
+		}
+	}
+
+	/* result of the last line (empty expression: NAN) */
+	double result = NAN;
+	for (j = 0; j < nwrt; j++)
+		grad[j] = (sp > 0) ? stack[(sp-1)*stride + 1 + j] : 0;
+	if (sp > 0)
+		result = stack[(sp-1)*stride];
+
+	if (stack != buffer)
+		free(stack);
+
+	return result;
+}
+
+void program_free(parser_program *prog) {
+	if (!prog)
+		return;
+
+	free(prog->code);
+	free(prog);
+}
+
+double parser_context_parse(parser_context *ctx, const char *str) {
+	pdebug("\nPARSER: parser_context_parse(\"%s\") len=%zu\n", str, strlen(str));
+
+	parser_program *prog = parser_context_compile(ctx, str);
+	if (!prog)
+		return NAN;
+
+	double res = program_eval(prog);
+	program_free(prog);
+
+	pdebug("PARSER: parser_context_parse() DONE (res = %g)\n", res);
 	return res;
 }
 
+double parse(const char *str) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+
+	return parser_context_parse(default_context, str);
+}
+
 double parse_with_vars(const char *str, const parser_var *vars, int nvars) {
 	pdebug("\nPARSER: parse_with_var(\"%s\") len=%zu\n", str, strlen(str));
 	int i;
@@ -249,7 +943,7 @@ double parse_with_vars(const char *str, const parser_var *vars, int nvars) {
 	return parse(str);
 }
 
-int yylex(param *p) {
+int yylex(YYSTYPE *lvalp, param *p) {
 	pdebug("PARSER: yylex()\n");
 	int c;
 
@@ -264,7 +958,7 @@ int yylex(param *p) {
 	/* check for non-ASCII chars */
 	if (!isascii(c)) {
 		pdebug("non-ASCII character found. Giving up\n");
-		yynerrs++;
+		p->ctx->errors++;
 		return 0;
 	}
 
@@ -296,7 +990,7 @@ int yylex(param *p) {
 
 		pdebug("PARSER: result = %g\n", result);
 
-		yylval.dval = result;
+		lvalp->dval = result;
 
                 p->pos += strlen(s) - strlen(remain);
 
@@ -305,22 +999,20 @@ int yylex(param *p) {
 
 	if (isalpha (c) || c == '.') {
 		pdebug("PARSER: reading identifier (starts with alpha: %c)\n", c);
-		static char *symbuf = 0;
-		static int length = 0;
 		int i = 0;
 
 		/* Initially make the buffer long enough for a 10-character symbol name */
-		if (length == 0)
-			length = 10, symbuf = (char *) malloc(length + 1);
+		if (p->symlength == 0)
+			p->symlength = 10, p->symbuf = (char *) malloc(p->symlength + 1);
 
 		do {
 			pdebug("reading symbol .. ");
 			/* If buffer is full, make it bigger */
-			if (i == length) {
-				length *= 2;
-				symbuf = (char *) realloc(symbuf, length + 1);
+			if (i == p->symlength) {
+				p->symlength *= 2;
+				p->symbuf = (char *) realloc(p->symbuf, p->symlength + 1);
 			}
-			symbuf[i++] = c;
+			p->symbuf[i++] = c;
 			c = getcharstr(p);
 			pdebug("got %c\n", c);
 		}
@@ -329,19 +1021,19 @@ int yylex(param *p) {
 
 		if (c != EOF)
 			ungetcstr(&(p->pos));
-		symbuf[i] = '\0';
+		p->symbuf[i] = '\0';
 
-		symrec *s = getsym(symbuf);
+		symrec *s = getsym(p->ctx, p->symbuf);
 		if(s == 0) {	/* symbol unknown */
-			pdebug("PARSER: ERROR: symbol \"%s\" UNKNOWN\n", symbuf);
-			yynerrs++;
+			pdebug("PARSER: ERROR: symbol \"%s\" UNKNOWN\n", p->symbuf);
+			p->ctx->errors++;
 			return 0;
 		}
 		/* old behavior */
 		/* if (s == 0)
-			 s = putsym (symbuf, VAR);
+			 s = putsym (p->ctx, p->symbuf, VAR);
 		*/
-		yylval.tptr = s;
+		lvalp->tptr = s;
 		return s->type;
 	}
 
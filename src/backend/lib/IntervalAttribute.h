@@ -33,6 +33,7 @@
 
 #include "Interval.h"
 #include <QList>
+#include <limits>
 
 //! A class representing an interval-based attribute
 template<class T> class IntervalAttribute
@@ -195,30 +196,57 @@ template<class T> class IntervalAttribute
 };
 
 //! A class representing an interval-based attribute (bool version)
+/**
+ * The set intervals are kept sorted, disjoint and merged (no two intervals touch each other),
+ * so that the lookup of a row and the modifications only need a binary search instead of
+ * scanning all intervals.
+ */
 template<> class IntervalAttribute<bool>
 {
 	public:
 		IntervalAttribute<bool>() {}
-		IntervalAttribute<bool>(QList< Interval<int> > intervals) : m_intervals(intervals) {}
-		IntervalAttribute<bool>& operator=(const IntervalAttribute<bool>& other)
+		IntervalAttribute<bool>(QList< Interval<int> > intervals)
 		{
-			m_intervals.clear();
-			foreach( Interval<int> iv, other.intervals())
-				m_intervals.append(iv);
-			return *this;
+			foreach(const Interval<int>& iv, intervals)
+				setValue(iv, true);
 		}
 
 		void setValue(Interval<int> i, bool value=true)
 		{
+			if(i.start() > i.end())
+				return;
+
 			if(value)
 			{
-				foreach(Interval<int> iv, m_intervals)
-					if(iv.contains(i))
+				// all intervals intersecting or touching 'i' are merged with it
+				// (no neighbouring rows outside of the range of int, e.g. for the last row INT_MAX)
+				const int before = (i.start() > std::numeric_limits<int>::min()) ? i.start()-1 : i.start();
+				const int after = (i.end() < std::numeric_limits<int>::max()) ? i.end()+1 : i.end();
+				const int first = firstEndingAtOrAfter(before);
+				const int last = firstStartingAfter(after);
+				if(first < last)
+				{
+					if(m_intervals.at(first).contains(i))
 						return;
-
-				Interval<int>::mergeIntervalIntoList(&m_intervals, i);
+					i = Interval<int>(qMin(i.start(), m_intervals.at(first).start()), qMax(i.end(), m_intervals.at(last-1).end()));
+				}
+				removeRange(first, last);
+				m_intervals.insert(first, i);
 			} else { // unset
-				Interval<int>::subtractIntervalFromList(&m_intervals, i);
+				const int first = firstEndingAtOrAfter(i.start());
+				const int last = firstStartingAfter(i.end());
+				if(first >= last)
+					return;
+
+				// the remaining parts left and right of 'i' (compared before subtracting to not overflow)
+				const int start = m_intervals.at(first).start();
+				const int end = m_intervals.at(last-1).end();
+				removeRange(first, last);
+				int c = first;
+				if(start < i.start())
+					m_intervals.insert(c++, Interval<int>(start, i.start()-1));
+				if(i.end() < end)
+					m_intervals.insert(c, Interval<int>(i.end()+1, end));
 			}
 		}
 
@@ -229,72 +257,113 @@ template<> class IntervalAttribute<bool>
 
 		bool isSet(int row) const
 		{
-			foreach(Interval<int> iv, m_intervals)
-				if(iv.contains(row))
-					return true;
-			return false;
+			const int c = firstStartingAfter(row) - 1;
+			return (c >= 0 && m_intervals.at(c).end() >= row);
 		}
 
 		bool isSet(Interval<int> i) const
 		{
-			foreach(Interval<int> iv, m_intervals)
-				if(iv.contains(i))
-					return true;
-			return false;
+			const int c = firstStartingAfter(i.start()) - 1;
+			return (c >= 0 && m_intervals.at(c).end() >= i.end());
 		}
 
 		void insertRows(int before, int count)
 		{
-			QList< Interval<int> > temp_list;
-			int c;
-			// first: split all intervals that contain 'before'
-			for(c=0; c<m_intervals.size(); c++)
+			int c = firstEndingAtOrAfter(before);
+			// first: split the interval that contains 'before'
+			if(c < m_intervals.size() && m_intervals.at(c).start() < before)
 			{
-				if(m_intervals.at(c).contains(before))
-				{
-					temp_list = Interval<int>::split(m_intervals.at(c), before);
-					m_intervals.replace(c, temp_list.at(0));
-					if(temp_list.size()>1)
-						m_intervals.insert(c++, temp_list.at(1));
-
-				}
+				const Interval<int> iv = m_intervals.at(c);
+				m_intervals.replace(c, Interval<int>(iv.start(), before-1));
+				m_intervals.insert(++c, Interval<int>(before, iv.end()));
 			}
-			// second: translate all intervals that start at 'before' or later
-			for(c=0; c<m_intervals.size(); c++)
+			// second: translate all intervals that start at 'before' or later,
+			// rows moved beyond the last row INT_MAX are dropped
+			const int last = std::numeric_limits<int>::max() - count;
+			for(; c<m_intervals.size(); c++)
 			{
-				if(m_intervals.at(c).start() >= before)
-					m_intervals[c].translate(count);
+				const Interval<int> iv = m_intervals.at(c);
+				if(iv.start() > last)
+				{
+					removeRange(c, m_intervals.size());
+					break;
+				}
+				m_intervals.replace(c, Interval<int>(iv.start() + count, qMin(iv.end(), last) + count));
 			}
-
 		}
 
 		void removeRows(int first, int count)
 		{
-			int c;
 			// first: remove the relevant rows from all intervals
-			Interval<int>::subtractIntervalFromList(&m_intervals, Interval<int>(first, first+count-1));
+			setValue(Interval<int>(first, first+count-1), false);
 			// second: translate all intervals that start at 'first+count' or later
-			for(c=0; c<m_intervals.size(); c++)
-			{
-				if(m_intervals.at(c).start() >= first+count)
-					m_intervals[c].translate(-count);
-			}
-			// third: merge as many intervals as possible
-			for(c=m_intervals.size()-1; c>=0; c--)
+			const int next = firstStartingAfter(first+count-1);
+			for(int c=next; c<m_intervals.size(); c++)
+				m_intervals[c].translate(-count);
+			// third: merge the intervals that touch each other now
+			if(next > 0 && next < m_intervals.size() && m_intervals.at(next-1).touches(m_intervals.at(next)))
 			{
-				Interval<int> iv = m_intervals.takeAt(c);
-				int size_before = m_intervals.size();
-				Interval<int>::mergeIntervalIntoList(&m_intervals, iv);
-				if(size_before == m_intervals.size()) // merge successful
-					c--;
+				m_intervals.replace(next-1, Interval<int>::merge(m_intervals.at(next-1), m_intervals.at(next)));
+				m_intervals.removeAt(next);
 			}
 		}
 
+		//! all set intervals, sorted by their start
 		QList< Interval<int> > intervals() const { return m_intervals; }
 
+		//! the set intervals intersecting with \c range, restricted to \c range
+		QList< Interval<int> > intervals(Interval<int> range) const
+		{
+			QList< Interval<int> > result;
+			for(int c=firstEndingAtOrAfter(range.start()); c<m_intervals.size() && m_intervals.at(c).start()<=range.end(); c++)
+				result.append(Interval<int>::intersection(m_intervals.at(c), range));
+			return result;
+		}
+
 		void clear() { m_intervals.clear(); }
 
 	private:
+		//! index of the first interval with end >= row
+		int firstEndingAtOrAfter(int row) const
+		{
+			int low = 0;
+			int high = m_intervals.size();
+			while(low < high)
+			{
+				const int mid = (low + high)/2;
+				if(m_intervals.at(mid).end() < row)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			return low;
+		}
+
+		//! index of the first interval with start > row
+		int firstStartingAfter(int row) const
+		{
+			int low = 0;
+			int high = m_intervals.size();
+			while(low < high)
+			{
+				const int mid = (low + high)/2;
+				if(m_intervals.at(mid).start() <= row)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			return low;
+		}
+
+		//! remove the intervals with the indices first <= c < last
+		void removeRange(int first, int last)
+		{
+			if(last - first == m_intervals.size())
+				m_intervals.clear();
+			else
+				m_intervals.erase(m_intervals.begin() + first, m_intervals.begin() + last);
+		}
+
 		QList< Interval<int> > m_intervals;
 };
 
@@ -0,0 +1,138 @@
+/***************************************************************************
+    File                 : SpillFile.cpp
+    Project              : LabPlot
+    Description          : Temporary file for the data of undo commands moved to the disk
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "SpillFile.h"
+#include <QDir>
+
+/**
+ * \class SpillFile
+ * \brief Temporary file for the data of undo commands moved to the disk.
+ *
+ * The data of a SpillableUndoCommand is written as one block and read back as a whole when the command is undone or redone.
+ * The space of the blocks that were read back or whose commands were deleted is reused for the next blocks
+ * (first fit), free space at the end of the file is cut off. So, the file doesn't grow beyond the size of the data
+ * that is currently spilled plus the gaps that are too small for the next blocks.
+ *
+ * The file is removed when the object is deleted, i.e. when the undo stack and all its commands don't use it anymore.
+ */
+
+SpillFile::SpillFile() : m_file(QDir::tempPath() + QLatin1String("/labplot_undo_XXXXXX")) {
+}
+
+bool SpillFile::open() {
+	return m_file.open();
+}
+
+QString SpillFile::errorString() const {
+	return m_file.errorString();
+}
+
+/**
+ * Returns the size of the file in bytes, including the free space between the blocks.
+ */
+qint64 SpillFile::size() const {
+	return m_file.size();
+}
+
+/**
+ * Writes \c data to the first free region large enough or to the end of the file.
+ * Returns the offset of the data in the file or -1 if the data couldn't be written.
+ */
+qint64 SpillFile::write(const QByteArray& data) {
+	const qint64 size = data.size();
+	qint64 offset = m_file.size();
+	QMap<qint64, qint64>::iterator it = m_freeRegions.begin();
+	for (; it != m_freeRegions.end(); ++it) {
+		if (it.value() >= size) {
+			offset = it.key();
+			break;
+		}
+	}
+
+	if (!m_file.seek(offset) || m_file.write(data) != size || !m_file.flush()) {
+		if (it == m_freeRegions.end())
+			m_file.resize(offset);
+		return -1;
+	}
+
+	if (it != m_freeRegions.end()) {
+		const qint64 remaining = it.value() - size;
+		m_freeRegions.erase(it);
+		if (remaining > 0)
+			m_freeRegions.insert(offset + size, remaining);
+	}
+
+	return offset;
+}
+
+/**
+ * Reads \c size bytes at \c offset, an empty array is returned on errors.
+ */
+QByteArray SpillFile::read(qint64 offset, qint64 size) {
+	if (!m_file.seek(offset))
+		return QByteArray();
+
+	QByteArray data = m_file.read(size);
+	if (data.size() != size)
+		return QByteArray();
+
+	return data;
+}
+
+/**
+ * Marks the \c size bytes at \c offset as free, adjacent free regions are merged.
+ */
+void SpillFile::release(qint64 offset, qint64 size) {
+	if (size <= 0)
+		return;
+
+	QMap<qint64, qint64>::iterator it = m_freeRegions.insert(offset, size);
+
+	//merge with the following region
+	QMap<qint64, qint64>::iterator next = it + 1;
+	if (next != m_freeRegions.end() && it.key() + it.value() == next.key()) {
+		it.value() += next.value();
+		m_freeRegions.erase(next);
+	}
+
+	//merge with the preceding region
+	if (it != m_freeRegions.begin()) {
+		QMap<qint64, qint64>::iterator previous = it - 1;
+		if (previous.key() + previous.value() == it.key()) {
+			previous.value() += it.value();
+			m_freeRegions.erase(it);
+			it = previous;
+		}
+	}
+
+	//the free space at the end of the file is given back to the file system
+	if (it.key() + it.value() >= m_file.size()) {
+		m_file.resize(it.key());
+		m_freeRegions.erase(it);
+	}
+}
@@ -0,0 +1,55 @@
+/***************************************************************************
+    File                 : SpillFile.h
+    Project              : LabPlot
+    Description          : Temporary file for the data of undo commands moved to the disk
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SPILLFILE_H
+#define SPILLFILE_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QTemporaryFile>
+
+class SpillFile {
+	public:
+		SpillFile();
+
+		bool open();
+		QString errorString() const;
+		qint64 size() const;
+
+		qint64 write(const QByteArray&);
+		QByteArray read(qint64 offset, qint64 size);
+		void release(qint64 offset, qint64 size);
+
+	private:
+		Q_DISABLE_COPY(SpillFile)
+
+		QTemporaryFile m_file;
+		QMap<qint64, qint64> m_freeRegions;
+};
+
+#endif
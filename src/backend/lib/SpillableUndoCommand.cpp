@@ -0,0 +1,130 @@
+/***************************************************************************
+    File                 : SpillableUndoCommand.cpp
+    Project              : LabPlot
+    Description          : Interface for undo commands whose data can be moved to the disk
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "SpillableUndoCommand.h"
+#include "SpillFile.h"
+#include "macros.h"
+
+#include <QDataStream>
+
+/**
+ * \class SpillableUndoCommand
+ * \brief Interface for undo commands whose data can be moved to the disk.
+ *
+ * Undo commands that keep large amounts of data for undo and redo (e.g. the previous values of a column)
+ * implement this interface in addition to QUndoCommand. If the memory budget of the UndoStack is exceeded,
+ * the stack calls spill() for the commands that are far away from the current state. The data is then
+ * written to a temporary file and released. The command has to call reload() at the beginning of
+ * QUndoCommand::undo() and QUndoCommand::redo() to read the data back.
+ *
+ * Implementations provide the size of the data kept in memory in payloadSize() and the serialization of the data
+ * in writePayload() and readPayload(). releasePayload() frees the data after it was written to the disk.
+ */
+
+SpillableUndoCommand::SpillableUndoCommand() : m_spillOffset(0), m_spillSize(0), m_memorySize(-1) {
+}
+
+SpillableUndoCommand::~SpillableUndoCommand() {
+	if (isSpilled())
+		m_spillFile->release(m_spillOffset, m_spillSize);
+}
+
+/**
+ * Returns the number of bytes of the data kept in memory, 0 if the data is stored on the disk.
+ * The size is determined once via payloadSize() and cached until the command is undone or redone again,
+ * so the undo stack can check its memory budget on every change without going through the data of all commands.
+ */
+qint64 SpillableUndoCommand::memorySize() const {
+	if (isSpilled())
+		return 0;
+
+	if (m_memorySize < 0)
+		m_memorySize = payloadSize();
+	return m_memorySize;
+}
+
+/**
+ * Returns \c true if the data of the command is currently stored on the disk.
+ */
+bool SpillableUndoCommand::isSpilled() const {
+	return !m_spillFile.isNull();
+}
+
+/**
+ * Returns the number of bytes written to the disk or 0 if the data is in memory.
+ */
+qint64 SpillableUndoCommand::spilledSize() const {
+	return isSpilled() ? m_spillSize : 0;
+}
+
+/**
+ * Writes the data of the command to the file \c file and releases the data in memory.
+ * Returns \c false if the data couldn't be written, the data is kept in memory in this case.
+ */
+bool SpillableUndoCommand::spill(const QSharedPointer<SpillFile>& file) {
+	if (isSpilled())
+		return true;
+
+	QByteArray data;
+	QDataStream out(&data, QIODevice::WriteOnly);
+	writePayload(out);
+	if (out.status() != QDataStream::Ok)
+		return false;
+
+	const qint64 offset = file->write(data);
+	if (offset < 0)
+		return false;
+
+	m_spillFile = file;
+	m_spillOffset = offset;
+	m_spillSize = data.size();
+	releasePayload();
+	return true;
+}
+
+/**
+ * Reads the data of the command back into memory if it was moved to the disk.
+ * The space in the file is reused for the data of other commands afterwards.
+ */
+void SpillableUndoCommand::reload() {
+	//the data is modified by undo and redo, its size is determined again when needed
+	m_memorySize = -1;
+
+	if (!isSpilled())
+		return;
+
+	const QByteArray data = m_spillFile->read(m_spillOffset, m_spillSize);
+	if (data.isEmpty())
+		WARNING("SpillableUndoCommand: couldn't read the undo history from the disk: " << m_spillFile->errorString().toStdString());
+	QDataStream in(data);
+	readPayload(in);
+
+	m_spillFile->release(m_spillOffset, m_spillSize);
+	m_spillFile.clear();
+	m_spillSize = 0;
+}
@@ -0,0 +1,61 @@
+/***************************************************************************
+    File                 : SpillableUndoCommand.h
+    Project              : LabPlot
+    Description          : Interface for undo commands whose data can be moved to the disk
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SPILLABLEUNDOCOMMAND_H
+#define SPILLABLEUNDOCOMMAND_H
+
+#include <QSharedPointer>
+
+class QDataStream;
+class SpillFile;
+
+class SpillableUndoCommand {
+	public:
+		SpillableUndoCommand();
+		virtual ~SpillableUndoCommand();
+
+		virtual qint64 payloadSize() const = 0;
+		qint64 memorySize() const;
+		bool isSpilled() const;
+		qint64 spilledSize() const;
+		bool spill(const QSharedPointer<SpillFile>&);
+
+	protected:
+		void reload();
+		virtual void writePayload(QDataStream&) const = 0;
+		virtual void readPayload(QDataStream&) = 0;
+		virtual void releasePayload() = 0;
+
+	private:
+		QSharedPointer<SpillFile> m_spillFile;
+		qint64 m_spillOffset;
+		qint64 m_spillSize;
+		mutable qint64 m_memorySize;
+};
+
+#endif
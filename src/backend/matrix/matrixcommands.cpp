@@ -30,6 +30,17 @@
 #include "matrixcommands.h"
 #include "MatrixPrivate.h"
 #include <KLocale>
+#include <QDataStream>
+
+namespace {
+//! returns the number of bytes used by the matrix values \c values
+qint64 valuesSize(const QVector< QVector<double> >& values) {
+	qint64 size = 0;
+	for (int i = 0; i < values.size(); ++i)
+		size += values.at(i).size()*(qint64)sizeof(double);
+	return size;
+}
+}
 
 //Insert columns
 MatrixInsertColumnsCmd::MatrixInsertColumnsCmd( MatrixPrivate * private_obj, int before, int count, QUndoCommand * parent)
@@ -127,6 +138,7 @@ MatrixClearCmd::MatrixClearCmd( MatrixPrivate * private_obj, QUndoCommand * pare
 
 
 void MatrixClearCmd::redo() {
+	reload();
 	if(m_backups.isEmpty()) {
 		int last_row = m_private_obj->rowCount-1;
 		for(int i=0; i<m_private_obj->columnCount; i++)
@@ -137,11 +149,28 @@ void MatrixClearCmd::redo() {
 }
 
 void MatrixClearCmd::undo() {
+	reload();
 	int last_row = m_private_obj->rowCount-1;
 	for(int i=0; i<m_private_obj->columnCount; i++)
 		m_private_obj->setColumnCells(i, 0, last_row, m_backups.at(i));
 }
 
+qint64 MatrixClearCmd::payloadSize() const {
+	return valuesSize(m_backups);
+}
+
+void MatrixClearCmd::writePayload(QDataStream& out) const {
+	out << m_backups;
+}
+
+void MatrixClearCmd::readPayload(QDataStream& in) {
+	in >> m_backups;
+}
+
+void MatrixClearCmd::releasePayload() {
+	m_backups = QVector< QVector<double> >();
+}
+
 
 //clear column
 MatrixClearColumnCmd::MatrixClearColumnCmd( MatrixPrivate * private_obj, int col, QUndoCommand * parent)
@@ -360,13 +389,35 @@ MatrixReplaceValuesCmd::MatrixReplaceValuesCmd(MatrixPrivate* private_obj, const
 }
 
 void MatrixReplaceValuesCmd::redo() {
+	reload();
 	m_old_values = m_private_obj->matrixData;
 	m_private_obj->matrixData = m_new_values;
+	//the new values are taken from the matrix again in undo(), keep only the old values
+	m_new_values = QVector< QVector<double> >();
 	m_private_obj->emitDataChanged(0, 0, m_private_obj->rowCount -1, m_private_obj->columnCount-1);
 }
 
 void MatrixReplaceValuesCmd::undo() {
+	reload();
 	m_new_values = m_private_obj->matrixData;
 	m_private_obj->matrixData = m_old_values;
+	m_old_values = QVector< QVector<double> >();
 	m_private_obj->emitDataChanged(0, 0, m_private_obj->rowCount -1, m_private_obj->columnCount-1);
 }
+
+qint64 MatrixReplaceValuesCmd::payloadSize() const {
+	return valuesSize(m_old_values) + valuesSize(m_new_values);
+}
+
+void MatrixReplaceValuesCmd::writePayload(QDataStream& out) const {
+	out << m_old_values << m_new_values;
+}
+
+void MatrixReplaceValuesCmd::readPayload(QDataStream& in) {
+	in >> m_old_values >> m_new_values;
+}
+
+void MatrixReplaceValuesCmd::releasePayload() {
+	m_old_values = QVector< QVector<double> >();
+	m_new_values = QVector< QVector<double> >();
+}
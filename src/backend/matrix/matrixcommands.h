@@ -33,6 +33,7 @@
 #include <QUndoCommand>
 #include <QVector>
 #include "Matrix.h"
+#include "backend/lib/SpillableUndoCommand.h"
 
 //! Insert columns
 class MatrixInsertColumnsCmd : public QUndoCommand {
@@ -94,11 +95,17 @@ class MatrixRemoveRowsCmd : public QUndoCommand {
 
 
 //! Clear matrix
-class MatrixClearCmd : public QUndoCommand {
+class MatrixClearCmd : public QUndoCommand, public SpillableUndoCommand {
 	public:
 		explicit MatrixClearCmd(MatrixPrivate* private_obj, QUndoCommand* parent = 0);
 		virtual void redo();
 		virtual void undo();
+		virtual qint64 payloadSize() const;
+
+	protected:
+		virtual void writePayload(QDataStream&) const;
+		virtual void readPayload(QDataStream&);
+		virtual void releasePayload();
 
 	private:
 		MatrixPrivate* m_private_obj;
@@ -239,11 +246,17 @@ class MatrixMirrorVerticallyCmd : public QUndoCommand {
 
 
 // Replace matrix values
-class MatrixReplaceValuesCmd : public QUndoCommand {
+class MatrixReplaceValuesCmd : public QUndoCommand, public SpillableUndoCommand {
 	public:
 		explicit MatrixReplaceValuesCmd(MatrixPrivate* private_obj, const QVector<QVector<double> >& new_values, QUndoCommand* parent = 0);
 		virtual void redo();
 		virtual void undo();
+		virtual qint64 payloadSize() const;
+
+	protected:
+		virtual void writePayload(QDataStream&) const;
+		virtual void readPayload(QDataStream&);
+		virtual void releasePayload();
 
 	private:
 		MatrixPrivate* m_private_obj;
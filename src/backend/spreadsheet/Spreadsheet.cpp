@@ -30,9 +30,12 @@
 #include "Spreadsheet.h"
 #include "backend/core/AspectPrivate.h"
 #include "backend/core/AbstractAspect.h"
+#include "backend/core/column/ColumnTextData.h"
 #include "commonfrontend/spreadsheet/SpreadsheetView.h"
 #include "kdefrontend/spreadsheet/ExportSpreadsheetDialog.h"
 
+#include <QMap>
+#include <QUndoCommand>
 #include <QPrinter>
 #include <QPrintDialog>
 #include <QPrintPreviewDialog>
@@ -63,7 +66,7 @@
 */
 
 Spreadsheet::Spreadsheet(AbstractScriptingEngine* engine, const QString& name, bool loading)
-  : AbstractDataSource(engine, name){
+  : AbstractDataSource(engine, name), m_updateLevel(0) {
 
 	if (!loading)
 		init();
@@ -108,7 +111,7 @@ bool Spreadsheet::exportView() const {
 
 	dlg->setExportTo(QStringList() << i18n("FITS image") << i18n("FITS table"));
 	for (int i = 0; i < columnCount();++i) {
-		if (column(i)->columnMode() != AbstractColumn::Numeric) {
+		if (!AbstractColumn::isNumeric(column(i)->columnMode())) {
 			dlg->setExportToImage(false);
 			break;
         	}
@@ -320,6 +323,77 @@ void Spreadsheet::clear()
 	RESET_CURSOR;
 }
 
+/*!
+  \class SpreadsheetUpdateCmd
+  \brief Undo command starting or finishing an update transaction of the spreadsheet.
+
+  The commands are added at the begin and at the end of the macro created by Spreadsheet::beginUpdate() and
+  Spreadsheet::endUpdate(), so that the columns send their change notifications only once also when the macro is undone or redone.
+*/
+class SpreadsheetUpdateCmd : public QUndoCommand {
+	public:
+		SpreadsheetUpdateCmd(Spreadsheet* spreadsheet, bool begin) : m_spreadsheet(spreadsheet), m_begin(begin) {}
+
+		virtual void redo() {
+			if (m_begin)
+				m_spreadsheet->startUpdate();
+			else
+				m_spreadsheet->finishUpdate();
+		}
+
+		//the commands of the macro are undone in reverse order
+		virtual void undo() {
+			if (m_begin)
+				m_spreadsheet->finishUpdate();
+			else
+				m_spreadsheet->startUpdate();
+		}
+
+	private:
+		Spreadsheet* m_spreadsheet;
+		bool m_begin;
+};
+
+/*!
+  Starts an update transaction for all columns of the spreadsheet, see Column::beginUpdate().
+  The change notifications of the columns are sent once in endUpdate().
+  The modifications until endUpdate() are collected in one macro, the notifications are also sent once when it is undone or redone.
+*/
+void Spreadsheet::beginUpdate() {
+	beginMacro(i18n("%1: update", name()));
+	exec(new SpreadsheetUpdateCmd(this, true));
+}
+
+/*!
+  Finishes the update transaction started with beginUpdate().
+*/
+void Spreadsheet::endUpdate() {
+	exec(new SpreadsheetUpdateCmd(this, false));
+	endMacro();
+}
+
+void Spreadsheet::startUpdate() {
+	if (m_updateLevel++ > 0)
+		return;
+
+	foreach (Column* col, children<Column>()) {
+		col->beginUpdate();
+		m_updatedColumns << col;
+	}
+}
+
+void Spreadsheet::finishUpdate() {
+	if (m_updateLevel == 0 || --m_updateLevel > 0)
+		return;
+
+	//columns removed during the transaction might have been deleted already
+	foreach (const QPointer<Column>& col, m_updatedColumns) {
+		if (col)
+			col->endUpdate();
+	}
+	m_updatedColumns.clear();
+}
+
 /*!
   Clears all mask in the spreadsheet.
 */
@@ -430,6 +504,66 @@ int Spreadsheet::colY(int col)
 	return -1;
 }
 
+static bool textLess(const QPair<QString, int>& a, const QPair<QString, int>& b) {
+	return a.first < b.first;
+}
+
+static bool textGreater(const QPair<QString, int>& a, const QPair<QString, int>& b) {
+	return a.first > b.first;
+}
+
+/*!
+  returns the rows of the text column \c col in sorted order (stable sort).
+  For dictionary encoded columns only the distinct strings are compared,
+  the rows are sorted by the integer rank of their string in the dictionary.
+*/
+static QVector<int> sortedTextRows(const Column* col, bool ascending) {
+	const int rows = col->rowCount();
+	QVector<int> order(rows);
+	const ColumnTextData* textData = col->textData();
+
+	if (textData && textData->isEncoded()) {
+		// sort the dictionary and determine the rank of every string
+		const QStringList& dictionary = textData->dictionary();
+		// the null and the empty string have different codes but the same rank
+		QMap<QString, int> sortedStrings;
+		for (int i=0; i<dictionary.size(); i++)
+			sortedStrings.insert(dictionary.at(i), 0);
+
+		int r = 0;
+		for (QMap<QString, int>::iterator it = sortedStrings.begin(); it != sortedStrings.end(); ++it)
+			it.value() = ascending ? r++ : sortedStrings.size() - 1 - r++;
+
+		QVector<int> rank(dictionary.size());
+		for (int i=0; i<dictionary.size(); i++)
+			rank[i] = sortedStrings.value(dictionary.at(i));
+
+		// counting sort of the rows on the ranks, this keeps the order of rows with equal strings
+		const QVector<int>& codes = textData->codes();
+		QVector<int> start(dictionary.size() + 1, 0);
+		for (int i=0; i<rows; i++)
+			start[rank.at(codes.at(i)) + 1]++;
+		for (int i=0; i<dictionary.size(); i++)
+			start[i+1] += start.at(i);
+		for (int i=0; i<rows; i++)
+			order[start[rank.at(codes.at(i))]++] = i;
+	} else {
+		QList< QPair<QString, int> > map;
+		for (int i=0; i<rows; i++)
+			map.append(QPair<QString, int>(col->textAt(i), i));
+
+		if (ascending)
+			qStableSort(map.begin(), map.end(), textLess);
+		else
+			qStableSort(map.begin(), map.end(), textGreater);
+
+		for (int i=0; i<rows; i++)
+			order[i] = map.at(i).second;
+	}
+
+	return order;
+}
+
 /*! Sorts the given list of column.
   If 'leading' is a null pointer, each column is sorted separately.
 */
@@ -449,14 +583,6 @@ void Spreadsheet::sortColumns(Column *leading, QList<Column*> cols, bool ascendi
 			{
 				return a.first > b.first;
 			}
-			static bool QStringLess(const QPair<QString, int>& a, const QPair<QString, int>& b)
-			{
-				return a < b;
-			}
-			static bool QStringGreater(const QPair<QString, int>& a, const QPair<QString, int>& b)
-			{
-				return a > b;
-			}
 			static bool QDateTimeLess(const QPair<QDateTime, int>& a, const QPair<QDateTime, int>& b)
 			{
 				return a < b;
@@ -474,12 +600,18 @@ void Spreadsheet::sortColumns(Column *leading, QList<Column*> cols, bool ascendi
 		foreach(Column *col, cols) {
 			switch (col->columnMode()) {
 				case AbstractColumn::Numeric:
+				case AbstractColumn::Integer:
+				case AbstractColumn::BigInt:
+				case AbstractColumn::Float:
 					{
-						int rows = col->rowCount();
+						const AbstractColumn::NumericView view = col->numericView();
+						const double* values = view.data();
+						int rows = view.size();
 						QList< QPair<double, int> > map;
+						map.reserve(rows);
 
 						for(int j=0; j<rows; j++)
-							map.append(QPair<double, int>(col->valueAt(j), j));
+							map.append(QPair<double, int>(values[j], j));
 
 						if(ascending)
 							qStableSort(map.begin(), map.end(), CompareFunctions::doubleLess);
@@ -504,25 +636,13 @@ void Spreadsheet::sortColumns(Column *leading, QList<Column*> cols, bool ascendi
 				case AbstractColumn::Text:
 					{
 						int rows = col->rowCount();
-						QList< QPair<QString, int> > map;
-
-						for(int j=0; j<rows; j++)
-							map.append(QPair<QString, int>(col->textAt(j), j));
-
-						if(ascending)
-							qStableSort(map.begin(), map.end(), CompareFunctions::QStringLess);
-						else
-							qStableSort(map.begin(), map.end(), CompareFunctions::QStringGreater);
-
-						QListIterator< QPair<QString, int> > it(map);
+						const QVector<int> order = sortedTextRows(col, ascending);
 						Column *temp_col = new Column("temp", col->columnMode());
 
-						int k=0;
 						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, k, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							k++;
+						for(int k=0; k<rows; k++) {
+							temp_col->copy(col, order.at(k), k, 1);
+							temp_col->setMasked(col->isMasked(order.at(k)));
 						}
 						// copy the sorted column
 						col->copy(temp_col, 0, 0, rows);
@@ -564,12 +684,18 @@ void Spreadsheet::sortColumns(Column *leading, QList<Column*> cols, bool ascendi
 	} else { // sort with leading column
 		switch (leading->columnMode()) {
 			case AbstractColumn::Numeric:
+			case AbstractColumn::Integer:
+			case AbstractColumn::BigInt:
+			case AbstractColumn::Float:
 				{
+					const AbstractColumn::NumericView view = leading->numericView();
+					const double* values = view.data();
 					QList< QPair<double, int> > map;
-					int rows = leading->rowCount();
+					int rows = view.size();
+					map.reserve(rows);
 
 					for(int i=0; i<rows; i++)
-						map.append(QPair<double, int>(leading->valueAt(i), i));
+						map.append(QPair<double, int>(values[i], i));
 
 					if(ascending)
 						qStableSort(map.begin(), map.end(), CompareFunctions::doubleLess);
@@ -595,27 +721,15 @@ void Spreadsheet::sortColumns(Column *leading, QList<Column*> cols, bool ascendi
 				}
 			case AbstractColumn::Text:
 				{
-					QList< QPair<QString, int> > map;
 					int rows = leading->rowCount();
-
-					for(int i=0; i<rows; i++)
-						map.append(QPair<QString, int>(leading->textAt(i), i));
-
-					if(ascending)
-						qStableSort(map.begin(), map.end(), CompareFunctions::QStringLess);
-					else
-						qStableSort(map.begin(), map.end(), CompareFunctions::QStringGreater);
-					QListIterator< QPair<QString, int> > it(map);
+					const QVector<int> order = sortedTextRows(leading, ascending);
 
 					foreach (Column *col, cols) {
 						Column *temp_col = new Column("temp", col->columnMode());
-						it.toFront();
-						int j=0;
 						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, j, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							j++;
+						for(int j=0; j<rows; j++) {
+							temp_col->copy(col, order.at(j), j, 1);
+							temp_col->setMasked(col->isMasked(order.at(j)));
 						}
 						// copy the sorted column
 						col->copy(temp_col, 0, 0, rows);
@@ -32,9 +32,11 @@
 #include "backend/datasources/AbstractDataSource.h"
 #include "backend/core/column/Column.h"
 #include <QList>
+#include <QPointer>
 
 class Spreadsheet : public AbstractDataSource {
 	Q_OBJECT
+	friend class SpreadsheetUpdateCmd;
 
 	public:
 		Spreadsheet(AbstractScriptingEngine* engine, const QString& name, bool loading = false);
@@ -64,6 +66,9 @@ class Spreadsheet : public AbstractDataSource {
 
 		void copy(Spreadsheet* other);
 
+		void beginUpdate();
+		void endUpdate();
+
 		virtual void save(QXmlStreamWriter*) const;
 		virtual bool load(XmlStreamReader*);
 
@@ -91,6 +96,11 @@ class Spreadsheet : public AbstractDataSource {
 
 	private:
 		void init();
+		void startUpdate();
+		void finishUpdate();
+
+		int m_updateLevel;
+		QList< QPointer<Column> > m_updatedColumns;
 
 	private slots:
 		virtual void childSelected(const AbstractAspect*);
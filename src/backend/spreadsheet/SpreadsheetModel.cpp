@@ -402,6 +402,15 @@ void SpreadsheetModel::updateHorizontalHeader() {
 			case AbstractColumn::DateTime:
 				middle_section = QLatin1String(" {") + i18n("Date and time") + QLatin1String("} ");
 				break;
+			case AbstractColumn::Integer:
+				middle_section = QLatin1String(" {") + i18n("Integer") + QLatin1String("} ");
+				break;
+			case AbstractColumn::BigInt:
+				middle_section = QLatin1String(" {") + i18n("Big integer") + QLatin1String("} ");
+				break;
+			case AbstractColumn::Float:
+				middle_section = QLatin1String(" {") + i18n("Single precision") + QLatin1String("} ");
+				break;
 		}
 
 		/*
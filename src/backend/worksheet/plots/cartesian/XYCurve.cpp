@@ -856,40 +856,71 @@ void XYCurvePrivate::retransform() {
 	AbstractColumn::ColumnMode yColMode = yColumn->columnMode();
 
 	//take over only valid and non masked points.
-	for (int row = startRow; row <= endRow; row++) {
-		if ( xColumn->isValid(row) && yColumn->isValid(row)
-				&& (!xColumn->isMasked(row)) && (!yColumn->isMasked(row)) ) {
+	if (AbstractColumn::isNumeric(xColMode) && AbstractColumn::isNumeric(yColMode)) {
+		//iterate directly over the numeric data of both columns
+		const AbstractColumn::NumericView xView = xColumn->numericView();
+		const AbstractColumn::NumericView yView = yColumn->numericView();
+		const double* xData = xView.data();
+		const double* yData = yView.data();
+		const bool masked = xView.hasMaskedRows() || yView.hasMaskedRows();
+		const int rows = qMin(xView.size(), yView.size());
+		symbolPointsLogical.reserve(rows);
+		for (int row = 0; row < rows; ++row) {
+			if ( !std::isnan(xData[row]) && !std::isnan(yData[row])
+					&& (!masked || (!xView.isMasked(row) && !yView.isMasked(row))) ) {
+				symbolPointsLogical.append(QPointF(xData[row], yData[row]));
+				connectedPointsLogical.push_back(true);
+			} else {
+				if (!connectedPointsLogical.empty())
+					connectedPointsLogical[connectedPointsLogical.size()-1] = false;
+			}
+		}
 
-			switch (xColMode) {
-			case AbstractColumn::Numeric:
-				tempPoint.setX(xColumn->valueAt(row));
-				break;
-			case AbstractColumn::Text:
-			//TODO
-			case AbstractColumn::DateTime:
-			case AbstractColumn::Month:
-			case AbstractColumn::Day:
+		//rows of the x-column without y-values are invalid
+		if (xView.size() > rows && !connectedPointsLogical.empty())
+			connectedPointsLogical[connectedPointsLogical.size()-1] = false;
+	} else {
+		for (int row = startRow; row <= endRow; row++) {
+			if ( xColumn->isValid(row) && yColumn->isValid(row)
+					&& (!xColumn->isMasked(row)) && (!yColumn->isMasked(row)) ) {
+
+				switch (xColMode) {
+				case AbstractColumn::Numeric:
+				case AbstractColumn::Integer:
+				case AbstractColumn::BigInt:
+				case AbstractColumn::Float:
+					tempPoint.setX(xColumn->valueAt(row));
+					break;
+				case AbstractColumn::Text:
 				//TODO
-				break;
-			}
+				case AbstractColumn::DateTime:
+				case AbstractColumn::Month:
+				case AbstractColumn::Day:
+					//TODO
+					break;
+				}
 
-			switch (yColMode) {
-			case AbstractColumn::Numeric:
-				tempPoint.setY(yColumn->valueAt(row));
-				break;
-			case AbstractColumn::Text:
-			//TODO
-			case AbstractColumn::DateTime:
-			case AbstractColumn::Month:
-			case AbstractColumn::Day:
+				switch (yColMode) {
+				case AbstractColumn::Numeric:
+				case AbstractColumn::Integer:
+				case AbstractColumn::BigInt:
+				case AbstractColumn::Float:
+					tempPoint.setY(yColumn->valueAt(row));
+					break;
+				case AbstractColumn::Text:
 				//TODO
-				break;
+				case AbstractColumn::DateTime:
+				case AbstractColumn::Month:
+				case AbstractColumn::Day:
+					//TODO
+					break;
+				}
+				symbolPointsLogical.append(tempPoint);
+				connectedPointsLogical.push_back(true);
+			} else {
+				if (!connectedPointsLogical.empty())
+					connectedPointsLogical[connectedPointsLogical.size()-1] = false;
 			}
-			symbolPointsLogical.append(tempPoint);
-			connectedPointsLogical.push_back(true);
-		} else {
-			if (!connectedPointsLogical.empty())
-				connectedPointsLogical[connectedPointsLogical.size()-1] = false;
 		}
 	}
 
@@ -1290,6 +1321,9 @@ void XYCurvePrivate::updateValues() {
 
 			switch (xColMode) {
 			case AbstractColumn::Numeric:
+			case AbstractColumn::Integer:
+			case AbstractColumn::BigInt:
+			case AbstractColumn::Float:
 				valuesStrings << valuesPrefix + QString::number(valuesColumn->valueAt(i)) + valuesSuffix;
 				break;
 			case AbstractColumn::Text:
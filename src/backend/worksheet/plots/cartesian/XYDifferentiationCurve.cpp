@@ -193,6 +193,8 @@ void XYDifferentiationCurvePrivate::recalculate() {
 	} else {
 		xVector->clear();
 		yVector->clear();
+		xColumn->invalidateProperties();
+		yColumn->invalidateProperties();
 	}
 
 	// clear the previous result
@@ -219,15 +221,18 @@ void XYDifferentiationCurvePrivate::recalculate() {
 	QVector<double> ydataVector;
 	const double xmin = differentiationData.xRange.first();
 	const double xmax = differentiationData.xRange.last();
-	for (int row=0; row<xDataColumn->rowCount(); ++row) {
+	const AbstractColumn::NumericView xView = xDataColumn->numericView();
+	const AbstractColumn::NumericView yView = yDataColumn->numericView();
+	const int rows = qMin(xView.size(), yView.size());
+	for (int row=0; row<rows; ++row) {
 		//only copy those data where _all_ values (for x and y, if given) are valid
-		if (!std::isnan(xDataColumn->valueAt(row)) && !std::isnan(yDataColumn->valueAt(row))
-			&& !xDataColumn->isMasked(row) && !yDataColumn->isMasked(row)) {
-
+		const double x = xView.at(row);
+		const double y = yView.at(row);
+		if (!std::isnan(x) && !std::isnan(y) && !xView.isMasked(row) && !yView.isMasked(row)) {
 			// only when inside given range
-			if (xDataColumn->valueAt(row) >= xmin && xDataColumn->valueAt(row) <= xmax) {
-				xdataVector.append(xDataColumn->valueAt(row));
-				ydataVector.append(yDataColumn->valueAt(row));
+			if (x >= xmin && x <= xmax) {
+				xdataVector.append(x);
+				ydataVector.append(y);
 			}
 		}
 	}
@@ -289,6 +294,10 @@ void XYDifferentiationCurvePrivate::recalculate() {
 	differentiationResult.status = QString::number(status);
 	differentiationResult.elapsedTime = timer.elapsed();
 
+	//the result vectors were filled directly, invalidate the cached properties of the columns
+	xColumn->invalidateProperties();
+	yColumn->invalidateProperties();
+
 	//redraw the curve
 	emit (q->dataChanged());
 	sourceDataChangedSinceLastDifferentiation = false;
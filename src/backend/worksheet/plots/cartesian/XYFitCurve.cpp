@@ -39,12 +39,17 @@
 #include "XYFitCurvePrivate.h"
 #include "backend/core/AbstractColumn.h"
 #include "backend/core/column/Column.h"
+#include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
 #include "backend/gsl/ExpressionParser.h"
 
 extern "C" {
 #include <gsl/gsl_blas.h>
+#include <gsl/gsl_linalg.h>
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_statistics.h>
+#include <gsl/gsl_multifit.h>
 #include <gsl/gsl_vector.h>
 #include <gsl/gsl_matrix.h>
 #include <gsl/gsl_version.h>
@@ -53,10 +58,17 @@ extern "C" {
 #include "backend/nsl/nsl_sf_stats.h"
 }
 #include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <cstring>
 
 #include <KIcon>
 #include <KLocale>
+#include <QCoreApplication>
 #include <QElapsedTimer>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
 #include <QThreadPool>
 
 XYFitCurve::XYFitCurve(const QString& name)
@@ -171,6 +183,21 @@ void XYFitCurve::handleSourceDataChanged() {
 	Q_D(XYFitCurve);
 	d->sourceDataChangedSinceLastFit = true;
 	emit sourceDataChangedSinceLastFit();
+
+	//refit the changed data starting from the last results once the control returns to the event loop,
+	//several changes of the source columns (e.g. of x and y) are handled by one refit
+	if (d->fitData.warmStart && d->fitResult.valid && !d->refitPending) {
+		d->refitPending = true;
+		QMetaObject::invokeMethod(this, "refit", Qt::QueuedConnection);
+	}
+}
+
+//! warm start refit scheduled in handleSourceDataChanged()
+void XYFitCurve::refit() {
+	Q_D(XYFitCurve);
+	d->refitPending = false;
+	if (d->fitData.warmStart && d->fitResult.valid)
+		d->recalculate(true);
 }
 
 //##############################################################################
@@ -180,7 +207,7 @@ XYFitCurvePrivate::XYFitCurvePrivate(XYFitCurve* owner) : XYCurvePrivate(owner),
 	xDataColumn(0), yDataColumn(0), weightsColumn(0),
 	xColumn(0), yColumn(0), residualsColumn(0),
 	xVector(0), yVector(0), residualsVector(0),
-	sourceDataChangedSinceLastFit(false),
+	sourceDataChangedSinceLastFit(false), refitPending(false),
 	q(owner)  {
 
 }
@@ -190,6 +217,18 @@ XYFitCurvePrivate::~XYFitCurvePrivate() {
 	//when the parent aspect is removed
 }
 
+/* state of the model evaluation in one thread. Every thread uses its own parser context
+   since the current values of x and of the parameters are stored in the symbol table */
+struct fitEvaluator {
+	parser_context* context;
+	parser_program* program;	// compiled definition of the model/function
+	symrec* xSymbol;	// handle of the variable x
+	QVector<symrec*> paramSymbols;	// handles of the parameters
+};
+
+/* minimal number of data points evaluated in one thread */
+static const size_t fitChunkSize = 10000;
+
 /* data structure to pass parameter to functions */
 struct data {
 	size_t n;	//number of data points
@@ -199,76 +238,133 @@ struct data {
 	nsl_fit_model_category modelCategory;
 	unsigned int modelType;
 	int degree;
-	QString* func;	// string containing the definition of the model/function
+	fitEvaluator* evaluators;	// one evaluator per chunk of the data
+	int chunks;	// number of chunks evaluated in parallel
 	QStringList* paramNames;
 	double* paramMin;	// lower parameter limits
 	double* paramMax;	// upper parameter limits
 	bool* paramFixed;	// parameter fixed?
 };
 
+/* set current values of the parameters in the symbol table of the evaluator */
+static void set_parameters(fitEvaluator* evaluator, const gsl_vector* paramValues, const struct data* params) {
+	const double* min = params->paramMin;
+	const double* max = params->paramMax;
+	for (int i = 0; i < params->paramNames->size(); i++) {
+		double x = gsl_vector_get(paramValues, i);
+		// bound values if limits are set
+		evaluator->paramSymbols[i]->value.var = nsl_fit_map_bound(x, min[i], max[i]);
+	}
+}
+
 /*!
- * \param paramValues vector containing current values of the fit parameters
- * \param params
- * \param f vector with the weighted residuals (Yi - y[i])/sigma[i]
+ * calculates the weighted residuals (Yi - y[i])/sigma[i] of the data points in chunk \c chunk
  */
-int func_f(const gsl_vector* paramValues, void* params, gsl_vector* f) {
+static void residuals_chunk(const gsl_vector* paramValues, void* params, int chunk, gsl_vector* f) {
 	size_t n = ((struct data*)params)->n;
 	double* x = ((struct data*)params)->x;
 	double* y = ((struct data*)params)->y;
 	double* sigma = ((struct data*)params)->sigma;
 	nsl_fit_model_category modelCategory = ((struct data*)params)->modelCategory;
 	unsigned int modelType = ((struct data*)params)->modelType;
-	QByteArray funcba = ((struct data*)params)->func->toLocal8Bit();	// a local byte array is needed!
-	QStringList* paramNames = ((struct data*)params)->paramNames;
-	double *min = ((struct data*)params)->paramMin;
-	double *max = ((struct data*)params)->paramMax;
+	fitEvaluator* evaluator = &((struct data*)params)->evaluators[chunk];
+	const int chunks = ((struct data*)params)->chunks;
+	const size_t start = n*chunk/chunks, end = n*(chunk + 1)/chunks;
 
-	// set current values of the parameters
-	for (int i = 0; i < paramNames->size(); i++) {
-		double x = gsl_vector_get(paramValues, i);
-		// bound values if limits are set
-		assign_variable(paramNames->at(i).toLocal8Bit().data(), nsl_fit_map_bound(x, min[i], max[i]));
-		QDEBUG("Parameter"<<i<<" (\" "<<paramNames->at(i).toLocal8Bit().data()<<"\")"<<'['<<min[i]<<','<<max[i]
-			<<"] free/bound:"<<QString::number(x, 'g', 15)<<' '<<QString::number(nsl_fit_map_bound(x, min[i], max[i]), 'g', 15));
-	}
+	set_parameters(evaluator, paramValues, (struct data*)params);
 
-	const char *func = funcba.data();	// function to evaluate
-	for (size_t i = 0; i < n; i++) {
-		if (std::isnan(x[i]) || std::isnan(y[i]))
-			continue;
-
-		// checks for allowed values of x for different models
-		// TODO: more to check
-		if (modelCategory == nsl_fit_model_distribution && modelType == nsl_sf_stats_lognormal) {
+	// checks for allowed values of x for different models
+	// TODO: more to check
+	if (modelCategory == nsl_fit_model_distribution && modelType == nsl_sf_stats_lognormal) {
+		for (size_t i = start; i < end; i++) {
 			if (x[i] < 0)
 				x[i] = 0;
 		}
+	}
+
+	// evaluate the model for all x values of the chunk at once
+	QVector<double> Y(end - start);
+	const double* xData = x + start;
+	program_eval_batch(evaluator->program, &evaluator->xSymbol, &xData, 1, end - start, Y.data());
 
-		assign_variable("x", x[i]);
-		double Yi = parse(func);
+	for (size_t i = start; i < end; i++) {
+		if (std::isnan(x[i]) || std::isnan(y[i]))
+			continue;
 
-//		DEBUG("evaluate function"<<QString(func)<<": f(x["<<i<<"]) ="<<Yi);
+		double Yi = Y[i - start];
 
-		if (parse_errors() > 0)
-			return GSL_EINVAL;
+//		DEBUG("evaluate function: f(x["<<i<<"]) ="<<Yi);
 
 		if (sigma)
 			gsl_vector_set (f, i, (Yi - y[i])/sigma[i]);
 		else
 			gsl_vector_set (f, i, (Yi - y[i]));
 	}
+}
+
+static void jacobian_chunk(const gsl_vector* paramValues, void* params, int chunk, gsl_matrix* J);
+
+/* evaluates the residuals (f != 0) or the Jacobian (J != 0) for the data points of one chunk */
+class FitChunkTask : public QRunnable {
+public:
+	FitChunkTask(const gsl_vector* paramValues, struct data* params, int chunk, gsl_vector* f, gsl_matrix* J, QSemaphore* done) :
+		m_paramValues(paramValues), m_params(params), m_chunk(chunk), m_f(f), m_J(J), m_done(done) {
+	}
+
+	void run() {
+		if (m_f)
+			residuals_chunk(m_paramValues, m_params, m_chunk, m_f);
+		else
+			jacobian_chunk(m_paramValues, m_params, m_chunk, m_J);
+		m_done->release();
+	}
+
+private:
+	const gsl_vector* m_paramValues;
+	struct data* m_params;
+	int m_chunk;
+	gsl_vector* m_f;
+	gsl_matrix* m_J;
+	QSemaphore* m_done;
+};
+
+/* evaluates all chunks in parallel. Every data point belongs to exactly one chunk,
+   so the result does not depend on the number of threads or the order of execution. */
+static void evaluate_chunks(const gsl_vector* paramValues, struct data* params, gsl_vector* f, gsl_matrix* J) {
+	QSemaphore done;
+	for (int k = 1; k < params->chunks; k++)
+		QThreadPool::globalInstance()->start(new FitChunkTask(paramValues, params, k, f, J, &done));
+
+	// the first chunk is evaluated in the calling thread
+	FitChunkTask(paramValues, params, 0, f, J, &done).run();
+	done.acquire(params->chunks);
+}
+
+/*!
+ * \param paramValues vector containing current values of the fit parameters
+ * \param params
+ * \param f vector with the weighted residuals (Yi - y[i])/sigma[i]
+ */
+int func_f(const gsl_vector* paramValues, void* params, gsl_vector* f) {
+	if (!((struct data*)params)->evaluators[0].program)
+		return GSL_EINVAL;
+
+	evaluate_chunks(paramValues, (struct data*)params, f, 0);
 
 	return GSL_SUCCESS;
 }
 
 /*!
- * calculates the matrix elements of Jacobian matrix
+ * calculates the matrix elements of Jacobian matrix for the data points in chunk \c chunk
  * \param paramValues current parameter values
  * \param params
+ * \param chunk
  * \param J Jacobian matrix
  * */
-int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
+static void jacobian_chunk(const gsl_vector* paramValues, void* params, int chunk, gsl_matrix* J) {
 	size_t n = ((struct data*)params)->n;
+	const int chunks = ((struct data*)params)->chunks;
+	const size_t start = n*chunk/chunks, end = n*(chunk + 1)/chunks;
 	double* xVector = ((struct data*)params)->x;
 	double* sigmaVector = ((struct data*)params)->sigma;
 	nsl_fit_model_category modelCategory = ((struct data*)params)->modelCategory;
@@ -290,7 +386,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 	case nsl_fit_model_basic:
 		switch (modelType) {
 		case nsl_fit_model_polynomial:	// Y(x) = c0 + c1*x + ... + cn*x^n
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 				for (int j = 0; j < paramNames->size(); ++j) {
@@ -305,7 +401,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			if (degree == 1) {
 				double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 				double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-				for (size_t i = 0; i < n; i++) {
+				for (size_t i = start; i < end; i++) {
 					x = xVector[i];
 					if (sigmaVector) sigma = sigmaVector[i];
 
@@ -319,7 +415,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 				} else if (degree == 2) {
 				double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 				double c = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
-				for (size_t i = 0; i < n; i++) {
+				for (size_t i = start; i < end; i++) {
 					x = xVector[i];
 					if (sigmaVector) sigma = sigmaVector[i];
 
@@ -336,7 +432,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			if (degree == 1) {
 				double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 				double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-				for (size_t i = 0; i < n; i++) {
+				for (size_t i = start; i < end; i++) {
 					x = xVector[i];
 					if (sigmaVector) sigma = sigmaVector[i];
 
@@ -352,7 +448,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 				double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 				double c = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 				double d = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
-				for (size_t i = 0; i < n; i++) {
+				for (size_t i = start; i < end; i++) {
 					x = xVector[i];
 					if (sigmaVector) sigma = sigmaVector[i];
 	
@@ -370,7 +466,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 				double d = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
 				double e = nsl_fit_map_bound(gsl_vector_get(paramValues, 4), min[4], max[4]);
 				double f = nsl_fit_map_bound(gsl_vector_get(paramValues, 5), min[5], max[5]);
-				for (size_t i = 0; i < n; i++) {
+				for (size_t i = start; i < end; i++) {
 					x = xVector[i];
 					if (sigmaVector) sigma = sigmaVector[i];
 
@@ -386,7 +482,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_fit_model_inverse_exponential: {	// Y(x) = a*(1-exp(b*x))+c
 			double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -410,7 +506,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 				a[i] = nsl_fit_map_bound(gsl_vector_get(paramValues, 2*i), min[2*i], max[2*i]);
 				b[i] = nsl_fit_map_bound(gsl_vector_get(paramValues, 2*i+1), min[2*i+1], max[2*i+1]);
 			}
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 				double wd = 0; //first derivative with respect to the w parameter
@@ -440,7 +536,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_fit_model_sech:
 		case nsl_fit_model_logistic: {
 			double s, mu, a;
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -494,7 +590,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -537,7 +633,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -579,7 +675,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_sf_stats_rayleigh: {
 			double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -596,7 +692,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			double t = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			double k = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -612,7 +708,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_sf_stats_chi_squared: {
 			double n = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -630,7 +726,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			double l = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 			double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -652,7 +748,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 			double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -668,7 +764,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_sf_stats_poisson: {
 			double l = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -684,7 +780,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_sf_stats_maxwell_boltzmann: {	// Y(x) = a*sqrt(2/pi) * x^2/s^3 * exp(-(x/s)^2/2)
 			double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -702,7 +798,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 			double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = start; i < end; i++) {
 				x = xVector[i];
 				if (sigmaVector) sigma = sigmaVector[i];
 
@@ -739,48 +835,35 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			break;
 		}
 		break;
-	case nsl_fit_model_custom:
-		QByteArray funcba = ((struct data*)params)->func->toLocal8Bit();
-		char* func = funcba.data();
-		QByteArray nameba;
-		double value;
+	case nsl_fit_model_custom: {
+		fitEvaluator* evaluator = &((struct data*)params)->evaluators[chunk];
 		const unsigned int np = paramNames->size();
-		for (size_t i = 0; i < n; i++) {
-			x = xVector[i];
-			assign_variable("x", x);
-			if (sigmaVector) sigma = sigmaVector[i];
 
-			for (unsigned int j = 0; j < np; j++) {
-				for (unsigned int k = 0; k < np; k++) {
-					if (k != j) {
-						nameba = paramNames->at(k).toLocal8Bit();
-						value = nsl_fit_map_bound(gsl_vector_get(paramValues, k), min[k], max[k]);
-						assign_variable(nameba.data(), value);
-					}
-				}
+		set_parameters(evaluator, paramValues, (struct data*)params);
 
-				nameba = paramNames->at(j).toLocal8Bit();
-				char *name = nameba.data();
-				value = nsl_fit_map_bound(gsl_vector_get(paramValues, j), min[j], max[j]);
-				assign_variable(name, value);
-				double f_p = parse(func);
-
-				double eps = 1.e-9*fabs(f_p);	// adapt step size to value
-				value += eps;
-				assign_variable(name, value);
-				double f_pdp = parse(func);
-
-//		qDebug()<<"evaluate deriv"<<QString(func)<<": f(x["<<i<<"]) ="<<QString::number(f_p, 'g', 15);
-//		qDebug()<<"evaluate deriv"<<QString(func)<<": f(x["<<i<<"]+dx) ="<<QString::number(f_pdp, 'g', 15);
-//		qDebug()<<"	deriv = "<<QString::number((f_pdp-f_p)/eps/sigma, 'g', 15);
+		// exact derivatives with respect to all parameters (automatic differentiation of the model)
+		QVector<double> grad(np);
+		for (size_t i = start; i < end; i++) {
+			evaluator->xSymbol->value.var = xVector[i];
+			if (sigmaVector) sigma = sigmaVector[i];
 
+			program_eval_deriv(evaluator->program, evaluator->paramSymbols.data(), np, grad.data());
+			for (unsigned int j = 0; j < np; j++) {
 				if (fixed[j])
 					gsl_matrix_set(J, i, j, 0.);
-				else	// calculate finite difference
-					gsl_matrix_set(J, i, j, (f_pdp - f_p)/eps/sigma);
+				else
+					gsl_matrix_set(J, i, j, grad[j]/sigma);
 			}
 		}
 	}
+	}
+}
+
+int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
+	if (!((struct data*)params)->evaluators[0].program)
+		return GSL_EINVAL;
+
+	evaluate_chunks(paramValues, (struct data*)params, 0, J);
 
 	return GSL_SUCCESS;
 }
@@ -792,7 +875,12 @@ int func_fdf(const gsl_vector* x, void* params, gsl_vector* f, gsl_matrix* J) {
 	return GSL_SUCCESS;
 }
 
-void XYFitCurvePrivate::recalculate() {
+/*!
+ * performs the fit. For a warm start (\c warmStart is \c true and warm starts are enabled in the fit options)
+ * the results of the last fit are used as start values of the free parameters
+ * and the sums of a linear fit are continued if data points were appended.
+ */
+void XYFitCurvePrivate::recalculate(bool warmStart) {
 	QElapsedTimer timer;
 	timer.start();
 
@@ -821,8 +909,16 @@ void XYFitCurvePrivate::recalculate() {
 		xVector->clear();
 		yVector->clear();
 		residualsVector->clear();
+		xColumn->invalidateProperties();
+		yColumn->invalidateProperties();
+		residualsColumn->invalidateProperties();
 	}
 
+	//start values of a warm start
+	QVector<double> lastParamValues;
+	if (warmStart && fitData.warmStart && fitResult.valid && fitResult.paramValues.size() == fitData.paramNames.size())
+		lastParamValues = fitResult.paramValues;
+
 	// clear the previous result
 	fitResult = XYFitCurve::FitResult();
 
@@ -832,66 +928,150 @@ void XYFitCurvePrivate::recalculate() {
 		return;
 	}
 
-	//fit settings
-	const int maxIters = fitData.maxIterations;	//maximal number of iterations
-	const double delta = fitData.eps;		//fit tolerance
-	const unsigned int np = fitData.paramNames.size(); //number of fit parameters
-	if (np == 0) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("Model has no parameters.");
+	//copy all valid data point for the fit to temporary vectors
+	QVector<double> xdataVector;
+	QVector<double> ydataVector;
+	QVector<double> sigmaVector;
+	if (!prepareData(fitData, xDataColumn, yDataColumn, weightsColumn, xdataVector, ydataVector, sigmaVector, fitResult)) {
 		emit (q->dataChanged());
 		sourceDataChangedSinceLastFit = false;
 		return;
 	}
 
+	//the model is evaluated in the global thread pool only if it's not waited for in a thread of the pool
+	const bool parallel = (QThread::currentThread() == QCoreApplication::instance()->thread());
+	QVector<double> residuals;
+	if (!lastParamValues.isEmpty()) {
+		XYFitCurve::FitData warmStartData = fitData;
+		for (int i = 0; i < lastParamValues.size(); i++)
+			if (!fitData.paramFixed.at(i))
+				warmStartData.paramStartValues[i] = lastParamValues.at(i);
+		fit(warmStartData, xdataVector, ydataVector, sigmaVector, parallel, fitResult, residuals, &linearFitStatistics);
+	} else
+		fit(fitData, xdataVector, ydataVector, sigmaVector, parallel, fitResult, residuals, fitData.warmStart ? &linearFitStatistics : 0);
+
+	// use results as start values if desired
+	if (fitData.useResults) {
+		for (int i = 0; i < fitResult.paramValues.size(); i++) {
+			fitData.paramStartValues.data()[i] = fitResult.paramValues[i];
+			DEBUG("saving parameter"<<i<<fitResult.paramValues[i]<<fitData.paramStartValues.data()[i]);
+		}
+	}
+
+	// fill residuals vector. To get residuals on the correct x values, fill the rest with zeros.
+	double xmin = fitData.xRange.first();
+	double xmax = fitData.xRange.last();
+	residualsVector->resize(xDataColumn->rowCount());
+	if (fitData.evaluateFullRange) {	// evaluate full range of residuals
+		xVector->resize(xDataColumn->rowCount());
+		for (int i = 0; i < xDataColumn->rowCount(); i++)
+			(*xVector)[i] = xDataColumn->valueAt(i);
+		ExpressionParser* parser = ExpressionParser::getInstance();
+		bool rc = parser->evaluateCartesian(fitData.model, xVector, residualsVector,
+							fitData.paramNames, fitResult.paramValues);
+		for (int i = 0; i < xDataColumn->rowCount(); i++)
+			(*residualsVector)[i] = yDataColumn->valueAt(i) - (*residualsVector)[i];
+		if (!rc)
+			residualsVector->clear();
+	} else {	// only selected range
+		int j = 0;
+		for (int i = 0; i < xDataColumn->rowCount(); i++) {
+			if (xDataColumn->valueAt(i) >= xmin && xDataColumn->valueAt(i) <= xmax)
+				residualsVector->data()[i] = (j < residuals.size()) ? residuals.at(j++) : 0;
+			else	// outside range
+				residualsVector->data()[i] = 0;
+		}
+	}
+	residualsColumn->setChanged();
+
+	//calculate the fit function (vectors)
+	ExpressionParser* parser = ExpressionParser::getInstance();
+	if (fitData.evaluateFullRange) { // evaluate fit on full data range if selected
+		xmin = xDataColumn->minimum();
+		xmax = xDataColumn->maximum();
+	}
+	xVector->resize(fitData.evaluatedPoints);
+	yVector->resize(fitData.evaluatedPoints);
+	bool rc = parser->evaluateCartesian(fitData.model, QString::number(xmin), QString::number(xmax), fitData.evaluatedPoints, xVector, yVector,
+						fitData.paramNames, fitResult.paramValues);
+	if (!rc) {
+		xVector->clear();
+		yVector->clear();
+	}
+
+	fitResult.elapsedTime = timer.elapsed();
+
+	//the result vectors were filled directly, invalidate the cached properties of the columns
+	xColumn->invalidateProperties();
+	yColumn->invalidateProperties();
+
+	//redraw the curve
+	emit (q->dataChanged());
+	sourceDataChangedSinceLastFit = false;
+}
+
+/*!
+ * copies all valid data points of the columns inside the x range of \c fitData to the vectors
+ * \c xdata, \c ydata and \c sigma (only if weights are used).
+ * Returns \c false and sets the status of \c result if no fit is possible with the data.
+ */
+bool XYFitCurvePrivate::prepareData(const XYFitCurve::FitData& fitData, const AbstractColumn* xDataColumn, const AbstractColumn* yDataColumn,
+		const AbstractColumn* weightsColumn, QVector<double>& xdata, QVector<double>& ydata, QVector<double>& sigma, XYFitCurve::FitResult& result) {
+	const unsigned int np = fitData.paramNames.size(); //number of fit parameters
+	if (np == 0) {
+		result.available = true;
+		result.valid = false;
+		result.status = i18n("Model has no parameters.");
+		return false;
+	}
+
 	//check column sizes
 	if (xDataColumn->rowCount() != yDataColumn->rowCount()) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("Number of x and y data points must be equal.");
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
+		result.available = true;
+		result.valid = false;
+		result.status = i18n("Number of x and y data points must be equal.");
+		return false;
 	}
 	if (weightsColumn) {
 		if (weightsColumn->rowCount() < xDataColumn->rowCount()) {
-			fitResult.available = true;
-			fitResult.valid = false;
-			fitResult.status = i18n("Not sufficient weight data points provided.");
-			emit (q->dataChanged());
-			sourceDataChangedSinceLastFit = false;
-			return;
+			result.available = true;
+			result.valid = false;
+			result.status = i18n("Not sufficient weight data points provided.");
+			return false;
 		}
 	}
 
 	//copy all valid data point for the fit to temporary vectors
-	QVector<double> xdataVector;
-	QVector<double> ydataVector;
-	QVector<double> sigmaVector;
-	double xmin = fitData.xRange.first();
-	double xmax = fitData.xRange.last();
-	for (int row=0; row < xDataColumn->rowCount(); ++row) {
+	const double xmin = fitData.xRange.first();
+	const double xmax = fitData.xRange.last();
+	const AbstractColumn::NumericView xView = xDataColumn->numericView();
+	const AbstractColumn::NumericView yView = yDataColumn->numericView();
+	AbstractColumn::NumericView wView;
+	if (weightsColumn)
+		wView = weightsColumn->numericView();
+	const int rows = qMin(xView.size(), yView.size());
+	for (int row=0; row < rows; ++row) {
 		//only copy those data where _all_ values (for x, y and sigma, if given) are valid
-		if (!std::isnan(xDataColumn->valueAt(row)) && !std::isnan(yDataColumn->valueAt(row))
-			&& !xDataColumn->isMasked(row) && !yDataColumn->isMasked(row)) {
-
+		const double x = xView.at(row);
+		const double y = yView.at(row);
+		if (!std::isnan(x) && !std::isnan(y) && !xView.isMasked(row) && !yView.isMasked(row)) {
 			// only when inside given range
-			if (xDataColumn->valueAt(row) >= xmin && xDataColumn->valueAt(row) <= xmax) {
+			if (x >= xmin && x <= xmax) {
 				if (!weightsColumn) {
-					xdataVector.append(xDataColumn->valueAt(row));
-					ydataVector.append(yDataColumn->valueAt(row));
+					xdata.append(x);
+					ydata.append(y);
 				} else {
-					if (!std::isnan(weightsColumn->valueAt(row))) {
-						xdataVector.append(xDataColumn->valueAt(row));
-						ydataVector.append(yDataColumn->valueAt(row));
+					const double w = (row < wView.size()) ? wView.at(row) : NAN;
+					if (!std::isnan(w)) {
+						xdata.append(x);
+						ydata.append(y);
 
 						if (fitData.weightsType == XYFitCurve::WeightsFromColumn) {
 							//weights from a given column -> calculate the square root of the inverse (sigma = sqrt(1/weight))
-							sigmaVector.append( sqrt(1./weightsColumn->valueAt(row)) );
+							sigma.append( sqrt(1./w) );
 						} else if (fitData.weightsType == XYFitCurve::WeightsFromErrorColumn) {
 							//weights from a given column with error bars (sigma = error)
-							sigmaVector.append( weightsColumn->valueAt(row) );
+							sigma.append( w );
 						}
 					}
 				}
@@ -900,40 +1080,357 @@ void XYFitCurvePrivate::recalculate() {
 	}
 
 	//number of data points to fit
-	const size_t n = xdataVector.size();
+	const size_t n = xdata.size();
 	if (n == 0) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("No data points available.");
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
+		result.available = true;
+		result.valid = false;
+		result.status = i18n("No data points available.");
+		return false;
 	}
 
 	if (n < np) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("The number of data points (%1) must be greater than or equal to the number of parameters (%2).", n, np);
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
+		result.available = true;
+		result.valid = false;
+		result.status = i18n("The number of data points (%1) must be greater than or equal to the number of parameters (%2).", n, np);
+		return false;
+	}
+
+	return true;
+}
+
+/*!
+ * fits the model defined in \c fitData to the data points and writes the parameters and the goodness of the fit to \c result.
+ * \c residuals contains the weighted residuals (y_i - Y_i)/sigma_i of the data points afterwards.
+ * Models which are linear in their free parameters are solved directly, all other models iteratively.
+ * For linear models the sums of the normal equations are kept in \c statistics, if given.
+ * If \c parallel is \c true, the model and its derivatives are evaluated in parallel for large data sets
+ * (must be \c false when called from a thread of the global thread pool).
+ */
+void XYFitCurvePrivate::fit(const XYFitCurve::FitData& fitData, QVector<double>& xdataVector, const QVector<double>& ydataVector,
+		const QVector<double>& sigmaVector, bool parallel, XYFitCurve::FitResult& result, QVector<double>& residuals, LinearFitStatistics* statistics) {
+	const unsigned int np = fitData.paramNames.size(); //number of fit parameters
+	const size_t n = xdataVector.size();
+	const double* ydata = ydataVector.data();
+
+	gsl_matrix* covar = gsl_matrix_alloc(np, np);
+	residuals.resize(n);
+	if (isLinearModel(fitData))
+		linearFit(fitData, xdataVector, ydataVector, sigmaVector, result, covar, residuals, statistics);
+	else
+		nonlinearFit(fitData, xdataVector, ydataVector, sigmaVector, parallel, result, covar, residuals);
+
+	//write the result
+	result.available = true;
+	result.valid = true;
+	result.dof = n - np;
+
+	//calculate:
+	//residuals r_i = y_i - Y_i = - (Y_i - y_i)
+	//sse = sum of squared errors (SSE) = residual sum of errors (RSS) = sum of sq. residuals (SSR) = \sum_i^n (Y_i-y_i)^2
+	//mse = mean squared error = 1/n \sum_i^n  (Y_i-y_i)^2
+	//rmse = root-mean squared error = \sqrt(mse)
+	//mae = mean absolute error = \sum_i^n |Y_i-y_i|
+	//rms = residual mean square = sse/d.o.f.
+	//rsd = residual standard deviation = sqrt(rms)
+	//Coefficient of determination, R-squared = 1 - SSE/SSTOT with the total sum of squares SSTOT = \sum_i (y_i - ybar)^2 and ybar = 1/n \sum_i y_i
+	//Adjusted Coefficient of determination  adj. R-squared = 1 - (1-R-squared^2)*(n-1)/(n-np-1);
+	// see also http://www.originlab.com/doc/Origin-Help/NLFit-Algorithm
+
+	//the residuals are weighted with 1/sigma[i]
+	gsl_vector_view f = gsl_vector_view_array(residuals.data(), n);
+	result.sse = gsl_pow_2(gsl_blas_dnrm2(&f.vector));
+	result.mse = result.sse/n;
+	result.rmse = sqrt(result.mse);
+	result.mae = gsl_blas_dasum(&f.vector);
+	if (result.dof != 0) {
+		result.rms = result.sse/result.dof;
+		result.rsd = sqrt(result.rms);
+	}
+
+	//coefficient of determination, R-squared
+	double ybar = 0; //mean value of the y-data
+	for (size_t i = 0; i < n; ++i)
+		ybar += ydata[i];
+	ybar = ybar/n;
+	double sstot = 0;
+	for (size_t i = 0; i < n; ++i)
+		sstot += gsl_pow_2(ydata[i]-ybar);
+	result.rsquared = 1. - result.sse/sstot;
+	result.rsquaredAdj = 1. - (1. - result.rsquared*result.rsquared)*(n-1.)/(n-np-1.);
+
+	//parameter errors
+	const double c = GSL_MIN_DBL(1., sqrt(result.sse)); //limit error for poor fit
+	result.errorValues.resize(np);
+	for (unsigned int i = 0; i < np; i++)
+		result.errorValues[i] = c*sqrt(gsl_matrix_get(covar, i, i));
+
+	gsl_matrix_free(covar);
+
+	//confidence intervals from refits to resampled data
+	if (fitData.bootstrapSamples > 0)
+		bootstrap(fitData, xdataVector, ydataVector, sigmaVector, parallel, result);
+}
+
+/*!
+ * returns \c true if the model is linear in all free parameters and none of them is bounded.
+ * This is the case for polynomials and for Fourier series with fixed frequency.
+ */
+bool XYFitCurvePrivate::isLinearModel(const XYFitCurve::FitData& fitData) {
+	if (fitData.modelCategory != nsl_fit_model_basic)
+		return false;
+	if (fitData.modelType == nsl_fit_model_fourier) {
+		if (!fitData.paramFixed.at(0))	// frequency w
+			return false;
+	} else if (fitData.modelType != nsl_fit_model_polynomial)
+		return false;
+
+	for (int j = 0; j < fitData.paramNames.size(); j++) {
+		if (!fitData.paramFixed.at(j) && (fitData.paramLowerLimits.at(j) != -DBL_MAX || fitData.paramUpperLimits.at(j) != DBL_MAX))
+			return false;
+	}
+
+	return true;
+}
+
+/*!
+ * value of the basis function of parameter \c j of a linear model at \c x
+ */
+static double linear_basis(const XYFitCurve::FitData& fitData, int j, double x) {
+	if (fitData.modelType == nsl_fit_model_polynomial)	// Y(x) = c0 + c1*x + ... + cn*x^n
+		return nsl_fit_model_polynomial_param_deriv(x, j, 1.);
+
+	// Y(x) = a0 + (a1*cos(w*x) + b1*sin(w*x)) + ... + (an*cos(n*w*x) + bn*sin(n*w*x)
+	//parameters: w, a0, a1, b1, ... an, bn
+	if (j == 0)	// the fixed frequency is not a coefficient
+		return 0.;
+	if (j == 1)
+		return 1.;
+	return nsl_fit_model_fourier_param_deriv(j%2, j/2, x, fitData.paramStartValues.at(0), 1.);
+}
+
+/*!
+ * returns \c true if the sums were calculated for the same model and for the first data points of
+ * \c xdata, \c ydata and \c sigma, i.e. if they can be continued with the remaining data points
+ */
+bool LinearFitStatistics::isContinuation(const XYFitCurve::FitData& fitData, const QVector<double>& x, const QVector<double>& y,
+		const QVector<double>& s) const {
+	if (count == 0 || count > x.size() || weighted == s.isEmpty())
+		return false;
+	if (model != fitData.model || paramFixed != fitData.paramFixed)
+		return false;
+
+	for (int j = 0, k = 0; j < paramFixed.size(); j++)
+		if (paramFixed.at(j) && fixedValues.at(k++) != fitData.paramStartValues.at(j))
+			return false;
+
+	return (dataChecksum(x, y, s, count) == checksum);
+}
+
+/*!
+ * returns the FNV-1a hash (over 64 bit words) of the bit patterns of the first \c count data points, the data points
+ * included in the sums are recognized by it without keeping a copy of them
+ */
+quint64 LinearFitStatistics::dataChecksum(const QVector<double>& x, const QVector<double>& y, const QVector<double>& s, int count) {
+	quint64 hash = Q_UINT64_C(14695981039346656037);
+	for (int i = 0; i < count; i++) {
+		const double values[3] = {x.at(i), y.at(i), s.isEmpty() ? 0. : s.at(i)};
+		for (int j = 0; j < 3; j++) {
+			quint64 bits;
+			memcpy(&bits, &values[j], sizeof(bits));
+			hash ^= bits;
+			hash *= Q_UINT64_C(1099511628211);
+		}
+	}
+	return hash;
+}
+
+/*!
+ * solves the weighted linear least squares problem of a linear model directly.
+ * Without \c statistics GSL's linear solver is used. Otherwise the normal equations are solved
+ * and their sums are kept in \c statistics, so only appended data points need to be added in the next fit.
+ */
+void XYFitCurvePrivate::linearFit(const XYFitCurve::FitData& fitData, const QVector<double>& xdata, const QVector<double>& ydata,
+		const QVector<double>& sigma, XYFitCurve::FitResult& result, gsl_matrix* covar, QVector<double>& residuals, LinearFitStatistics* statistics) {
+	const unsigned int np = fitData.paramNames.size();
+	const size_t n = xdata.size();
+
+	//the fixed parameters are not part of the linear system
+	QVector<int> freeParams;
+	for (unsigned int j = 0; j < np; j++)
+		if (!fitData.paramFixed.at(j))
+			freeParams << j;
+	const size_t nfree = freeParams.size();
+
+	result.paramValues = fitData.paramStartValues;
+	gsl_matrix_set_zero(covar);
+
+	int status = GSL_SUCCESS;
+	bool solved = (nfree == 0);
+	if (!solved && statistics) {
+		// continue the sums of the last fit if data points were only appended
+		size_t start = 0;
+		if (statistics->isContinuation(fitData, xdata, ydata, sigma)) {
+			start = statistics->count;
+		} else {
+			statistics->model = fitData.model;
+			statistics->paramFixed = fitData.paramFixed;
+			statistics->fixedValues.clear();
+			for (unsigned int j = 0; j < np; j++)
+				if (fitData.paramFixed.at(j))
+					statistics->fixedValues << fitData.paramStartValues.at(j);
+			statistics->XtWX.fill(0., nfree*nfree);
+			statistics->XtWy.fill(0., nfree);
+		}
+		DEBUG("linear fit: adding data points"<<start<<"to"<<n);
+
+		double* XtWX = statistics->XtWX.data();
+		double* XtWy = statistics->XtWy.data();
+		QVector<double> basis(nfree);
+		for (size_t i = start; i < n; i++) {
+			// the contribution of the fixed parameters is subtracted from the data
+			double yi = ydata.at(i);
+			for (unsigned int j = 0; j < np; j++)
+				if (fitData.paramFixed.at(j))
+					yi -= fitData.paramStartValues.at(j)*linear_basis(fitData, j, xdata.at(i));
+			const double wi = sigma.isEmpty() ? 1. : 1./gsl_pow_2(sigma.at(i));
+			for (size_t k = 0; k < nfree; k++)
+				basis[k] = linear_basis(fitData, freeParams.at(k), xdata.at(i));
+			for (size_t k = 0; k < nfree; k++) {
+				for (size_t l = 0; l < nfree; l++)
+					XtWX[k*nfree + l] += wi*basis[k]*basis[l];
+				XtWy[k] += wi*basis[k]*yi;
+			}
+		}
+		statistics->count = n;
+		statistics->weighted = !sigma.isEmpty();
+		statistics->checksum = LinearFitStatistics::dataChecksum(xdata, ydata, sigma, n);
+
+		// Cholesky decomposition of the normal matrix, the inverse is the covariance matrix
+		gsl_matrix* L = gsl_matrix_alloc(nfree, nfree);
+		gsl_matrix_const_view A = gsl_matrix_const_view_array(XtWX, nfree, nfree);
+		gsl_matrix_memcpy(L, &A.matrix);
+		if (gsl_linalg_cholesky_decomp(L) == GSL_SUCCESS) {
+			gsl_vector* c = gsl_vector_alloc(nfree);
+			gsl_vector_const_view b = gsl_vector_const_view_array(XtWy, nfree);
+			gsl_linalg_cholesky_solve(L, &b.vector, c);
+			gsl_linalg_cholesky_invert(L);
+			for (size_t k = 0; k < nfree; k++) {
+				result.paramValues[freeParams.at(k)] = gsl_vector_get(c, k);
+				for (size_t l = 0; l < nfree; l++)
+					gsl_matrix_set(covar, freeParams.at(k), freeParams.at(l), gsl_matrix_get(L, k, l));
+			}
+			gsl_vector_free(c);
+			solved = true;
+		} else {
+			// (nearly) singular normal matrix: use the SVD below
+			statistics->count = 0;
+		}
+		gsl_matrix_free(L);
+	}
+
+	if (!solved) {
+		// design matrix X, the contribution of the fixed parameters is subtracted from the data
+		gsl_vector* y = gsl_vector_alloc(n);
+		gsl_vector* w = gsl_vector_alloc(n);
+		gsl_matrix* X = gsl_matrix_alloc(n, nfree);
+		for (size_t i = 0; i < n; i++) {
+			double yi = ydata.at(i);
+			for (unsigned int j = 0; j < np; j++)
+				if (fitData.paramFixed.at(j))
+					yi -= fitData.paramStartValues.at(j)*linear_basis(fitData, j, xdata.at(i));
+			gsl_vector_set(y, i, yi);
+			gsl_vector_set(w, i, sigma.isEmpty() ? 1. : 1./gsl_pow_2(sigma.at(i)));
+			for (size_t k = 0; k < nfree; k++)
+				gsl_matrix_set(X, i, k, linear_basis(fitData, freeParams.at(k), xdata.at(i)));
+		}
+
+		gsl_vector* c = gsl_vector_alloc(nfree);
+		gsl_matrix* cov = gsl_matrix_alloc(nfree, nfree);
+		gsl_multifit_linear_workspace* work = gsl_multifit_linear_alloc(n, nfree);
+		double chisq;
+		status = gsl_multifit_wlinear(X, w, y, c, cov, &chisq, work);
+
+		for (size_t k = 0; k < nfree; k++) {
+			result.paramValues[freeParams.at(k)] = gsl_vector_get(c, k);
+			for (size_t l = 0; l < nfree; l++)
+				gsl_matrix_set(covar, freeParams.at(k), freeParams.at(l), gsl_matrix_get(cov, k, l));
+		}
+
+		gsl_multifit_linear_free(work);
+		gsl_matrix_free(cov);
+		gsl_vector_free(c);
+		gsl_matrix_free(X);
+		gsl_vector_free(w);
+		gsl_vector_free(y);
+	}
+
+	//weighted residuals (y_i - Y_i)/sigma_i
+	for (size_t i = 0; i < n; i++) {
+		double Yi = 0;
+		for (unsigned int j = 0; j < np; j++)
+			Yi += result.paramValues.at(j)*linear_basis(fitData, j, xdata.at(i));
+		residuals[i] = sigma.isEmpty() ? ydata.at(i) - Yi : (ydata.at(i) - Yi)/sigma.at(i);
 	}
 
+	result.status = QString(gsl_strerror(status)); // i18n? GSL does not support translations
+	result.iterations = 1;
+
+	//final state (parameter values and chi^2), same format as the iterative solver
+	QString state;
+	for (unsigned int j = 0; j < np; ++j)
+		state += QString::number(result.paramValues.at(j)) + '\t';
+	gsl_vector_view f = gsl_vector_view_array(residuals.data(), n);
+	state += QString::number(gsl_pow_2(gsl_blas_dnrm2(&f.vector)));
+	state += ';';
+	result.solverOutput = state;
+}
+
+/*!
+ * fits the model iteratively with the Levenberg-Marquardt solver
+ */
+void XYFitCurvePrivate::nonlinearFit(const XYFitCurve::FitData& fitData, QVector<double>& xdataVector, const QVector<double>& ydataVector,
+		const QVector<double>& sigmaVector, bool parallel, XYFitCurve::FitResult& result, gsl_matrix* covar, QVector<double>& residuals) {
+	//fit settings
+	const int maxIters = fitData.maxIterations;	//maximal number of iterations
+	const double delta = fitData.eps;		//fit tolerance
+	const unsigned int np = fitData.paramNames.size(); //number of fit parameters
+	const size_t n = xdataVector.size();
+
 	double* xdata = xdataVector.data();
-	double* ydata = ydataVector.data();
+	const double* ydata = ydataVector.data();
 	double* sigma = 0;
 	if (!sigmaVector.isEmpty())
-		sigma = sigmaVector.data();
+		sigma = const_cast<double*>(sigmaVector.data());
 
 	/////////////////////// GSL >= 2 has a complete new interface! But the old one is still supported. ///////////////////////////
 	// GSL >= 2 : "the 'fdf' field of gsl_multifit_function_fdf is now deprecated and does not need to be specified for nonlinear least squares problems"
 	for (unsigned int i = 0; i < np; i++)
-		DEBUG("fixed parameter"<<i<<fitData.paramFixed.data()[i]);
+		DEBUG("fixed parameter"<<i<<fitData.paramFixed.at(i));
+
+	//split the data into chunks evaluated in parallel, parse the model only once per chunk
+	//and look up the variables used in the fit functions
+	const int chunks = parallel ? qBound(1, (int)(n/fitChunkSize), QThreadPool::globalInstance()->maxThreadCount()) : 1;
+	QVector<fitEvaluator> evaluators(chunks);
+	const QByteArray model = fitData.model.toLocal8Bit();
+	for (int k = 0; k < chunks; k++) {
+		fitEvaluator& evaluator = evaluators[k];
+		evaluator.context = parser_context_new();
+		evaluator.paramSymbols.resize(np);
+		for (unsigned int i = 0; i < np; i++)
+			evaluator.paramSymbols[i] = parser_context_assign_variable(evaluator.context, fitData.paramNames.at(i).toLocal8Bit().data(),
+				fitData.paramStartValues.at(i));
+		evaluator.xSymbol = parser_context_assign_variable(evaluator.context, "x", 0);
+		evaluator.program = parser_context_compile(evaluator.context, model.data());
+	}
 
 	//function to fit
 	gsl_multifit_function_fdf f;
-	struct data params = {n, xdata, ydata, sigma, fitData.modelCategory, fitData.modelType, fitData.degree, &fitData.model, &fitData.paramNames, 
-				fitData.paramLowerLimits.data(), fitData.paramUpperLimits.data(), fitData.paramFixed.data()};
+	QStringList paramNames = fitData.paramNames;
+	QVector<double> x_min = fitData.paramLowerLimits;
+	QVector<double> x_max = fitData.paramUpperLimits;
+	QVector<bool> fixed = fitData.paramFixed;
+	struct data params = {n, xdata, const_cast<double*>(ydata), sigma, fitData.modelCategory, fitData.modelType, fitData.degree, evaluators.data(), chunks,
+				&paramNames, x_min.data(), x_max.data(), fixed.data()};
 	f.f = &func_f;
 	f.df = &func_df;
 	f.fdf = &func_fdf;
@@ -945,162 +1442,207 @@ void XYFitCurvePrivate::recalculate() {
 	const gsl_multifit_fdfsolver_type* T = gsl_multifit_fdfsolver_lmsder;
 	gsl_multifit_fdfsolver* s = gsl_multifit_fdfsolver_alloc(T, n, np);
 
-	// set start values
-	double* x_init = fitData.paramStartValues.data();
-	double* x_min = fitData.paramLowerLimits.data();
-	double* x_max = fitData.paramUpperLimits.data();
-	// scale start values if limits are set
+	// set start values, scaled if limits are set
+	QVector<double> x_init(np);
 	for (unsigned int i = 0; i < np; i++)
-		x_init[i] = nsl_fit_map_unbound(x_init[i], x_min[i], x_max[i]);
-	gsl_vector_view x = gsl_vector_view_array(x_init, np);
+		x_init[i] = nsl_fit_map_unbound(fitData.paramStartValues.at(i), x_min[i], x_max[i]);
+	gsl_vector_view x = gsl_vector_view_array(x_init.data(), np);
 	// initialize solver with function f and inital guess x
 	gsl_multifit_fdfsolver_set(s, &f, &x.vector);
 
 	//iterate
 	int status;
 	int iter = 0;
-	fitResult.solverOutput.clear();
-	writeSolverState(s);
+	result.solverOutput.clear();
+	writeSolverState(s, fitData, result);
 	do {
 		iter++;
 		status = gsl_multifit_fdfsolver_iterate(s);
-		writeSolverState(s);
+		writeSolverState(s, fitData, result);
 		if (status) break;
 		status = gsl_multifit_test_delta(s->dx, s->x, delta, delta);
 	} while (status == GSL_CONTINUE && iter < maxIters);
 
-	// unscale start values again
-	for (unsigned int i = 0; i < np; i++)
-		x_init[i] = nsl_fit_map_bound(x_init[i], x_min[i], x_max[i]);
-
 	//get the covariance matrix
 	//TODO: scale the Jacobian when limits are used before constructing the covar matrix?
-	gsl_matrix* covar = gsl_matrix_alloc(np, np);
 #if GSL_MAJOR_VERSION >= 2
 	// the Jacobian is not part of the solver anymore
 	gsl_matrix *J = gsl_matrix_alloc(s->fdf->n, s->fdf->p);
 	gsl_multifit_fdfsolver_jac(s, J);
 	gsl_multifit_covar(J, 0.0, covar);
+	gsl_matrix_free(J);
 #else
 	gsl_multifit_covar(s->J, 0.0, covar);
 #endif
 
-	//write the result
-	fitResult.available = true;
-	fitResult.valid = true;
-	fitResult.status = QString(gsl_strerror(status)); // i18n? GSL does not support translations
-	fitResult.iterations = iter;
-	fitResult.dof = n - np;
+	result.status = QString(gsl_strerror(status)); // i18n? GSL does not support translations
+	result.iterations = iter;
 
-	//calculate:
-	//residuals r_i = y_i - Y_i = - (Y_i - y_i)
-	//sse = sum of squared errors (SSE) = residual sum of errors (RSS) = sum of sq. residuals (SSR) = \sum_i^n (Y_i-y_i)^2
-	//mse = mean squared error = 1/n \sum_i^n  (Y_i-y_i)^2
-	//rmse = root-mean squared error = \sqrt(mse)
-	//mae = mean absolute error = \sum_i^n |Y_i-y_i|
-	//rms = residual mean square = sse/d.o.f.
-	//rsd = residual standard deviation = sqrt(rms)
-	//Coefficient of determination, R-squared = 1 - SSE/SSTOT with the total sum of squares SSTOT = \sum_i (y_i - ybar)^2 and ybar = 1/n \sum_i y_i
-	//Adjusted Coefficient of determination  adj. R-squared = 1 - (1-R-squared^2)*(n-1)/(n-np-1);
-	// see also http://www.originlab.com/doc/Origin-Help/NLFit-Algorithm
+	//parameter values, scaled if they are bounded
+	result.paramValues.resize(np);
+	for (unsigned int i = 0; i < np; i++)
+		result.paramValues[i] = nsl_fit_map_bound(gsl_vector_get(s->x, i), x_min[i], x_max[i]);
 
+	//residuals r_i = y_i - Y_i = - (Y_i - y_i)
+	for (size_t i = 0; i < n; i++)
+		residuals[i] = - gsl_vector_get(s->f, i);
 
-	//gsl_blas_dnrm2() - computes the Euclidian norm (||x||_2 = \sqrt {\sum x_i^2}) of the vector with the elements (Yi - y[i])/sigma[i]
-	//gsl_blas_dasum() - computes the absolute sum \sum |x_i| of the elements of the vector with the elements (Yi - y[i])/sigma[i]
-	fitResult.sse = gsl_pow_2(gsl_blas_dnrm2(s->f));
-	fitResult.mse = fitResult.sse/n;
-	fitResult.rmse = sqrt(fitResult.mse);
-	fitResult.mae = gsl_blas_dasum(s->f);
-	if (fitResult.dof != 0) {
-		fitResult.rms = fitResult.sse/fitResult.dof;
-		fitResult.rsd = sqrt(fitResult.rms);
+	//free resources
+	gsl_multifit_fdfsolver_free(s);
+	for (int k = 0; k < chunks; k++) {
+		program_free(evaluators[k].program);
+		parser_context_free(evaluators[k].context);
 	}
+}
 
-	//coefficient of determination, R-squared
-	double ybar = 0; //mean value of the y-data
-	for (size_t i = 0; i < n; ++i)
-		ybar += ydata[i];
-	ybar = ybar/n;
-	double sstot = 0;
-	for (size_t i = 0; i < n; ++i)
-		sstot += gsl_pow_2(ydata[i]-ybar);
-	fitResult.rsquared = 1. - fitResult.sse/sstot;
-	fitResult.rsquaredAdj = 1. - (1. - fitResult.rsquared*fitResult.rsquared)*(n-1.)/(n-np-1.);
-
-	//parameter values
-	const double c = GSL_MIN_DBL(1., sqrt(fitResult.sse)); //limit error for poor fit
-	fitResult.paramValues.resize(np);
-	fitResult.errorValues.resize(np);
-	for (unsigned int i = 0; i < np; i++) {
-		// scale resulting values if they are bounded
-		fitResult.paramValues[i] = nsl_fit_map_bound(gsl_vector_get(s->x, i), x_min[i], x_max[i]);
-		// use results as start values if desired
-		if (fitData.useResults) {
-			fitData.paramStartValues.data()[i] = fitResult.paramValues[i];
-			DEBUG("saving parameter"<<i<<fitResult.paramValues[i]<<fitData.paramStartValues.data()[i]);
-		}
-		fitResult.errorValues[i] = c*sqrt(gsl_matrix_get(covar, i, i));
+/* refits the model to resampled data for the bootstrap samples first, first + step, ...
+   The compiled model, the data buffers, the solver and the random number generator are allocated once
+   and reused for all samples of the task. */
+class BootstrapTask : public QRunnable {
+public:
+	BootstrapTask(const XYFitCurve::FitData& fitData, const QVector<double>& xdata, const QVector<double>& ydata, const QVector<double>& sigma,
+			const QVector<double>& startValues, int first, int step, double* values, QSemaphore* done) :
+		m_fitData(fitData), m_xdata(xdata), m_ydata(ydata), m_sigma(sigma), m_startValues(startValues),
+		m_first(first), m_step(step), m_values(values), m_done(done) {
 	}
 
-	// fill residuals vector. To get residuals on the correct x values, fill the rest with zeros.
-	residualsVector->resize(xDataColumn->rowCount());
-	if (fitData.evaluateFullRange) {	// evaluate full range of residuals
-		xVector->resize(xDataColumn->rowCount());
-		for (int i = 0; i < xDataColumn->rowCount(); i++)
-			(*xVector)[i] = xDataColumn->valueAt(i);
-		ExpressionParser* parser = ExpressionParser::getInstance();
-		bool rc = parser->evaluateCartesian(fitData.model, xVector, residualsVector,
-							fitData.paramNames, fitResult.paramValues);
-		for (int i = 0; i < xDataColumn->rowCount(); i++)
-			(*residualsVector)[i] = yDataColumn->valueAt(i) - (*residualsVector)[i];
-		if (!rc)
-			residualsVector->clear();
-	} else {	// only selected range
-		size_t j = 0;
-		for (int i = 0; i < xDataColumn->rowCount(); i++) {
-			if (xDataColumn->valueAt(i) >= xmin && xDataColumn->valueAt(i) <= xmax)
-				residualsVector->data()[i] = - gsl_vector_get(s->f, j++);
-			else	// outside range
-				residualsVector->data()[i] = 0;
-		}
-	}
-	residualsColumn->setChanged();
+	void run() {
+		const size_t n = m_xdata.size();
+		const unsigned int np = m_fitData.paramNames.size();
+		QVector<double> x(n), y(n), sigma(m_sigma.size());
+
+		fitEvaluator evaluator;
+		evaluator.context = parser_context_new();
+		evaluator.paramSymbols.resize(np);
+		for (unsigned int i = 0; i < np; i++)
+			evaluator.paramSymbols[i] = parser_context_assign_variable(evaluator.context, m_fitData.paramNames.at(i).toLocal8Bit().data(), 0);
+		evaluator.xSymbol = parser_context_assign_variable(evaluator.context, "x", 0);
+		evaluator.program = parser_context_compile(evaluator.context, m_fitData.model.toLocal8Bit().data());
+
+		QStringList paramNames = m_fitData.paramNames;
+		QVector<double> x_min = m_fitData.paramLowerLimits;
+		QVector<double> x_max = m_fitData.paramUpperLimits;
+		QVector<bool> fixed = m_fitData.paramFixed;
+		struct data params = {n, x.data(), y.data(), sigma.isEmpty() ? 0 : sigma.data(), m_fitData.modelCategory, m_fitData.modelType, m_fitData.degree,
+					&evaluator, 1, &paramNames, x_min.data(), x_max.data(), fixed.data()};
+		gsl_multifit_function_fdf f;
+		f.f = &func_f;
+		f.df = &func_df;
+		f.fdf = &func_fdf;
+		f.n = n;
+		f.p = np;
+		f.params = &params;
+
+		// the solver needs at least as many data points as parameters, the skipped samples keep NaN as result
+		gsl_multifit_fdfsolver* s = (n >= np) ? gsl_multifit_fdfsolver_alloc(gsl_multifit_fdfsolver_lmsder, n, np) : 0;
+		gsl_rng* rng = gsl_rng_alloc(gsl_rng_mt19937);
+		QVector<double> x_init(np);
+
+		const int samples = m_fitData.bootstrapSamples;
+		for (int sample = m_first; sample < samples && evaluator.program && s; sample += m_step) {
+			// every sample has its own reproducible random stream, independent of the number of threads
+			gsl_rng_set(rng, sample + 1);
+			for (size_t i = 0; i < n; i++) {
+				const size_t j = gsl_rng_uniform_int(rng, n);
+				x[i] = m_xdata.at(j);
+				y[i] = m_ydata.at(j);
+				if (!sigma.isEmpty())
+					sigma[i] = m_sigma.at(j);
+			}
 
-	//free resources
-	gsl_multifit_fdfsolver_free(s);
-	gsl_matrix_free(covar);
+			// warm start from the result of the fit to the original data
+			for (unsigned int i = 0; i < np; i++)
+				x_init[i] = nsl_fit_map_unbound(m_startValues.at(i), x_min[i], x_max[i]);
+			gsl_vector_view v = gsl_vector_view_array(x_init.data(), np);
+			gsl_multifit_fdfsolver_set(s, &f, &v.vector);
+
+			int status;
+			int iter = 0;
+			do {
+				iter++;
+				status = gsl_multifit_fdfsolver_iterate(s);
+				if (status) break;
+				status = gsl_multifit_test_delta(s->dx, s->x, m_fitData.eps, m_fitData.eps);
+			} while (status == GSL_CONTINUE && iter < m_fitData.maxIterations);
+
+			// like for the fit to the original data, the last state is used if the solver stopped without convergence
+			for (unsigned int i = 0; i < np; i++) {
+				const double value = nsl_fit_map_bound(gsl_vector_get(s->x, i), x_min[i], x_max[i]);
+				m_values[sample*np + i] = gsl_finite(value) ? value : NAN;
+			}
+		}
 
-	//calculate the fit function (vectors)
-	ExpressionParser* parser = ExpressionParser::getInstance();
-	if (fitData.evaluateFullRange) { // evaluate fit on full data range if selected
-		xmin = xDataColumn->minimum();
-		xmax = xDataColumn->maximum();
-	}
-	xVector->resize(fitData.evaluatedPoints);
-	yVector->resize(fitData.evaluatedPoints);
-	bool rc = parser->evaluateCartesian(fitData.model, QString::number(xmin), QString::number(xmax), fitData.evaluatedPoints, xVector, yVector,
-						fitData.paramNames, fitResult.paramValues);
-	if (!rc) {
-		xVector->clear();
-		yVector->clear();
+		gsl_rng_free(rng);
+		if (s)
+			gsl_multifit_fdfsolver_free(s);
+		program_free(evaluator.program);
+		parser_context_free(evaluator.context);
+		m_done->release();
 	}
 
-	fitResult.elapsedTime = timer.elapsed();
+private:
+	const XYFitCurve::FitData& m_fitData;
+	const QVector<double>& m_xdata;
+	const QVector<double>& m_ydata;
+	const QVector<double>& m_sigma;
+	const QVector<double>& m_startValues;
+	const int m_first;
+	const int m_step;
+	double* m_values;
+	QSemaphore* m_done;
+};
 
-	//redraw the curve
-	emit (q->dataChanged());
-	sourceDataChangedSinceLastFit = false;
+/*!
+ * estimates 95 % confidence intervals of the parameters with the bootstrap method: the model is fitted
+ * to \c fitData.bootstrapSamples data sets drawn with replacement from the data points and the 2.5 % and 97.5 %
+ * percentiles of the resulting parameter values are stored in \c result.
+ * If \c parallel is \c true, the refits are distributed over the threads of the global thread pool.
+ */
+void XYFitCurvePrivate::bootstrap(const XYFitCurve::FitData& fitData, const QVector<double>& xdata, const QVector<double>& ydata,
+		const QVector<double>& sigma, bool parallel, XYFitCurve::FitResult& result) {
+	const int samples = fitData.bootstrapSamples;
+	const int np = fitData.paramNames.size();
+	// samples that are not refitted, e.g. if the model can't be compiled, are ignored as NaN
+	QVector<double> values(samples*np, NAN);
+
+	QSemaphore done;
+	const int tasks = parallel ? qBound(1, samples, QThreadPool::globalInstance()->maxThreadCount()) : 1;
+	for (int k = 1; k < tasks; k++)
+		QThreadPool::globalInstance()->start(new BootstrapTask(fitData, xdata, ydata, sigma, result.paramValues, k, tasks, values.data(), &done));
+	BootstrapTask(fitData, xdata, ydata, sigma, result.paramValues, 0, tasks, values.data(), &done).run();
+	done.acquire(tasks);
+
+	// percentiles of the parameter values of all refits with a finite result
+	result.lowerConfidenceValues.resize(np);
+	result.upperConfidenceValues.resize(np);
+	QVector<double> paramValues;
+	paramValues.reserve(samples);
+	for (int i = 0; i < np; i++) {
+		paramValues.clear();
+		for (int sample = 0; sample < samples; sample++)
+			if (!std::isnan(values.at(sample*np + i)))
+				paramValues << values.at(sample*np + i);
+
+		if (paramValues.isEmpty()) {
+			result.lowerConfidenceValues[i] = NAN;
+			result.upperConfidenceValues[i] = NAN;
+			continue;
+		}
+		std::sort(paramValues.begin(), paramValues.end());
+		result.lowerConfidenceValues[i] = gsl_stats_quantile_from_sorted_data(paramValues.constData(), 1, paramValues.size(), 0.025);
+		result.upperConfidenceValues[i] = gsl_stats_quantile_from_sorted_data(paramValues.constData(), 1, paramValues.size(), 0.975);
+	}
 }
 
 /*!
  * writes out the current state of the solver \c s
  */
-void XYFitCurvePrivate::writeSolverState(gsl_multifit_fdfsolver* s) {
+void XYFitCurvePrivate::writeSolverState(gsl_multifit_fdfsolver* s, const XYFitCurve::FitData& fitData, XYFitCurve::FitResult& result) {
 	QString state;
 
 	//current parameter values, semicolon separated
-	double* min = fitData.paramLowerLimits.data();
-	double* max = fitData.paramUpperLimits.data();
+	const double* min = fitData.paramLowerLimits.data();
+	const double* max = fitData.paramUpperLimits.data();
 	for (int i = 0; i < fitData.paramNames.size(); ++i) {
 		double x = gsl_vector_get(s->x, i);
 		// map parameter if bounded
@@ -1111,9 +1653,122 @@ void XYFitCurvePrivate::writeSolverState(gsl_multifit_fdfsolver* s) {
 	state += QString::number(gsl_pow_2(gsl_blas_dnrm2(s->f)));
 	state += ';';
 
-	fitResult.solverOutput += state;
+	result.solverOutput += state;
 }
 
+/* fits the model to the data of one set of columns of a batch fit */
+class BatchFitTask : public QRunnable {
+public:
+	BatchFitTask(const XYFitCurve::FitData& fitData, const XYFitCurve::BatchFitColumns& columns, XYFitCurve::FitResult* result, QSemaphore* done) :
+		m_fitData(fitData), m_columns(columns), m_result(result), m_done(done) {
+	}
+
+	void run() {
+		QElapsedTimer timer;
+		timer.start();
+
+		QVector<double> xdata;
+		QVector<double> ydata;
+		QVector<double> sigma;
+		if (m_columns.xDataColumn && m_columns.yDataColumn
+			&& XYFitCurvePrivate::prepareData(m_fitData, m_columns.xDataColumn, m_columns.yDataColumn, m_columns.weightsColumn, xdata, ydata, sigma, *m_result)) {
+			// the fits already run in parallel, don't split the data of one fit
+			QVector<double> residuals;
+			XYFitCurvePrivate::fit(m_fitData, xdata, ydata, sigma, false, *m_result, residuals);
+		}
+
+		m_result->elapsedTime = timer.elapsed();
+		m_done->release();
+	}
+
+private:
+	const XYFitCurve::FitData& m_fitData;
+	const XYFitCurve::BatchFitColumns m_columns;
+	XYFitCurve::FitResult* m_result;
+	QSemaphore* m_done;
+};
+
+/*!
+	fits the model defined in \c fitData independently to the data of all sets of \c columns.
+	The fits run concurrently on the global thread pool. If \c spreadsheet is given,
+	the names of the data columns, the parameters with their errors, chi^2 and the status of the fits
+	are written to it, one row per set of columns, in one undo step.
+	Has to be called in the GUI thread, the calling thread waits for the fits in the pool
+	and would block a thread of the pool otherwise.
+ */
+QVector<XYFitCurve::FitResult> XYFitCurve::batchFit(const FitData& fitData, const QVector<BatchFitColumns>& columns, Spreadsheet* spreadsheet) {
+	Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+	const int count = columns.size();
+	QVector<FitResult> results(count);
+
+	QSemaphore done;
+	QThreadPool* pool = QThreadPool::globalInstance();
+	for (int i = 0; i < count; i++)
+		pool->start(new BatchFitTask(fitData, columns.at(i), &results[i], &done));
+	done.acquire(count);
+
+	if (!spreadsheet)
+		return results;
+
+	//columns: x-data, y-data, parameters and their errors, chi^2, status
+	const int np = fitData.paramNames.size();
+	spreadsheet->beginMacro(i18n("%1: batch fit", spreadsheet->name()));
+	spreadsheet->setColumnCount(2*np + 4);
+	spreadsheet->setRowCount(count);
+
+	QStringList xNames, yNames, status;
+	for (int i = 0; i < count; i++) {
+		xNames << (columns.at(i).xDataColumn ? columns.at(i).xDataColumn->name() : QString());
+		yNames << (columns.at(i).yDataColumn ? columns.at(i).yDataColumn->name() : QString());
+		status << results.at(i).status;
+	}
+	Column* column = spreadsheet->column(0);
+	column->setName(i18n("x-data"));
+	column->setColumnMode(AbstractColumn::Text);
+	column->replaceTexts(0, xNames);
+	column = spreadsheet->column(1);
+	column->setName(i18n("y-data"));
+	column->setColumnMode(AbstractColumn::Text);
+	column->replaceTexts(0, yNames);
+
+	for (int j = 0; j < np; j++) {
+		QVector<double> values(count, NAN), errors(count, NAN);
+		for (int i = 0; i < count; i++) {
+			if (results.at(i).valid) {
+				values[i] = results.at(i).paramValues.at(j);
+				errors[i] = results.at(i).errorValues.at(j);
+			}
+		}
+		column = spreadsheet->column(2 + 2*j);
+		column->setName(fitData.paramNames.at(j));
+		column->setColumnMode(AbstractColumn::Numeric);
+		column->setPlotDesignation(AbstractColumn::Y);
+		column->replaceValues(0, values);
+		column = spreadsheet->column(3 + 2*j);
+		column->setName(i18n("%1 error", fitData.paramNames.at(j)));
+		column->setColumnMode(AbstractColumn::Numeric);
+		column->setPlotDesignation(AbstractColumn::yErr);
+		column->replaceValues(0, errors);
+	}
+
+	QVector<double> chi2(count, NAN);
+	for (int i = 0; i < count; i++) {
+		if (results.at(i).valid)
+			chi2[i] = results.at(i).sse;
+	}
+	column = spreadsheet->column(2*np + 2);
+	column->setName(i18n("chi^2"));
+	column->setColumnMode(AbstractColumn::Numeric);
+	column->setPlotDesignation(AbstractColumn::Y);
+	column->replaceValues(0, chi2);
+	column = spreadsheet->column(2*np + 3);
+	column->setName(i18n("status"));
+	column->setColumnMode(AbstractColumn::Text);
+	column->replaceTexts(0, status);
+	spreadsheet->endMacro();
+
+	return results;
+}
 
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
@@ -1147,6 +1802,8 @@ void XYFitCurve::save(QXmlStreamWriter* writer) const {
 	writer->writeAttribute( "evaluatedPoints", QString::number(d->fitData.evaluatedPoints) );
 	writer->writeAttribute( "evaluateFullRange", QString::number(d->fitData.evaluateFullRange) );
 	writer->writeAttribute( "useResults", QString::number(d->fitData.useResults) );
+	writer->writeAttribute( "warmStart", QString::number(d->fitData.warmStart) );
+	writer->writeAttribute( "bootstrapSamples", QString::number(d->fitData.bootstrapSamples) );
 
 	writer->writeStartElement("paramNames");
 	foreach (const QString &name, d->fitData.paramNames)
@@ -1217,6 +1874,16 @@ void XYFitCurve::save(QXmlStreamWriter* writer) const {
 		writer->writeTextElement("error", QString::number(value, 'g', 15));
 	writer->writeEndElement();
 
+	writer->writeStartElement("lowerConfidenceValues");
+	foreach (const double value, d->fitResult.lowerConfidenceValues)
+		writer->writeTextElement("lower", QString::number(value, 'g', 15));
+	writer->writeEndElement();
+
+	writer->writeStartElement("upperConfidenceValues");
+	foreach (const double value, d->fitResult.upperConfidenceValues)
+		writer->writeTextElement("upper", QString::number(value, 'g', 15));
+	writer->writeEndElement();
+
 	//save calculated columns if available
 	if (d->xColumn && d->yColumn && d->residualsColumn) {
 		d->xColumn->save(writer);
@@ -1273,6 +1940,8 @@ bool XYFitCurve::load(XmlStreamReader* reader) {
 			READ_INT_VALUE("evaluatedPoints", fitData.evaluatedPoints, size_t);
 			READ_INT_VALUE("evaluateFullRange", fitData.evaluateFullRange, bool);
 			READ_INT_VALUE("useResults", fitData.useResults, bool);
+			READ_INT_VALUE("warmStart", fitData.warmStart, bool);
+			READ_INT_VALUE("bootstrapSamples", fitData.bootstrapSamples, int);
 		} else if (reader->name() == "name") {
 			d->fitData.paramNames<<reader->readElementText();
 		} else if (reader->name() == "nameUtf8") {
@@ -1299,6 +1968,10 @@ bool XYFitCurve::load(XmlStreamReader* reader) {
 			d->fitResult.paramValues<<reader->readElementText().toDouble();
 		} else if (reader->name() == "error") {
 			d->fitResult.errorValues<<reader->readElementText().toDouble();
+		} else if (reader->name() == "lower") {
+			d->fitResult.lowerConfidenceValues<<reader->readElementText().toDouble();
+		} else if (reader->name() == "upper") {
+			d->fitResult.upperConfidenceValues<<reader->readElementText().toDouble();
 		} else if (reader->name() == "fitResult") {
 			attribs = reader->attributes();
 
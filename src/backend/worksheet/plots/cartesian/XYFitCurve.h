@@ -36,6 +36,7 @@ extern "C" {
 }
 
 class XYFitCurvePrivate;
+class Spreadsheet;
 class XYFitCurve : public XYCurve {
 	Q_OBJECT
 
@@ -51,6 +52,8 @@ class XYFitCurve : public XYCurve {
 						evaluatedPoints(100),
 						useResults(true),
 						evaluateFullRange(true),
+						warmStart(false),
+						bootstrapSamples(0),
 						autoRange(true), xRange(2) {};
 
 			nsl_fit_model_category modelCategory;
@@ -70,6 +73,8 @@ class XYFitCurve : public XYCurve {
 			size_t evaluatedPoints;
 			bool useResults;		// use results as new start values
 			bool evaluateFullRange;		// evaluate fit function on full data range
+			bool warmStart;			// refit when the source data changes, starting from the last results
+			int bootstrapSamples;		// number of refits to resampled data for confidence intervals (0: none)
 
 			bool autoRange;			// use all data?
 			QVector<double> xRange;		// x range for integration
@@ -95,9 +100,19 @@ class XYFitCurve : public XYCurve {
 			double rsquaredAdj; //Adjusted coefficient of determination (R^2)
 			QVector<double> paramValues;
 			QVector<double> errorValues;
+			QVector<double> lowerConfidenceValues;	// 95 % bootstrap confidence intervals
+			QVector<double> upperConfidenceValues;
 			QString solverOutput;
 		};
 
+		struct BatchFitColumns {
+			BatchFitColumns() : xDataColumn(0), yDataColumn(0), weightsColumn(0) {};
+
+			const AbstractColumn* xDataColumn;
+			const AbstractColumn* yDataColumn;
+			const AbstractColumn* weightsColumn;
+		};
+
 		explicit XYFitCurve(const QString& name);
 		virtual ~XYFitCurve();
 
@@ -117,6 +132,8 @@ class XYFitCurve : public XYCurve {
 		const FitResult& fitResult() const;
 		bool isSourceDataChangedSinceLastFit() const;
 
+		static QVector<FitResult> batchFit(const FitData&, const QVector<BatchFitColumns>&, Spreadsheet* spreadsheet = 0);
+
 		typedef WorksheetElement BaseClass;
 		typedef XYFitCurvePrivate Private;
 
@@ -129,6 +146,7 @@ class XYFitCurve : public XYCurve {
 
 	private slots:
 		void handleSourceDataChanged();
+		void refit();
 
 	signals:
 		friend class XYFitCurveSetXDataColumnCmd;
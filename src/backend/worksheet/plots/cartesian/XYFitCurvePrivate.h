@@ -39,12 +39,33 @@ extern "C" {
 #include <gsl/gsl_multifit_nlin.h>
 }
 
+/* sums of the normal equations of a linear fit, continued when data points are appended */
+struct LinearFitStatistics {
+	LinearFitStatistics() : count(0), weighted(false), checksum(0) {};
+
+	QString model;
+	QVector<bool> paramFixed;
+	QVector<double> fixedValues;	// values of the fixed parameters
+	int count;	// number of data points included in the sums
+	bool weighted;
+	quint64 checksum;	// checksum of the data points included in the sums
+	QVector<double> XtWX;	// X^T W X of the free parameters (row major)
+	QVector<double> XtWy;	// X^T W y of the free parameters
+
+	bool isContinuation(const XYFitCurve::FitData&, const QVector<double>& xdata, const QVector<double>& ydata, const QVector<double>& sigma) const;
+	static quint64 dataChecksum(const QVector<double>& xdata, const QVector<double>& ydata, const QVector<double>& sigma, int count);
+};
+
 class XYFitCurvePrivate: public XYCurvePrivate {
 	public:
 		explicit XYFitCurvePrivate(XYFitCurve*);
 		~XYFitCurvePrivate();
 
-		void recalculate();
+		void recalculate(bool warmStart = false);
+		static bool prepareData(const XYFitCurve::FitData&, const AbstractColumn* xDataColumn, const AbstractColumn* yDataColumn,
+			const AbstractColumn* weightsColumn, QVector<double>& xdata, QVector<double>& ydata, QVector<double>& sigma, XYFitCurve::FitResult&);
+		static void fit(const XYFitCurve::FitData&, QVector<double>& xdata, const QVector<double>& ydata, const QVector<double>& sigma,
+			bool parallel, XYFitCurve::FitResult&, QVector<double>& residuals, LinearFitStatistics* = 0);
 
 		const AbstractColumn* xDataColumn; //<! column storing the values for the x-data to be fitted
 		const AbstractColumn* yDataColumn; //<! column storing the values for the y-data to be fitted
@@ -65,11 +86,20 @@ class XYFitCurvePrivate: public XYCurvePrivate {
 		QVector<double>* residualsVector;
 
 		bool sourceDataChangedSinceLastFit; //<! \c true if the data in the source columns (x, y, or weights) was changed, \c false otherwise
+		bool refitPending; //<! \c true if a warm start refit is scheduled after the source data was changed
+		LinearFitStatistics linearFitStatistics; //<! sums of the last linear fit, used for warm starts
 
 		XYFitCurve* const q;
 
 	private:
-		void writeSolverState(gsl_multifit_fdfsolver* s);
+		static bool isLinearModel(const XYFitCurve::FitData&);
+		static void linearFit(const XYFitCurve::FitData&, const QVector<double>& xdata, const QVector<double>& ydata, const QVector<double>& sigma,
+			XYFitCurve::FitResult&, gsl_matrix* covar, QVector<double>& residuals, LinearFitStatistics*);
+		static void nonlinearFit(const XYFitCurve::FitData&, QVector<double>& xdata, const QVector<double>& ydata, const QVector<double>& sigma,
+			bool parallel, XYFitCurve::FitResult&, gsl_matrix* covar, QVector<double>& residuals);
+		static void bootstrap(const XYFitCurve::FitData&, const QVector<double>& xdata, const QVector<double>& ydata, const QVector<double>& sigma,
+			bool parallel, XYFitCurve::FitResult&);
+		static void writeSolverState(gsl_multifit_fdfsolver* s, const XYFitCurve::FitData&, XYFitCurve::FitResult&);
 };
 
 #endif
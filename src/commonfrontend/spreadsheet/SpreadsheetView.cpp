@@ -732,7 +732,7 @@ bool SpreadsheetView::eventFilter(QObject* watched, QEvent* event) {
 		if (watched == m_tableView->verticalHeader()) {
 			bool onlyNumeric = true;
 			for (int i = 0; i < m_spreadsheet->columnCount(); ++i) {
-				if (m_spreadsheet->column(i)->columnMode() != AbstractColumn::Numeric) {
+				if (!AbstractColumn::isNumeric(m_spreadsheet->column(i)->columnMode())) {
 					onlyNumeric = false;
 					break;
 				}
@@ -762,7 +762,7 @@ bool SpreadsheetView::eventFilter(QObject* watched, QEvent* event) {
 			//check whether we have non-numeric columns selected and deactivate actions for numeric columns
 			bool numeric = true;
 			foreach(Column* col, selectedColumns()) {
-				if (col->columnMode() != AbstractColumn::Numeric) {
+				if (!AbstractColumn::isNumeric(col->columnMode())) {
 					numeric = false;
 					break;
 				}
@@ -847,7 +847,7 @@ void SpreadsheetView::copySelection() {
 			if (isCellSelected(first_row + r, first_col + c)) {
 				if (formulaModeActive())
 					output_str += col_ptr->formula(first_row + r);
-				else if (col_ptr->columnMode() == AbstractColumn::Numeric) {
+				else if (AbstractColumn::isNumeric(col_ptr->columnMode())) {
 					Double2StringFilter * out_fltr = static_cast<Double2StringFilter *>(col_ptr->outputFilter());
 					output_str += QLocale().toString(col_ptr->valueAt(first_row + r),
 					                                 out_fltr->numericFormat(), 16); // copy with max. precision
@@ -922,9 +922,10 @@ void SpreadsheetView::pasteIntoSelection() {
 
 		rows = last_row - first_row + 1;
 		cols = last_col - first_col + 1;
+		//notify about the changes once per column and not for every pasted cell
+		m_spreadsheet->beginUpdate();
 		for (int r=0; r<rows && r<input_row_count; r++) {
 			for (int c=0; c<cols && c<input_col_count; c++) {
-				//TODO c->setSuppressDataChangedSignal(true);
 				if (isCellSelected(first_row + r, first_col + c) && (c < cellTexts.at(r).count()) ) {
 					Column * col_ptr = m_spreadsheet->column(first_col + c);
 					if (formulaModeActive())
@@ -934,6 +935,7 @@ void SpreadsheetView::pasteIntoSelection() {
 				}
 			}
 		}
+		m_spreadsheet->endUpdate();
 	}
 	m_spreadsheet->endMacro();
 	RESET_CURSOR;
@@ -988,7 +990,10 @@ void SpreadsheetView::fillSelectedCellsWithRowNumbers() {
 		int col = m_spreadsheet->indexOfChild<Column>(col_ptr);
 		col_ptr->setSuppressDataChangedSignal(true);
 		switch (col_ptr->columnMode()) {
-		case AbstractColumn::Numeric: {
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float: {
 				QVector<double> results(last-first+1);
 				for (int row=first; row <= last; row++)
 					if (isCellSelected(row, col))
@@ -1037,7 +1042,7 @@ void SpreadsheetView::fillWithRowNumbers() {
 		new_data[i] = i+1;
 
 	foreach(Column* col, selectedColumns()) {
-		if (col->columnMode() != AbstractColumn::Numeric)
+		if (!AbstractColumn::isNumeric(col->columnMode()))
 			continue;
 		col->replaceValues(0, new_data);
 	}
@@ -1060,7 +1065,10 @@ void SpreadsheetView::fillSelectedCellsWithRandomNumbers() {
 		int col = m_spreadsheet->indexOfChild<Column>(col_ptr);
 		col_ptr->setSuppressDataChangedSignal(true);
 		switch (col_ptr->columnMode()) {
-		case AbstractColumn::Numeric: {
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float: {
 				QVector<double> results(last-first+1);
 				for (int row=first; row<=last; row++)
 					if (isCellSelected(row, col))
@@ -1147,7 +1155,10 @@ void SpreadsheetView::fillSelectedCellsWithConstValues() {
 		int col = m_spreadsheet->indexOfChild<Column>(col_ptr);
 		col_ptr->setSuppressDataChangedSignal(true);
 		switch (col_ptr->columnMode()) {
-		case AbstractColumn::Numeric: {
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float: {
 				if (!doubleOk)
 					doubleValue = QInputDialog::getDouble(this, i18n("Fill the selection with constant value"),
 					                                      i18n("Value"), 0, -2147483647, 2147483647, 6, &doubleOk);
@@ -1314,11 +1325,10 @@ void SpreadsheetView::reverseColumns() {
 	m_spreadsheet->beginMacro(i18np("%1: reverse column", "%1: reverse columns",
 	                                m_spreadsheet->name(), cols.size()));
 	foreach(Column* col, cols) {
-		if (col->columnMode() != AbstractColumn::Numeric)
+		if (!AbstractColumn::isNumeric(col->columnMode()))
 			continue;
 
-		QVector<double>* data = static_cast<QVector<double>* >(col->data());
-		QVector<double> new_data(*data);
+		QVector<double> new_data(col->numericView().values());
 		std::reverse(new_data.begin(), new_data.end());
 		col->replaceValues(0, new_data);
 	}
@@ -1351,7 +1361,7 @@ void SpreadsheetView::normalizeSelectedColumns() {
 	m_spreadsheet->beginMacro(i18n("%1: normalize columns", m_spreadsheet->name()));
 	QList< Column* > cols = selectedColumns();
 	foreach(Column* col, cols)	{
-		if (col->columnMode() == AbstractColumn::Numeric) {
+		if (AbstractColumn::isNumeric(col->columnMode())) {
 			col->setSuppressDataChangedSignal(true);
 			double max = col->maximum();
 			if (max != 0.0) {// avoid division by zero
@@ -1371,20 +1381,21 @@ void SpreadsheetView::normalizeSelection() {
 	m_spreadsheet->beginMacro(i18n("%1: normalize selection", m_spreadsheet->name()));
 	double max = 0.0;
 	for (int col=firstSelectedColumn(); col<=lastSelectedColumn(); col++)
-		if (m_spreadsheet->column(col)->columnMode() == AbstractColumn::Numeric)
+		if (AbstractColumn::isNumeric(m_spreadsheet->column(col)->columnMode()))
 			for (int row=0; row<m_spreadsheet->rowCount(); row++) {
 				if (isCellSelected(row, col) && m_spreadsheet->column(col)->valueAt(row) > max)
 					max = m_spreadsheet->column(col)->valueAt(row);
 			}
 
 	if (max != 0.0) { // avoid division by zero
-		//TODO setSuppressDataChangedSignal
+		m_spreadsheet->beginUpdate();
 		for (int col=firstSelectedColumn(); col<=lastSelectedColumn(); col++)
-			if (m_spreadsheet->column(col)->columnMode() == AbstractColumn::Numeric)
+			if (AbstractColumn::isNumeric(m_spreadsheet->column(col)->columnMode()))
 				for (int row=0; row<m_spreadsheet->rowCount(); row++) {
 					if (isCellSelected(row, col))
 						m_spreadsheet->column(col)->setValueAt(row, m_spreadsheet->column(col)->valueAt(row) / max);
 				}
+		m_spreadsheet->endUpdate();
 	}
 	m_spreadsheet->endMacro();
 	RESET_CURSOR;
@@ -1410,7 +1421,7 @@ void SpreadsheetView::showColumnStatistics(bool forAll) {
 		dlg->setColumns(selectedColumns());
 	else if (forAll) {
 		for (int col = 0; col < m_spreadsheet->columnCount(); ++col) {
-			if (m_spreadsheet->column(col)->columnMode() == AbstractColumn::Numeric)
+			if (AbstractColumn::isNumeric(m_spreadsheet->column(col)->columnMode()))
 				list << m_spreadsheet->column(col);
 		}
 		dlg->setColumns(list);
@@ -1473,9 +1484,10 @@ void SpreadsheetView::removeSelectedRows() {
 
 	WAIT_CURSOR;
 	m_spreadsheet->beginMacro(i18n("%1: remove selected rows", m_spreadsheet->name()));
-	//TODO setSuppressDataChangedSignal
+	m_spreadsheet->beginUpdate();
 	foreach(const Interval<int>& i, selectedRows().intervals())
 		m_spreadsheet->removeRows(i.start(), i.size());
+	m_spreadsheet->endUpdate();
 	m_spreadsheet->endMacro();
 	RESET_CURSOR;
 }
@@ -1527,10 +1539,16 @@ void SpreadsheetView::clearSelectedCells() {
 				if (isCellSelected(row, col))
 					col_ptr->setFormula(row, "");
 		} else {
+			//Integer and BigInt columns have no empty value, the cleared cells would become 0 -> mask them instead
+			const bool mask = (col_ptr->columnMode() == AbstractColumn::Integer || col_ptr->columnMode() == AbstractColumn::BigInt);
 			int col = m_spreadsheet->indexOfChild<Column>(col_ptr);
 			for (int row=last; row>=first; row--)
 				if (isCellSelected(row, col)) {
-					if (row < col_ptr->rowCount())
+					if (row >= col_ptr->rowCount())
+						continue;
+					if (mask)
+						col_ptr->setMasked(row);
+					else
 						col_ptr->asStringColumn()->setTextAt(row, QString());
 				}
 		}
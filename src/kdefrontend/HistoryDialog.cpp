@@ -26,10 +26,13 @@
  *                                                                         *
  ***************************************************************************/
 #include "HistoryDialog.h"
+#include "backend/core/UndoStack.h"
 #include <kmessagebox.h>
 #include <klocale.h>
-#include <QUndoStack>
+#include <KGlobal>
 #include <QUndoView>
+#include <QLabel>
+#include <QVBoxLayout>
 
 /*!
 	\class HistoryDialog
@@ -43,7 +46,22 @@ HistoryDialog::HistoryDialog(QWidget* parent, QUndoStack* stack, const QString&
 	undoView->setEmptyLabel(emptyLabel);
 	undoView->setWhatsThis(i18n("List of all performed steps/actions.\n"
 	                            "Select an item in the list to navigate to the corresponding step."));
-	setMainWidget(undoView);
+
+	//show the memory used by the undo history
+	const UndoStack* undoStack = qobject_cast<const UndoStack*>(stack);
+	if (undoStack) {
+		QWidget* widget = new QWidget(this);
+		QVBoxLayout* layout = new QVBoxLayout(widget);
+		layout->setContentsMargins(0, 0, 0, 0);
+		layout->addWidget(undoView);
+		const KLocale* locale = KGlobal::locale();
+		QLabel* label = new QLabel(i18n("Memory used: %1, on disk: %2",
+		                                locale->formatByteSize(undoStack->memorySize()),
+		                                locale->formatByteSize(undoStack->spilledSize())), widget);
+		layout->addWidget(label);
+		setMainWidget(widget);
+	} else
+		setMainWidget(undoView);
 
 	setWindowIcon( KIcon("view-history") );
 	setWindowTitle(i18n("Undo/Redo History"));
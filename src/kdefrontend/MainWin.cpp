@@ -1475,6 +1475,10 @@ void MainWin::handleSettingsChanges() {
 	interval *= 60*1000;
 	if (interval != m_autoSaveTimer.interval())
 		m_autoSaveTimer.setInterval(interval);
+
+	//memory budget of the undo history
+	if (m_project)
+		m_project->undoStack()->setMemoryBudget(group.readEntry("UndoMemoryBudget", 1024)*Q_INT64_C(1024*1024));
 }
 
 /***************************************************************************************/
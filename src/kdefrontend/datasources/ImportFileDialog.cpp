@@ -177,6 +177,7 @@ void ImportFileDialog::importToFileDataSource(FileDataSource* source, QStatusBar
 	QProgressBar* progressBar = new QProgressBar();
 	progressBar->setRange(0, 100);
 	connect(source->filter(), SIGNAL(completed(int)), progressBar, SLOT(setValue(int)));
+	connect(source->filter(), SIGNAL(truncated(qint64,qint64)), this, SLOT(importTruncated(qint64,qint64)));
 
 	statusBar->clearMessage();
 	statusBar->addWidget(progressBar, 1);
@@ -211,6 +212,7 @@ void ImportFileDialog::importTo(QStatusBar* statusBar) const {
 	progressBar->setMinimum(0);
 	progressBar->setMaximum(100);
 	connect(filter, SIGNAL(completed(int)), progressBar, SLOT(setValue(int)));
+	connect(filter, SIGNAL(truncated(qint64,qint64)), this, SLOT(importTruncated(qint64,qint64)));
 
 	statusBar->clearMessage();
 	statusBar->addWidget(progressBar, 1);
@@ -295,6 +297,16 @@ void ImportFileDialog::importTo(QStatusBar* statusBar) const {
 	delete filter;
 }
 
+/*!
+  informs the user that the file has more rows than a column can hold and that only the first \c importedRows rows are imported
+*/
+void ImportFileDialog::importTruncated(qint64 rows, qint64 importedRows) {
+	RESET_CURSOR;
+	KMessageBox::information(parentWidget(), i18n("The file contains %1 rows, only the first %2 rows are imported.", rows, importedRows),
+	                         i18n("Import truncated"));
+	WAIT_CURSOR;
+}
+
 void ImportFileDialog::toggleOptions() {
 	importFileWidget->showOptions(!m_showOptions);
 	m_showOptions = !m_showOptions;
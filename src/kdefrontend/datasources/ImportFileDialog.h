@@ -76,6 +76,7 @@ private:
 
 private slots:
 	void toggleOptions();
+	void importTruncated(qint64 rows, qint64 importedRows);
 	void newDataContainerMenu();
 	void newDataContainer(QAction*);
 	void checkOkButton();
@@ -672,6 +672,9 @@ void XYCurveDock::updateValuesFormatWidgets(const AbstractColumn::ColumnMode col
 
 	switch (columnMode) {
 	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float:
 		ui.cbValuesFormat->addItem(i18n("Decimal"), QVariant('f'));
 		ui.cbValuesFormat->addItem(i18n("Scientific (e)"), QVariant('e'));
 		ui.cbValuesFormat->addItem(i18n("Scientific (E)"), QVariant('E'));
@@ -710,7 +713,7 @@ void XYCurveDock::updateValuesFormatWidgets(const AbstractColumn::ColumnMode col
 
 	ui.cbValuesFormat->setCurrentIndex(0);
 
-	if (columnMode == AbstractColumn::Numeric) {
+	if (AbstractColumn::isNumeric(columnMode)) {
 		ui.lValuesPrecision->show();
 		ui.sbValuesPrecision->show();
 	} else {
@@ -753,7 +756,10 @@ void XYCurveDock::showValuesColumnFormat(const Column* column) {
 
 		//show the actuall formating properties
 		switch (columnMode) {
-		case AbstractColumn::Numeric: {
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float: {
 				Double2StringFilter * filter = static_cast<Double2StringFilter*>(column->outputFilter());
 				ui.cbValuesFormat->setCurrentIndex(ui.cbValuesFormat->findData(filter->numericFormat()));
 				ui.sbValuesPrecision->setValue(filter->numDigits());
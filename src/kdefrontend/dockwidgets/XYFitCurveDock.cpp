@@ -30,6 +30,8 @@
 #include "XYFitCurveDock.h"
 #include "backend/core/AspectTreeModel.h"
 #include "backend/core/Project.h"
+#include "backend/core/column/Column.h"
+#include "backend/spreadsheet/Spreadsheet.h"
 #include "commonfrontend/widgets/TreeViewComboBox.h"
 #include "kdefrontend/widgets/ConstantsWidget.h"
 #include "kdefrontend/widgets/FunctionsWidget.h"
@@ -128,6 +130,7 @@ void XYFitCurveDock::setupGeneral() {
 	connect( uiGeneralTab.pbParameters, SIGNAL(clicked()), this, SLOT(showParameters()) );
 	connect( uiGeneralTab.pbOptions, SIGNAL(clicked()), this, SLOT(showOptions()) );
 	connect( uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()) );
+	connect( uiGeneralTab.pbBatchFit, SIGNAL(clicked()), this, SLOT(batchFitClicked()) );
 }
 
 void XYFitCurveDock::initGeneralTab() {
@@ -950,6 +953,43 @@ void XYFitCurveDock::recalculateClicked() {
 	QApplication::restoreOverrideCursor();
 }
 
+/*!
+ * fits the current model to all numeric y-columns of the spreadsheet containing the y-data column of the curve,
+ * the x-data and weights columns of the curve are used for all fits. The results are written to a new spreadsheet.
+ */
+void XYFitCurveDock::batchFitClicked() {
+	const Column* yColumn = dynamic_cast<const Column*>(m_fitCurve->yDataColumn());
+	Spreadsheet* source = yColumn ? dynamic_cast<Spreadsheet*>(yColumn->parentAspect()) : 0;
+	if (!source || !m_fitCurve->xDataColumn())
+		return;
+
+	m_fitData.degree = uiGeneralTab.sbDegree->value();
+	if (m_fitData.modelCategory == nsl_fit_model_custom)
+		m_fitData.model = uiGeneralTab.teEquation->toPlainText();
+
+	QVector<XYFitCurve::BatchFitColumns> columns;
+	foreach (const Column* column, source->children<Column>()) {
+		if (column == m_fitCurve->xDataColumn() || column->plotDesignation() != AbstractColumn::Y
+			|| !AbstractColumn::isNumeric(column->columnMode()))
+			continue;
+
+		XYFitCurve::BatchFitColumns fitColumns;
+		fitColumns.xDataColumn = m_fitCurve->xDataColumn();
+		fitColumns.yDataColumn = column;
+		fitColumns.weightsColumn = m_fitCurve->weightsColumn();
+		columns << fitColumns;
+	}
+
+	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+	AbstractAspect* parent = source->parentAspect();
+	parent->beginMacro(i18n("%1: batch fit", source->name()));
+	Spreadsheet* spreadsheet = new Spreadsheet(0, i18n("Batch fit of %1", source->name()));
+	parent->addChild(spreadsheet);
+	XYFitCurve::batchFit(m_fitData, columns, spreadsheet);
+	parent->endMacro();
+	QApplication::restoreOverrideCursor();
+}
+
 void XYFitCurveDock::enableRecalculate() const {
 	if (m_initializing)
 		return;
@@ -1002,6 +1042,15 @@ void XYFitCurveDock::showFitResult() {
 				+ " (" + QString::number(100.*fitResult.errorValues.at(i)/fabs(fitResult.paramValues.at(i))) + " %)";
 	}
 
+	if (fitResult.lowerConfidenceValues.size() == fitResult.paramValues.size()) {
+		str += "<br><br><b>" + i18n("95 % confidence intervals (bootstrap):") + "</b>";
+		for (int i = 0; i < fitResult.paramValues.size(); i++) {
+			if (!fitData.paramFixed.at(i))
+				str += "<br>" + fitData.paramNamesUtf8.at(i) + QString(": [") + QString::number(fitResult.lowerConfidenceValues.at(i))
+					+ ", " + QString::number(fitResult.upperConfidenceValues.at(i)) + ']';
+		}
+	}
+
 	str += "<br><br><b>" + i18n("Goodness of fit:") + "</b><br>";
 	str += i18n("sum of squared errors") + " (" + QString::fromUtf8("\u03c7") + QString::fromUtf8("\u00b2") + "): " + QString::number(fitResult.sse) + "<br>";
 	str += i18n("mean squared error:") + ' ' + QString::number(fitResult.mse) + "<br>";
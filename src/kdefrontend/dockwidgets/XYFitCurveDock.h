@@ -82,6 +82,7 @@ private slots:
 	void insertFunction(const QString&);
 	void insertConstant(const QString&);
 	void recalculateClicked();
+	void batchFitClicked();
 	void updateModelEquation();
 	void enableRecalculate() const;
 
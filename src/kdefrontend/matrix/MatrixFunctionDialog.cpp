@@ -135,11 +135,11 @@ void MatrixFunctionDialog::insertConstant(const QString& str) {
 	ui.teEquation->insertPlainText(str);
 }
 
-/* task class for parallel fill (not used) */
+/* task class for parallel fill: every task uses an own parser context */
 class GenerateValueTask : public QRunnable {
 public:
 	GenerateValueTask(int startCol, int endCol, QVector<QVector<double>>& matrixData, double xStart, double yStart,
-		double xStep, double yStep, char* func): m_startCol(startCol), m_endCol(endCol), m_matrixData(matrixData),
+		double xStep, double yStep, const char* func): m_startCol(startCol), m_endCol(endCol), m_matrixData(matrixData),
 		m_xStart(xStart), m_yStart(yStart), m_xStep(xStep), m_yStep(yStep), m_func(func) {
 	};
 
@@ -150,20 +150,26 @@ public:
 #ifndef NDEBUG
 		qDebug()<<"FILL col"<<m_startCol<<"-"<<m_endCol<<" x/y ="<<x<<'/'<<y<<" steps ="<<m_xStep<<'/'<<m_yStep<<" rows ="<<rows;
 #endif
-		parser_var vars[] = { {"x", x}, {"y", y}};
-		for (int col = m_startCol; col < m_endCol; ++col) {
-			vars[0].value = x;
-			for (int row = 0; row < rows; row++) {
-				vars[1].value = y;
-				double z = parse_with_vars(m_func, vars, 2);
-				//qDebug()<<" z ="<<z;
-				m_matrixData[col][row] = z;
-				y += m_yStep;
+		parser_context* context = parser_context_new();
+		symrec* xSymbol = parser_context_assign_variable(context, "x", x);
+		symrec* ySymbol = parser_context_assign_variable(context, "y", y);
+		parser_program* prog = parser_context_compile(context, m_func);
+		if (prog) {
+			for (int col = m_startCol; col < m_endCol; ++col) {
+				xSymbol->value.var = x;
+				double* data = m_matrixData[col].data();
+				for (int row = 0; row < rows; row++) {
+					ySymbol->value.var = y;
+					data[row] = program_eval(prog);
+					y += m_yStep;
+				}
+
+				y = m_yStart;
+				x += m_xStep;
 			}
-
-			y = m_yStart;
-			x += m_xStep;
+			program_free(prog);
 		}
+		parser_context_free(context);
 	}
 
 private:
@@ -174,7 +180,7 @@ private:
 	double m_yStart;
 	double m_xStep;
 	double m_yStep;
-	char* m_func;
+	const char* m_func;
 };
 
 void MatrixFunctionDialog::generate() {
@@ -203,10 +209,12 @@ void MatrixFunctionDialog::generate() {
 	timer.start();
 #endif
 
-	//TODO: too slow because every parser thread needs an own symbol_table
-	// idea: use pool->maxThreadCount() symbol tables and reuse them?
-/*	double yStart = m_matrix->yStart();
+	//detach the matrix data before filling it in parallel
 	const int cols = m_matrix->columnCount();
+	for (int col = 0; col < cols; ++col)
+		new_data[col].data();
+
+	const double yStart = m_matrix->yStart();
 	QThreadPool* pool = QThreadPool::globalInstance();
 	int range = ceil(double(cols)/pool->maxThreadCount());
 #ifndef NDEBUG
@@ -214,28 +222,15 @@ void MatrixFunctionDialog::generate() {
 #endif
 	for (int i = 0; i < pool->maxThreadCount(); ++i) {
 		const int start = i*range;
+		if (start >= cols)
+			break;
 		int end = (i+1)*range;
 		if (end > cols) end = cols;
-		qDebug() << "start/end: " << start << end;
 		const double xStart = m_matrix->xStart() + xStep*start;
 		GenerateValueTask* task = new GenerateValueTask(start, end, new_data, xStart, yStart, xStep, yStep, func);
-		task->setAutoDelete(false);
 		pool->start(task);
 	}
 	pool->waitForDone();
-*/
-	double x = 0, y = 0;
-	parser_var vars[] = {{"x", x}, {"y", y}};
-	for (int col = 0; col < m_matrix->columnCount(); col++) {
-		vars[0].value = x;
-		for (int row = 0; row < m_matrix->rowCount(); row++) {
-			vars[1].value = y;
-			new_data[col][row] = parse_with_vars(func, vars, 2);
-			y += yStep;
-		}
-		y = m_matrix->yStart();
-		x += xStep;
-	}
 
 	// Timing
 #ifndef NDEBUG
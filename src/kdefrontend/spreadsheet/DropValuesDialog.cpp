@@ -30,6 +30,8 @@
 #include "backend/lib/macros.h"
 #include "backend/spreadsheet/Spreadsheet.h"
 
+#include <QBitArray>
+#include <QSemaphore>
 #include <QThreadPool>
 
 #include <cmath>
@@ -98,197 +100,115 @@ void DropValuesDialog::okClicked() const {
 		dropValues();
 }
 
-//TODO: m_column->setMasked() is slow, we need direct access to the masked-container -> redesign
-class MaskValuesTask : public QRunnable {
+/*!
+	determines the rows of the column whose values fulfill the condition specified in the dialog.
+	Only the data is read here, the modification of the column (masking or dropping, both undo aware)
+	is done afterwards in the main thread.
+*/
+class MatchValuesTask : public QRunnable {
 	public:
-		MaskValuesTask(Column* col, int op, double value1, double value2){
+		MatchValuesTask(const Column* col, int op, double value1, double value2, QBitArray* rows, QSemaphore* done) {
 			m_column = col;
 			m_operator = op;
 			m_value1 = value1;
 			m_value2 = value2;
+			m_rows = rows;
+			m_done = done;
 		};
 
 		void run() {
-			m_column->setSuppressDataChangedSignal(true);
-			bool changed = false;
-			QVector<double>* data = static_cast<QVector<double>* >(m_column->data());
+			const AbstractColumn::NumericView view = m_column->numericView();
+			const double* data = view.data();
+			const int size = view.size();
+			QBitArray& rows = *m_rows;
+			rows.resize(size);
 
 			//equal to
 			if (m_operator == 0) {
-				for (int i=0; i<data->size(); ++i) {
-					if (data->at(i) == m_value1) {
-						m_column->setMasked(i, true);
-						changed = true;
-					}
+				for (int i=0; i<size; ++i) {
+					if (data[i] == m_value1)
+						rows.setBit(i);
 				}
 			}
 
 			//between (including end points)
 			else if (m_operator == 1) {
-				for (int i=0; i<data->size(); ++i) {
-					if (data->at(i) >= m_value1 && data->at(i) <= m_value2) {
-						m_column->setMasked(i, true);
-						changed = true;
-					}
+				for (int i=0; i<size; ++i) {
+					if (data[i] >= m_value1 && data[i] <= m_value2)
+						rows.setBit(i);
 				}
 			}
 
 			//between (excluding end points)
 			else if (m_operator == 2) {
-				for (int i=0; i<data->size(); ++i) {
-					if (data->at(i) > m_value1 && data->at(i) < m_value2) {
-						m_column->setMasked(i, true);
-						changed = true;
-					}
+				for (int i=0; i<size; ++i) {
+					if (data[i] > m_value1 && data[i] < m_value2)
+						rows.setBit(i);
 				}
 			}
 
 			//greater then
 			else if (m_operator == 3) {
-				for (int i=0; i<data->size(); ++i) {
-					if (data->at(i) > m_value1) {
-						m_column->setMasked(i, true);
-						changed = true;
-					}
+				for (int i=0; i<size; ++i) {
+					if (data[i] > m_value1)
+						rows.setBit(i);
 				}
 			}
 
 			//greater then or equal to
 			else if (m_operator == 4) {
-				for (int i=0; i<data->size(); ++i) {
-					if (data->at(i) >= m_value1) {
-						m_column->setMasked(i, true);
-						changed = true;
-					}
+				for (int i=0; i<size; ++i) {
+					if (data[i] >= m_value1)
+						rows.setBit(i);
 				}
 			}
 
 			//lesser then
 			else if (m_operator == 5) {
-				for (int i=0; i<data->size(); ++i) {
-					if (data->at(i) < m_value1) {
-						m_column->setMasked(i, true);
-						changed = true;
-					}
+				for (int i=0; i<size; ++i) {
+					if (data[i] < m_value1)
+						rows.setBit(i);
 				}
 			}
 
 			//lesser then or equal to
 			else if (m_operator == 6) {
-				for (int i=0; i<data->size(); ++i) {
-					if (data->at(i) <= m_value1) {
-						m_column->setMasked(i, true);
-						changed = true;
-					}
+				for (int i=0; i<size; ++i) {
+					if (data[i] <= m_value1)
+						rows.setBit(i);
 				}
 			}
 
-			m_column->setSuppressDataChangedSignal(false);
-			if (changed)
-				m_column->setChanged();
+			m_done->release();
 		}
 
 	private:
-		Column* m_column;
+		const Column* m_column;
 		int m_operator;
 		double m_value1;
 		double m_value2;
+		QBitArray* m_rows;
+		QSemaphore* m_done;
 };
 
-class DropValuesTask : public QRunnable {
-	public:
-		DropValuesTask(Column* col, int op, double value1, double value2){
-			m_column = col;
-			m_operator = op;
-			m_value1 = value1;
-			m_value2 = value2;
-		};
-
-		void run() {
-			bool changed = false;
-			QVector<double>* data = static_cast<QVector<double>* >(m_column->data());
-			QVector<double> new_data(*data);
-
-			//equal to
-			if (m_operator == 0) {
-				for (int i=0; i<new_data.size(); ++i) {
-					if (new_data[i] == m_value1) {
-						new_data[i] = NAN;
-						changed = true;
-					}
-				}
-			}
-
-			//between (including end points)
-			else if (m_operator == 1) {
-				for (int i=0; i<new_data.size(); ++i) {
-					if (new_data[i] >= m_value1 && new_data[i] <= m_value2) {
-						new_data[i] = NAN;
-						changed = true;
-					}
-				}
-			}
-
-			//between (excluding end points)
-			else if (m_operator == 2) {
-				for (int i=0; i<new_data.size(); ++i) {
-					if (new_data[i] > m_value1 && new_data[i] < m_value2) {
-						new_data[i] = NAN;
-						changed = true;
-					}
-				}
-			}
-
-			//greater then
-			else if (m_operator == 3) {
-				for (int i=0; i<new_data.size(); ++i) {
-					if (new_data[i] > m_value1) {
-						new_data[i] = NAN;
-						changed = true;
-					}
-				}
-			}
-
-			//greater then or equal to
-			else if (m_operator == 4) {
-				for (int i=0; i<new_data.size(); ++i) {
-					if (new_data[i] >= m_value1) {
-						new_data[i] = NAN;
-						changed = true;
-					}
-				}
-			}
-
-			//lesser then
-			else if (m_operator == 5) {
-				for (int i=0; i<new_data.size(); ++i) {
-					if (new_data[i] < m_value1) {
-						new_data[i] = NAN;
-						changed = true;
-					}
-				}
-			}
+/*!
+	determines the matching rows of all selected columns in parallel.
+*/
+QVector<QBitArray> DropValuesDialog::matchingRows() const {
+	const int op = ui.cbOperator->currentIndex();
+	const double value1 = ui.leValue1->text().toDouble();
+	const double value2 = ui.leValue2->text().toDouble();
 
-			//lesser then or equal to
-			else if (m_operator == 6) {
-				for (int i=0; i<new_data.size(); ++i) {
-					if (new_data[i] <= m_value1) {
-						new_data[i] = NAN;
-						changed = true;
-					}
-				}
-			}
+	QVector<QBitArray> rows(m_columns.size());
+	QSemaphore done;
+	for (int i=0; i<m_columns.size(); ++i)
+		QThreadPool::globalInstance()->start(new MatchValuesTask(m_columns.at(i), op, value1, value2, &rows[i], &done));
 
-			if (changed)
-				m_column->replaceValues(0, new_data);
-		}
+	//wait until all columns were processed
+	done.acquire(m_columns.size());
 
-	private:
-		Column* m_column;
-		int m_operator;
-		double m_value1;
-		double m_value2;
-};
+	return rows;
+}
 
 void DropValuesDialog::maskValues() const {
 	Q_ASSERT(m_spreadsheet);
@@ -296,20 +216,17 @@ void DropValuesDialog::maskValues() const {
 	WAIT_CURSOR;
 	m_spreadsheet->beginMacro(i18n("%1: mask values", m_spreadsheet->name()));
 
-	const int op = ui.cbOperator->currentIndex();
-	const double value1 = ui.leValue1->text().toDouble();
-	const double value2 = ui.leValue2->text().toDouble();
+	const QVector<QBitArray> rows = matchingRows();
+	for (int i=0; i<m_columns.size(); ++i) {
+		if (rows.at(i).count(true) == 0)
+			continue;
 
-	foreach(Column* col, m_columns) {
-		MaskValuesTask* task = new MaskValuesTask(col, op, value1, value2);
-		task->run();
-		//TODO: writing to the undo-stack in Column::setMasked() is not tread-safe -> redesign
-// 		QThreadPool::globalInstance()->start(task);
+		//mask all matching rows with one undo command
+		Column* col = m_columns.at(i);
+		col->setMasked(rows.at(i));
+		col->invalidateProperties();
 	}
 
-	//wait until all columns were processed
-// 	QThreadPool::globalInstance()->waitForDone();
-
 	m_spreadsheet->endMacro();
 	RESET_CURSOR;
 }
@@ -320,17 +237,29 @@ void DropValuesDialog::dropValues() const {
 	WAIT_CURSOR;
 	m_spreadsheet->beginMacro(i18n("%1: drop values", m_spreadsheet->name()));
 
-	const int op = ui.cbOperator->currentIndex();
-	const double value1 = ui.leValue1->text().toDouble();
-	const double value2 = ui.leValue2->text().toDouble();
+	const QVector<QBitArray> rows = matchingRows();
+	for (int i=0; i<m_columns.size(); ++i) {
+		const QBitArray& matching = rows.at(i);
+		if (matching.count(true) == 0)
+			continue;
 
-	foreach(Column* col, m_columns) {
-		DropValuesTask* task = new DropValuesTask(col, op, value1, value2);
-		QThreadPool::globalInstance()->start(task);
-	}
+		Column* col = m_columns.at(i);
 
-	//wait until all columns were processed
-	QThreadPool::globalInstance()->waitForDone();
+		//Integer and BigInt columns have no empty value, NaN would be stored as 0 -> mask the rows instead
+		if (col->columnMode() == AbstractColumn::Integer || col->columnMode() == AbstractColumn::BigInt) {
+			col->setMasked(matching);
+			col->invalidateProperties();
+			continue;
+		}
+
+		QVector<double> new_data(col->numericView().values());
+		double* data = new_data.data();
+		for (int j=0; j<matching.size(); ++j) {
+			if (matching.testBit(j))
+				data[j] = NAN;
+		}
+		col->replaceValues(0, new_data);
+	}
 
 	m_spreadsheet->endMacro();
 	RESET_CURSOR;
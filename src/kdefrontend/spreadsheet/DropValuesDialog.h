@@ -30,6 +30,8 @@
 
 #include "ui_dropvalueswidget.h"
 #include <KDialog>
+#include <QBitArray>
+#include <QVector>
 
 
 class Column;
@@ -48,6 +50,7 @@ class DropValuesDialog : public KDialog {
 		Spreadsheet* m_spreadsheet;
 		bool m_mask;
 
+		QVector<QBitArray> matchingRows() const;
 		void dropValues() const;
 		void maskValues() const;
 
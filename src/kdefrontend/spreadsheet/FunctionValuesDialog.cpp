@@ -102,6 +102,7 @@ FunctionValuesDialog::~FunctionValuesDialog() {
 void FunctionValuesDialog::setColumns(QList<Column*> list) {
 	m_columns = list;
 	ui.teEquation->setPlainText(m_columns.first()->formula());
+	ui.chkVirtual->setChecked(m_columns.first()->isVirtual());
 
 	const QStringList& variableNames = m_columns.first()->formulaVariableNames();
 	if (!variableNames.size()) {
@@ -299,6 +300,9 @@ void FunctionValuesDialog::generate() {
 	QStringList columnPathes;
 	QVector<QVector<double>*> xVectors;
 	QVector<Column*> xColumns;
+	//the values of Numeric columns are shared, the values of Integer, BigInt and Float columns are widened to double.
+	//data() is not used since it would keep the values of mapped and virtual columns in memory
+	QVector< QVector<double> > values(m_variableNames.size());
 	int maxRowCount = m_spreadsheet->rowCount();
 	for (int i=0; i<m_variableNames.size(); ++i) {
 		variableNames << m_variableNames.at(i)->text().simplified();
@@ -309,7 +313,8 @@ void FunctionValuesDialog::generate() {
 		Q_ASSERT(column);
 		columnPathes << column->path();
 		xColumns << column;
-		xVectors << static_cast<QVector<double>* >(column->data());
+		values[i] = column->numericView().values();
+		xVectors << &values[i];
 
 		if (column->rowCount()>maxRowCount)
 			maxRowCount = column->rowCount();
@@ -319,22 +324,31 @@ void FunctionValuesDialog::generate() {
 	if (m_spreadsheet->rowCount()<maxRowCount)
 		m_spreadsheet->setRowCount(maxRowCount);
 
-	//create new vector for storing the calculated values
-	//the vectors with the variable data can be smaller then the result vector. So, not all values in the result vector might get initialized.
-	//->"clean" the result vector first
-	QVector<double> new_data(maxRowCount);
-	for (int i=0; i<new_data.size(); ++i)
-		new_data[i] = NAN;
-
-	//evaluate the expression for f(x_1, x_2, ...) and write the calculated values into a new vector.
-	ExpressionParser* parser = ExpressionParser::getInstance();
+	//Numeric columns can compute the values on access, the values are calculated and stored for the other columns
 	const QString& expression = ui.teEquation->toPlainText();
-	parser->evaluateCartesian(expression, variableNames, xVectors, &new_data);
-
-	//set the new values and store the expression, variable names and the used data columns
+	QList<Column*> columns;
 	foreach(Column* col, m_columns) {
-		col->setFormula(expression, variableNames, columnPathes);
-		col->replaceValues(0, new_data);
+		if (!ui.chkVirtual->isChecked() || !col->setVirtualFormula(expression, variableNames, columnPathes))
+			columns << col;
+	}
+
+	if (!columns.isEmpty()) {
+		//create new vector for storing the calculated values
+		//the vectors with the variable data can be smaller then the result vector. So, not all values in the result vector might get initialized.
+		//->"clean" the result vector first
+		QVector<double> new_data(maxRowCount);
+		for (int i=0; i<new_data.size(); ++i)
+			new_data[i] = NAN;
+
+		//evaluate the expression for f(x_1, x_2, ...) and write the calculated values into a new vector.
+		ExpressionParser* parser = ExpressionParser::getInstance();
+		parser->evaluateCartesian(expression, variableNames, xVectors, &new_data);
+
+		//set the new values and store the expression, variable names and the used data columns
+		foreach(Column* col, columns) {
+			col->setFormula(expression, variableNames, columnPathes);
+			col->replaceValues(0, new_data);
+		}
 	}
 
 	m_spreadsheet->endMacro();
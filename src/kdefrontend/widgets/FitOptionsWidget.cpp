@@ -47,12 +47,15 @@ FitOptionsWidget::FitOptionsWidget(QWidget *parent, XYFitCurve::FitData* fitData
 	ui.leEps->setValidator( new QDoubleValidator(ui.leEps) );
 	ui.leMaxIterations->setValidator( new QIntValidator(ui.leMaxIterations) );
 	ui.leEvaluatedPoints->setValidator( new QIntValidator(ui.leEvaluatedPoints) );
+	ui.leBootstrapSamples->setValidator( new QIntValidator(0, 1000000, ui.leBootstrapSamples) );
 
 	ui.leEps->setText(QString::number(m_fitData->eps));
 	ui.leMaxIterations->setText(QString::number(m_fitData->maxIterations));
 	ui.leEvaluatedPoints->setText(QString::number(m_fitData->evaluatedPoints));
 	ui.cbEvaluateFullRange->setChecked(m_fitData->evaluateFullRange);
 	ui.cbUseResults->setChecked(m_fitData->useResults);
+	ui.cbWarmStart->setChecked(m_fitData->warmStart);
+	ui.leBootstrapSamples->setText(QString::number(m_fitData->bootstrapSamples));
 
 	//SLOTS
 	connect( ui.leEps, SIGNAL(textChanged(QString)), this, SLOT(changed()) ) ;
@@ -60,6 +63,8 @@ FitOptionsWidget::FitOptionsWidget(QWidget *parent, XYFitCurve::FitData* fitData
 	connect( ui.leEvaluatedPoints, SIGNAL(textChanged(QString)), this, SLOT(changed()) ) ;
 	connect( ui.cbEvaluateFullRange, SIGNAL(clicked(bool)), this, SLOT(changed()) ) ;
 	connect( ui.cbUseResults, SIGNAL(clicked(bool)), this, SLOT(changed()) ) ;
+	connect( ui.cbWarmStart, SIGNAL(clicked(bool)), this, SLOT(changed()) ) ;
+	connect( ui.leBootstrapSamples, SIGNAL(textChanged(QString)), this, SLOT(changed()) ) ;
 	connect( ui.pbApply, SIGNAL(clicked()), this, SLOT(applyClicked()) );
 	connect( ui.pbCancel, SIGNAL(clicked()), this, SIGNAL(finished()) );
 }
@@ -70,6 +75,8 @@ void FitOptionsWidget::applyClicked() {
 	m_fitData->evaluatedPoints = ui.leEvaluatedPoints->text().toInt();
 	m_fitData->evaluateFullRange = ui.cbEvaluateFullRange->isChecked();
 	m_fitData->useResults = ui.cbUseResults->isChecked();
+	m_fitData->warmStart = ui.cbWarmStart->isChecked();
+	m_fitData->bootstrapSamples = ui.leBootstrapSamples->text().toInt();
 
 	if (m_changed)
 		emit(optionsChanged());
@@ -0,0 +1,455 @@
+/***************************************************************************
+    File                 : ColumnTest.cpp
+    Project              : LabPlot
+    Description          : Tests for the data handling of columns
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ColumnTest.h"
+#include "backend/core/Project.h"
+#include "backend/core/UndoStack.h"
+#include "backend/core/column/Column.h"
+#include "backend/lib/IntervalAttribute.h"
+#include "backend/lib/SpillableUndoCommand.h"
+#include "backend/lib/SpillFile.h"
+#include "backend/spreadsheet/Spreadsheet.h"
+
+#include <QTemporaryFile>
+#include <QtConcurrentRun>
+#include <qtest_kde.h>
+#include <limits>
+
+namespace {
+QVector<double> range(int count) {
+	QVector<double> values(count);
+	for (int i = 0; i < count; ++i)
+		values[i] = i + 1;
+	return values;
+}
+
+//! read all values of \c column, also called in a thread of the global thread pool
+QVector<double> readValues(const Column* column) {
+	QVector<double> values;
+	for (int row = 0; row < column->rowCount(); ++row)
+		values << column->valueAt(row);
+	return values;
+}
+
+QVector<double> readNumericView(const Column* column) {
+	return column->numericView().values();
+}
+
+//! process the events until \c column has \c rows rows, the formula columns are recomputed asynchronously
+bool waitForRowCount(const Column* column, int rows) {
+	for (int i = 0; i < 100 && column->rowCount() != rows; ++i)
+		QTest::qWait(50);
+	return (column->rowCount() == rows);
+}
+
+//! the number of bytes backed up by the last command on \c stack
+qint64 lastPayloadSize(const QUndoStack* stack) {
+	const SpillableUndoCommand* cmd = dynamic_cast<const SpillableUndoCommand*>(stack->command(stack->count() - 1));
+	return cmd ? cmd->payloadSize() : -1;
+}
+
+//! rows of the undo backups of the copy commands
+const int chunkSize = 4096;
+}
+
+void ColumnTest::extremaAfterSetValue() {
+	Column column("x", range(5));
+	QCOMPARE(column.minimum(), 1.);
+	QCOMPARE(column.maximum(), 5.);
+
+	column.setValueAt(2, 10.);
+	QCOMPARE(column.maximum(), 10.);
+
+	column.replaceValues(0, QVector<double>() << -1.);
+	QCOMPARE(column.minimum(), -1.);
+}
+
+//! the data modified via the data pointer is announced with setChanged()
+void ColumnTest::extremaAfterSetChanged() {
+	Column column("x", range(5));
+	QCOMPARE(column.maximum(), 5.);
+
+	QVector<double>* data = static_cast<QVector<double>* >(column.data());
+	(*data)[0] = 20.;
+	column.setChanged();
+	QCOMPARE(column.maximum(), 20.);
+}
+
+//! new rows of Integer columns contain 0, they have no empty value
+void ColumnTest::extremaOfNewIntegerRows() {
+	Column column("x", AbstractColumn::Integer);
+	column.replaceValues(0, QVector<double>() << -5. << -3.);
+	QCOMPARE(column.maximum(), -3.);
+
+	column.insertRows(2, 1);
+	QCOMPARE(column.rowCount(), 3);
+	QCOMPARE(column.maximum(), 0.);
+}
+
+void ColumnTest::virtualColumnInWorkerThread() {
+	Project project;
+	Spreadsheet* spreadsheet = new Spreadsheet(0, "spreadsheet");
+	project.addChild(spreadsheet);
+	Column* x = new Column("x", range(10000));
+	spreadsheet->addChild(x);
+	Column* y = new Column("y", AbstractColumn::Numeric);
+	spreadsheet->addChild(y);
+
+	QVERIFY(y->setVirtualFormula("2*x", QStringList() << "x", QStringList() << x->path()));
+	QVERIFY(y->isVirtual());
+
+	QVector<double> expected = range(10000);
+	for (int i = 0; i < expected.size(); ++i)
+		expected[i] *= 2;
+
+	//the values are computed block-wise on access and in parallel for the numeric view
+	QCOMPARE(QtConcurrent::run(readValues, y).result(), expected);
+	QCOMPARE(QtConcurrent::run(readNumericView, y).result(), expected);
+	QCOMPARE(readNumericView(y), expected);
+
+	//undoing the formula keeps the values in memory again
+	project.undoStack()->undo();
+	QVERIFY(!y->isVirtual());
+}
+
+void ColumnTest::cyclicVirtualFormula() {
+	Project project;
+	Spreadsheet* spreadsheet = new Spreadsheet(0, "spreadsheet");
+	project.addChild(spreadsheet);
+	Column* x = new Column("x", range(10));
+	spreadsheet->addChild(x);
+	Column* y = new Column("y", AbstractColumn::Numeric);
+	spreadsheet->addChild(y);
+	Column* z = new Column("z", AbstractColumn::Numeric);
+	spreadsheet->addChild(z);
+
+	QVERIFY(y->setVirtualFormula("2*x", QStringList() << "x", QStringList() << x->path()));
+	QVERIFY(z->setVirtualFormula("y+1", QStringList() << "y", QStringList() << y->path()));
+	QVERIFY(!x->setVirtualFormula("z", QStringList() << "z", QStringList() << z->path()));
+	QVERIFY(!x->isVirtual());
+	QCOMPARE(z->valueAt(0), 3.);
+}
+
+void ColumnTest::modifyVirtualColumn() {
+	Project project;
+	Spreadsheet* spreadsheet = new Spreadsheet(0, "spreadsheet");
+	project.addChild(spreadsheet);
+	Column* x = new Column("x", range(10));
+	spreadsheet->addChild(x);
+	Column* y = new Column("y", AbstractColumn::Numeric);
+	spreadsheet->addChild(y);
+	QVERIFY(y->setVirtualFormula("2*x", QStringList() << "x", QStringList() << x->path()));
+
+	//reading the values doesn't copy them into memory
+	const int steps = project.undoStack()->count();
+	y->numericView();
+	QVERIFY(y->isVirtual());
+	QCOMPARE(project.undoStack()->count(), steps);
+
+	//the values are copied into memory and modified in one undo step
+	y->setValueAt(0, -1.);
+	QVERIFY(!y->isVirtual());
+	QCOMPARE(project.undoStack()->count(), steps + 1);
+	QCOMPARE(y->valueAt(0), -1.);
+	QCOMPARE(y->valueAt(9), 20.);
+
+	//the values are computed again after undo, the values cached before are dropped
+	project.undoStack()->undo();
+	QVERIFY(y->isVirtual());
+	x->setValueAt(9, 100.);
+	QCOMPARE(y->valueAt(0), 2.);
+	QCOMPARE(y->valueAt(9), 200.);
+}
+
+void ColumnTest::statisticsOfMappedColumn() {
+	//an even number of values with duplicates and negative values
+	QVector<double> values(1000);
+	for (int i = 0; i < values.size(); ++i)
+		values[i] = (i*37)%101 - 50.5;
+
+	QTemporaryFile file;
+	QVERIFY(file.open());
+	file.write(reinterpret_cast<const char*>(values.constData()), values.size()*sizeof(double));
+	file.flush();
+
+	Column mapped("mapped", AbstractColumn::Numeric);
+	QVERIFY(mapped.mapData(file.fileName(), 0, values.size()));
+	Column column("column", values);
+
+	//the values of the mapped column are not copied, the median is selected in several passes over the file
+	const Column::ColumnStatistics& mappedStatistics = mapped.statistics();
+	const Column::ColumnStatistics& statistics = column.statistics();
+	QCOMPARE(mappedStatistics.median, statistics.median);
+	QCOMPARE(mappedStatistics.medianDeviation, statistics.medianDeviation);
+	QCOMPARE(mappedStatistics.meanDeviationAroundMedian, statistics.meanDeviationAroundMedian);
+	QCOMPARE(mappedStatistics.entropy, statistics.entropy);
+	QVERIFY(mapped.isMapped());
+}
+
+//! intervals touching or intersecting each other are merged, unsetting splits them
+void ColumnTest::maskedIntervalsMerge() {
+	IntervalAttribute<bool> masking;
+	masking.setValue(Interval<int>(0, 3));
+	masking.setValue(Interval<int>(4, 6));
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(0, 6));
+
+	masking.setValue(Interval<int>(9, 10));
+	masking.setValue(Interval<int>(20, 21));
+	QCOMPARE(masking.intervals().size(), 3);
+	masking.setValue(Interval<int>(7, 8));
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(0, 10) << Interval<int>(20, 21));
+	masking.setValue(Interval<int>(5, 19));
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(0, 21));
+
+	masking.setValue(Interval<int>(2, 3), false);
+	masking.setValue(21, false);
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(0, 1) << Interval<int>(4, 20));
+	QVERIFY(masking.isSet(1));
+	QVERIFY(!masking.isSet(2));
+	QVERIFY(masking.isSet(Interval<int>(4, 20)));
+	QVERIFY(!masking.isSet(Interval<int>(1, 4)));
+
+	//insertion splits the interval, the removal of the inserted rows merges it again
+	masking.insertRows(10, 5);
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(0, 1) << Interval<int>(4, 9) << Interval<int>(15, 25));
+	masking.removeRows(10, 5);
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(0, 1) << Interval<int>(4, 20));
+	masking.removeRows(1, 4);
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(0, 16));
+}
+
+//! the intervals up to the last row INT_MAX don't overflow
+void ColumnTest::maskedIntervalsAtLastRow() {
+	const int lastRow = std::numeric_limits<int>::max();
+	IntervalAttribute<bool> masking;
+	masking.setValue(Interval<int>(10, lastRow));
+	masking.setValue(lastRow, true);
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(10, lastRow));
+	masking.setValue(Interval<int>(0, 9));
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(0, lastRow));
+	QVERIFY(masking.isSet(lastRow));
+
+	masking.setValue(Interval<int>(100, lastRow), false);
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(0, 99));
+	masking.setValue(lastRow, true);
+	masking.setValue(Interval<int>(50, lastRow - 1), false);
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(0, 49) << Interval<int>(lastRow, lastRow));
+
+	//the rows moved beyond the last row are dropped
+	masking.insertRows(20, 10);
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(0, 19) << Interval<int>(30, 59));
+	masking.setValue(Interval<int>(lastRow - 5, lastRow));
+	masking.insertRows(0, 3);
+	QCOMPARE(masking.intervals(), QList< Interval<int> >() << Interval<int>(3, 22) << Interval<int>(33, 62) << Interval<int>(lastRow - 2, lastRow));
+}
+
+//! the masked intervals of a column are merged when removing the rows between them and restored on undo
+void ColumnTest::maskingAfterRemoveRows() {
+	Project project;
+	Spreadsheet* spreadsheet = new Spreadsheet(0, "spreadsheet");
+	project.addChild(spreadsheet);
+	Column* x = new Column("x", range(10));
+	spreadsheet->addChild(x);
+
+	x->setMasked(Interval<int>(2, 3));
+	x->setMasked(Interval<int>(6, 7));
+	const QList< Interval<int> > masked = x->maskedIntervals();
+	QCOMPARE(masked.size(), 2);
+
+	x->removeRows(4, 2);
+	QCOMPARE(x->maskedIntervals(), QList< Interval<int> >() << Interval<int>(2, 5));
+	QCOMPARE(x->rowCount(), 8);
+
+	project.undoStack()->undo();
+	QCOMPARE(x->maskedIntervals(), masked);
+	QCOMPARE(readValues(x), range(10));
+
+	project.undoStack()->redo();
+	QCOMPARE(x->maskedIntervals(), QList< Interval<int> >() << Interval<int>(2, 5));
+}
+
+//! only the chunks with changed rows are backed up, undo and redo restore all rows
+void ColumnTest::copyBacksUpChangedChunks() {
+	Project project;
+	Spreadsheet* spreadsheet = new Spreadsheet(0, "spreadsheet");
+	project.addChild(spreadsheet);
+	Column* x = new Column("x", range(10000));
+	spreadsheet->addChild(x);
+	UndoStack* stack = project.undoStack();
+
+	//nothing changes
+	Column same("same", range(10000));
+	x->copy(&same);
+	QCOMPARE(lastPayloadSize(stack), (qint64)0);
+	QCOMPARE(readValues(x), range(10000));
+
+	//one row in the second chunk changes: the old and the new values of this chunk are backed up
+	QVector<double> values = range(10000);
+	values[5000] = -1.;
+	Column changed("changed", values);
+	x->copy(&changed);
+	QCOMPARE(lastPayloadSize(stack), (qint64)(2*chunkSize*sizeof(double)));
+	QCOMPARE(readValues(x), values);
+
+	stack->undo();
+	QCOMPARE(readValues(x), range(10000));
+	stack->redo();
+	QCOMPARE(readValues(x), values);
+	stack->undo();
+	stack->undo();
+	QCOMPARE(readValues(x), range(10000));
+}
+
+//! copying a shorter or longer column changes the row count, undo restores it
+void ColumnTest::copyShrinksAndGrowsColumn() {
+	Project project;
+	Spreadsheet* spreadsheet = new Spreadsheet(0, "spreadsheet");
+	project.addChild(spreadsheet);
+	Column* x = new Column("x", range(10000));
+	spreadsheet->addChild(x);
+	UndoStack* stack = project.undoStack();
+
+	//the first chunk is unchanged, the removed rows and the rest of the second chunk are backed up
+	Column shorter("shorter", range(5000));
+	x->copy(&shorter);
+	QCOMPARE(readValues(x), range(5000));
+	QCOMPARE(lastPayloadSize(stack), (qint64)((10000 - chunkSize + 5000 - chunkSize)*sizeof(double)));
+
+	Column longer("longer", range(12000));
+	x->copy(&longer);
+	QCOMPARE(readValues(x), range(12000));
+
+	stack->undo();
+	QCOMPARE(readValues(x), range(5000));
+	stack->undo();
+	QCOMPARE(readValues(x), range(10000));
+
+	stack->redo();
+	QCOMPARE(readValues(x), range(5000));
+	stack->redo();
+	QCOMPARE(readValues(x), range(12000));
+}
+
+//! a partial copy beyond the end of the column appends rows, undo removes them again
+void ColumnTest::partialCopyBeyondEnd() {
+	Project project;
+	Spreadsheet* spreadsheet = new Spreadsheet(0, "spreadsheet");
+	project.addChild(spreadsheet);
+	Column* x = new Column("x", range(10000));
+	spreadsheet->addChild(x);
+	UndoStack* stack = project.undoStack();
+
+	Column source("source", QVector<double>(2000, -1.));
+	x->copy(&source, 0, 9000, 2000);
+	QCOMPARE(x->rowCount(), 11000);
+	QCOMPARE(x->valueAt(8999), 9000.);
+	QCOMPARE(x->valueAt(9000), -1.);
+	QCOMPARE(x->valueAt(10999), -1.);
+	//the copied rows and the overwritten rows of the column
+	QCOMPARE(lastPayloadSize(stack), (qint64)((2000 + 1000)*sizeof(double)));
+
+	stack->undo();
+	QCOMPARE(readValues(x), range(10000));
+	stack->redo();
+	QCOMPARE(x->rowCount(), 11000);
+	QCOMPARE(x->valueAt(9999), -1.);
+
+	//copying the same values again changes nothing
+	x->copy(&source, 0, 9000, 2000);
+	QCOMPARE(lastPayloadSize(stack), (qint64)0);
+}
+
+void ColumnTest::spillFileReusesSpace() {
+	SpillFile file;
+	QVERIFY(file.open());
+
+	const qint64 first = file.write(QByteArray(100, 'a'));
+	const qint64 second = file.write(QByteArray(100, 'b'));
+	QCOMPARE(first, (qint64)0);
+	QCOMPARE(second, (qint64)100);
+
+	//the space of the first block is used for the next smaller block
+	file.release(first, 100);
+	const qint64 third = file.write(QByteArray(50, 'c'));
+	QCOMPARE(third, first);
+	QCOMPARE(file.size(), (qint64)200);
+	QCOMPARE(file.read(second, 100), QByteArray(100, 'b'));
+
+	//the free space at the end of the file is cut off
+	file.release(second, 100);
+	QCOMPARE(file.size(), (qint64)50);
+	file.release(third, 50);
+	QCOMPARE(file.size(), (qint64)0);
+}
+
+void ColumnTest::spilledUndoHistory() {
+	Project project;
+	Spreadsheet* spreadsheet = new Spreadsheet(0, "spreadsheet");
+	project.addChild(spreadsheet);
+	Column* x = new Column("x", range(1000));
+	spreadsheet->addChild(x);
+
+	UndoStack* stack = project.undoStack();
+	stack->setMemoryBudget(1);
+	for (int i = 0; i < 5; ++i)
+		x->replaceValues(0, QVector<double>(1000, i));
+	QVERIFY(stack->spilledSize() > 0);
+	QCOMPARE(x->valueAt(999), 4.);
+
+	for (int i = 0; i < 5; ++i)
+		stack->undo();
+	QCOMPARE(readValues(x), range(1000));
+
+	for (int i = 0; i < 5; ++i)
+		stack->redo();
+	QCOMPARE(x->valueAt(0), 4.);
+}
+
+void ColumnTest::formulaColumnFollowsSource() {
+	Project project;
+	Spreadsheet* spreadsheet = new Spreadsheet(0, "spreadsheet");
+	project.addChild(spreadsheet);
+	Column* x = new Column("x", range(10));
+	spreadsheet->addChild(x);
+	Column* y = new Column("y", AbstractColumn::Numeric);
+	spreadsheet->addChild(y);
+	y->setFormula("x*x", QStringList() << "x", QStringList() << x->path());
+
+	//the dependency graph is rebuilt in the event loop
+	QTest::qWait(0);
+	x->replaceValues(0, range(20));
+	QVERIFY(waitForRowCount(y, 20));
+	QCOMPARE(y->valueAt(19), 400.);
+
+	//the formula column is shrunk together with its source
+	x->removeRows(10, 10);
+	QVERIFY(waitForRowCount(y, 10));
+	QCOMPARE(y->valueAt(9), 100.);
+}
+
+QTEST_KDEMAIN(ColumnTest, NoGUI)
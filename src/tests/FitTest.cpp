@@ -0,0 +1,104 @@
+/***************************************************************************
+    File                 : FitTest.cpp
+    Project              : LabPlot
+    Description          : Tests for the fitting of curves
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "FitTest.h"
+#include "backend/core/Project.h"
+#include "backend/core/column/Column.h"
+#include "backend/spreadsheet/Spreadsheet.h"
+#include "backend/worksheet/plots/cartesian/XYFitCurve.h"
+
+#include <qtest_kde.h>
+#include <cfloat>
+
+namespace {
+//! custom model a*x+b
+XYFitCurve::FitData linearModel() {
+	XYFitCurve::FitData fitData;
+	fitData.modelCategory = nsl_fit_model_custom;
+	fitData.model = "a*x+b";
+	fitData.paramNames << "a" << "b";
+	fitData.paramNamesUtf8 = fitData.paramNames;
+	fitData.paramStartValues << 1. << 1.;
+	fitData.paramLowerLimits << -DBL_MAX << -DBL_MAX;
+	fitData.paramUpperLimits << DBL_MAX << DBL_MAX;
+	fitData.paramFixed << false << false;
+	return fitData;
+}
+}
+
+void FitTest::batchFit() {
+	Project project;
+	Spreadsheet* data = new Spreadsheet(0, "data");
+	project.addChild(data);
+	QVector<double> xValues(20);
+	for (int i = 0; i < xValues.size(); ++i)
+		xValues[i] = i;
+	Column* x = new Column("x", xValues);
+	data->addChild(x);
+
+	//y_k = k*x + 1 for k = 1,2,3
+	QVector<XYFitCurve::BatchFitColumns> columns;
+	for (int k = 1; k <= 3; ++k) {
+		QVector<double> yValues(xValues.size());
+		for (int i = 0; i < yValues.size(); ++i)
+			yValues[i] = k*xValues.at(i) + 1;
+		Column* y = new Column(QString("y%1").arg(k), yValues);
+		data->addChild(y);
+
+		XYFitCurve::BatchFitColumns fitColumns;
+		fitColumns.xDataColumn = x;
+		fitColumns.yDataColumn = y;
+		columns << fitColumns;
+	}
+
+	Spreadsheet* results = new Spreadsheet(0, "results");
+	project.addChild(results);
+	const int steps = project.undoStack()->count();
+
+	const QVector<XYFitCurve::FitResult> fitResults = XYFitCurve::batchFit(linearModel(), columns, results);
+	QCOMPARE(fitResults.size(), 3);
+	for (int k = 1; k <= 3; ++k) {
+		QVERIFY(fitResults.at(k-1).valid);
+		QVERIFY(qAbs(fitResults.at(k-1).paramValues.at(0) - k) < 1e-6);
+		QVERIFY(qAbs(fitResults.at(k-1).paramValues.at(1) - 1) < 1e-6);
+	}
+
+	//x-data, y-data, the parameters with their errors, chi^2 and status, one row per fit
+	QCOMPARE(results->columnCount(), 8);
+	QCOMPARE(results->rowCount(), 3);
+	QCOMPARE(results->column(1)->textAt(2), QString("y3"));
+	QCOMPARE(results->column(2)->name(), QString("a"));
+	QVERIFY(qAbs(results->column(2)->valueAt(1) - 2) < 1e-6);
+
+	//the results are written in one undo step
+	QCOMPARE(project.undoStack()->count(), steps + 1);
+	project.undoStack()->undo();
+	QVERIFY(results->column(0)->name() != "x-data");
+}
+
+QTEST_KDEMAIN(FitTest, NoGUI)
@@ -0,0 +1,256 @@
+/***************************************************************************
+    File                 : ParserTest.cpp
+    Project              : LabPlot
+    Description          : Tests for the parser of mathematical expressions
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ParserTest.h"
+
+#include <qtest_kde.h>
+#include <cmath>
+extern "C" {
+#include <gsl/gsl_math.h>
+#include <gsl/gsl_sf_erf.h>
+#include "backend/gsl/parser.h"
+}
+
+namespace {
+//! block size of program_eval_batch() (PARSER_BATCH_SIZE in parser.y)
+const int batchSize = 256;
+
+//! expression and the value the evaluating parser returned for it
+struct Expression {
+	const char* string;
+	double (*reference)(double x, double a);
+};
+
+double polynomial(double x, double a) { return a*x*x + 3.*x - 1.; }
+double trigonometric(double x, double a) { return sin(x)/a - cos(a*x); }
+double rootAndAbs(double x, double a) { return sqrt(x)*fabs(a - x); }
+double power(double x, double a) { return pow(x, a) + x*x; }
+double negation(double x, double a) { Q_UNUSED(a); return -(x*x); }
+double folded(double x, double a) { Q_UNUSED(a); return 512. + x; }
+double twoArguments(double x, double a) { return hypot(x, a) + exp(-x); }
+double constants(double x, double a) { Q_UNUSED(a); return M_PI*x + M_E; }
+double nested(double x, double a) { return gsl_sf_erf(log(1. + a*x))/(1. + x*x); }
+
+const Expression expressions[] = {
+	{"a*x^2 + 3*x - 1", polynomial},
+	{"sin(x)/a - cos(a*x)", trigonometric},
+	{"sqrt(x)*fabs(a - x)", rootAndAbs},
+	{"pow(x, a) + x**2", power},
+	{"-x^2", negation},
+	{"2^3^2 + x", folded},
+	{"hypot(x, a) + exp(-x)", twoArguments},
+	{"pi*x + e", constants},
+	{"erf(log(1 + a*x))/(1 + x*x)", nested}
+};
+const int expressionCount = sizeof(expressions)/sizeof(expressions[0]);
+
+bool fuzzyEqual(double value, double reference, double tolerance) {
+	return fabs(value - reference) <= tolerance*GSL_MAX(fabs(reference), 1.);
+}
+
+/*!
+ * compares the derivatives of the compiled expression with respect to x and a with central differences
+ * at all points x of \c xs
+ */
+void verifyDerivatives(parser_context* ctx, const char* string, const QVector<double>& xs, double a) {
+	symrec* wrt[2];
+	wrt[0] = parser_context_assign_variable(ctx, "x", 0.);
+	wrt[1] = parser_context_assign_variable(ctx, "a", a);
+	parser_program* prog = parser_context_compile(ctx, string);
+	QVERIFY2(prog, string);
+
+	foreach (double x, xs) {
+		double grad[2];
+		wrt[0]->value.var = x;
+		wrt[1]->value.var = a;
+		const double value = program_eval_deriv(prog, wrt, 2, grad);
+		QVERIFY2(fuzzyEqual(value, program_eval(prog), 1.e-14), string);
+
+		for (int j = 0; j < 2; ++j) {
+			const double v = wrt[j]->value.var;
+			const double h = 1.e-6*GSL_MAX(fabs(v), 1.);
+			wrt[j]->value.var = v + h;
+			const double fp = program_eval(prog);
+			wrt[j]->value.var = v - h;
+			const double fm = program_eval(prog);
+			wrt[j]->value.var = v;
+
+			const double difference = (fp - fm)/(2.*h);
+			QVERIFY2(fuzzyEqual(grad[j], difference, 1.e-6),
+				qPrintable(QString("%1 at x = %2: d/d%3 = %4, central difference %5")
+					.arg(string).arg(x).arg(j == 0 ? 'x' : 'a').arg(grad[j], 0, 'g', 15).arg(difference, 0, 'g', 15)));
+		}
+	}
+
+	program_free(prog);
+}
+}
+
+//! the compiled programs return the values of the evaluating parser
+void ParserTest::evalMatchesParse() {
+	parser_context* ctx = parser_context_new();
+	symrec* x = parser_context_assign_variable(ctx, "x", 0.);
+	symrec* a = parser_context_assign_variable(ctx, "a", 0.);
+
+	const double as[] = {0.5, 2.};
+	const double xs[] = {0.25, 1., 3.5};
+	for (int i = 0; i < expressionCount; ++i) {
+		parser_program* prog = parser_context_compile(ctx, expressions[i].string);
+		QVERIFY2(prog, expressions[i].string);
+
+		for (int k = 0; k < 2; ++k) {
+			for (int l = 0; l < 3; ++l) {
+				x->value.var = xs[l];
+				a->value.var = as[k];
+				const double reference = expressions[i].reference(xs[l], as[k]);
+				QVERIFY2(fuzzyEqual(program_eval(prog), reference, 1.e-14), expressions[i].string);
+				QVERIFY2(fuzzyEqual(parser_context_parse(ctx, expressions[i].string), reference, 1.e-14), expressions[i].string);
+
+				//the global context
+				const parser_var vars[] = {{"x", xs[l]}, {"a", as[k]}};
+				QVERIFY2(fuzzyEqual(parse_with_vars(expressions[i].string, vars, 2), reference, 1.e-14), expressions[i].string);
+			}
+		}
+		program_free(prog);
+	}
+
+	//parse errors
+	QVERIFY(!parser_context_compile(ctx, "x +* a"));
+	QVERIFY(parser_context_errors(ctx) > 0);
+	QVERIFY(gsl_isnan(parser_context_parse(ctx, "unknown(x)")));
+
+	parser_context_free(ctx);
+}
+
+//! the batch evaluation returns the values of the evaluation point by point, also for partial blocks
+void ParserTest::evalBatchMatchesEval() {
+	parser_context* ctx = parser_context_new();
+	symrec* x = parser_context_assign_variable(ctx, "x", 0.);
+	symrec* a = parser_context_assign_variable(ctx, "a", 1.5);
+
+	const int n = 2*batchSize + 17;
+	QVector<double> xs(n);
+	for (int k = 0; k < n; ++k)
+		xs[k] = 0.01*(k + 1);
+	const double* values[] = {xs.constData()};
+
+	QVector<double> result(n);
+	for (int i = 0; i < expressionCount; ++i) {
+		parser_program* prog = parser_context_compile(ctx, expressions[i].string);
+		QVERIFY2(prog, expressions[i].string);
+
+		//only x is passed, a keeps its current value
+		program_eval_batch(prog, &x, values, 1, n, result.data());
+		for (int k = 0; k < n; ++k) {
+			x->value.var = xs[k];
+			QVERIFY2(fuzzyEqual(result[k], program_eval(prog), 1.e-15), expressions[i].string);
+			QVERIFY2(fuzzyEqual(result[k], expressions[i].reference(xs[k], a->value.var), 1.e-14), expressions[i].string);
+		}
+		program_free(prog);
+	}
+
+	//empty expression
+	parser_program* prog = parser_context_compile(ctx, "");
+	QVERIFY(prog);
+	program_eval_batch(prog, &x, values, 1, n, result.data());
+	QVERIFY(gsl_isnan(result[0]) && gsl_isnan(result[n-1]));
+	program_free(prog);
+
+	parser_context_free(ctx);
+}
+
+//! assignments are evaluated point by point, the assigned variable has the value of the last point
+void ParserTest::evalBatchWithAssignment() {
+	parser_context* ctx = parser_context_new();
+	symrec* vars[2];
+	vars[0] = parser_context_assign_variable(ctx, "x", 0.);
+	vars[1] = parser_context_assign_variable(ctx, "a", 0.);
+	symrec* y = parser_context_assign_variable(ctx, "y", 0.);
+
+	const int n = batchSize + 3;
+	QVector<double> xs(n), as(n);
+	for (int k = 0; k < n; ++k) {
+		xs[k] = k;
+		as[k] = 0.5*k;
+	}
+	const double* values[] = {xs.constData(), as.constData()};
+
+	parser_program* prog = parser_context_compile(ctx, "y = a*x + 1");
+	QVERIFY(prog);
+	QVector<double> result(n);
+	program_eval_batch(prog, vars, values, 2, n, result.data());
+	for (int k = 0; k < n; ++k)
+		QCOMPARE(result[k], as[k]*xs[k] + 1.);
+	QCOMPARE(y->value.var, result[n-1]);
+	program_free(prog);
+
+	parser_context_free(ctx);
+}
+
+//! the derivatives of the operators with an own instruction are exact
+void ParserTest::derivativeOfOperators() {
+	parser_context* ctx = parser_context_new();
+	const QVector<double> xs = QVector<double>() << 0.3 << 1.7 << 4.;
+
+	verifyDerivatives(ctx, "a*x*x - x*a", xs, 1.3);
+	verifyDerivatives(ctx, "(x + a)/(x*a + 2)", xs, 0.7);
+	verifyDerivatives(ctx, "x^a", xs, 2.5);
+	verifyDerivatives(ctx, "a^x", xs, 1.5);
+	verifyDerivatives(ctx, "x^x + pow(a, 3)", xs, 0.9);
+	verifyDerivatives(ctx, "sqrt(a*x + 1)", xs, 2.);
+	verifyDerivatives(ctx, "-sqrt(x)/a", xs, 3.);
+	//both signs of the argument of fabs()
+	verifyDerivatives(ctx, "fabs(x - a)*x", xs, 1.);
+	verifyDerivatives(ctx, "fabs(a - x*x)", xs, 2.);
+
+	parser_context_free(ctx);
+}
+
+//! the functions with known derivative and the functions differentiated numerically
+void ParserTest::derivativeOfFunctions() {
+	parser_context* ctx = parser_context_new();
+	const QVector<double> xs = QVector<double>() << 0.1 << 0.45 << 0.8;
+
+	//the arguments are in the domain of the functions for all x
+	const char* functions[] = {
+		"sin(a*x)", "cos(a*x)", "tan(a*x)", "exp(a*x)", "expm1(a*x)",
+		"log(a*x)", "log10(a*x)", "log1p(a*x)",
+		"sinh(a*x)", "cosh(a*x)", "tanh(a*x)",
+		"asin(a*x)", "acos(a*x)", "atan(a*x)",
+		"asinh(a*x)", "acosh(1 + a*x)", "atanh(a*x)",
+		"erf(a*x)", "erfc(a*x)", "pow2(a*x)", "pow3(a*x)",
+		//without known derivative
+		"gamma(1 + a*x)", "hypot(x, a)", "atan2(x, a*x + 1)"
+	};
+	for (unsigned int i = 0; i < sizeof(functions)/sizeof(functions[0]); ++i)
+		verifyDerivatives(ctx, functions[i], xs, 0.9);
+
+	parser_context_free(ctx);
+}
+
+QTEST_KDEMAIN(ParserTest, NoGUI)